@@ -0,0 +1,196 @@
+#include "audiovisualizer.h"
+#include <QPainter>
+#include <QLinearGradient>
+#include <QMutexLocker>
+#include <QAudioBuffer>
+#include <QAudioFormat>
+
+#include "uiupdatescheduler.h"
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+#include <QAudioBufferOutput>
+#define AUDIOVISUALIZER_BUFFER_OUTPUT
+#endif
+
+namespace {
+// Liczba pasm widma
+constexpr int kBandCount = 64;
+// Pojemność przebiegu w kolumnach (szerokość ekranu 4K)
+constexpr int kWaveColumns = 4096;
+// Część wysokości widżetu zajmowana przez widmo
+constexpr double kSpectrumHeight = 0.6;
+}
+
+AudioVisualizer::AudioVisualizer(QWidget *parent)
+    : QWidget(parent),
+      analyzer(kBandCount)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    bands.fill(0.0f, kBandCount);
+    waveMin.fill(0.0f, kWaveColumns);
+    waveMax.fill(0.0f, kWaveColumns);
+
+    analysisContext = new QObject();
+    analysisContext->moveToThread(&analysisThread);
+    connect(&analysisThread, &QThread::finished, analysisContext, &QObject::deleteLater);
+    analysisThread.setObjectName("AudioAnalysis");
+    analysisThread.start();
+
+    // Przerysowanie najwyżej raz na klatkę ekranu i tylko, gdy widżet jest widoczny
+    frameUpdate = UiUpdateScheduler::instance().add(this, [this]() { update(); });
+}
+
+AudioVisualizer::~AudioVisualizer()
+{
+    attach(nullptr);
+    analysisThread.quit();
+    analysisThread.wait();
+}
+
+bool AudioVisualizer::isSupported()
+{
+#ifdef AUDIOVISUALIZER_BUFFER_OUTPUT
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AudioVisualizer::attach(QMediaPlayer *newPlayer)
+{
+#ifdef AUDIOVISUALIZER_BUFFER_OUTPUT
+    if (player == newPlayer)
+        return;
+    if (player)
+        player->setAudioBufferOutput(nullptr);
+    delete bufferOutput;
+    bufferOutput = nullptr;
+
+    player = newPlayer;
+    if (!player)
+        return;
+
+    // Bufory idą kolejką wprost do wątku analizy (kontekst połączenia żyje w tym wątku)
+    bufferOutput = new QAudioBufferOutput(this);
+    connect(bufferOutput, &QAudioBufferOutput::audioBufferReceived, analysisContext,
+            [this](const QAudioBuffer &buffer) { processBuffer(buffer); });
+    player->setAudioBufferOutput(bufferOutput);
+#else
+    player = newPlayer;
+#endif
+}
+
+void AudioVisualizer::processBuffer(const QAudioBuffer &buffer)
+{
+    const QAudioFormat format = buffer.format();
+    const int channels = format.channelCount();
+    const int frames = int(buffer.frameCount());
+    if (channels <= 0 || frames <= 0)
+        return;
+
+    // Mono jako średnia kanałów, w zakresie -1..1
+    monoSamples.resize(frames);
+    float *mono = monoSamples.data();
+    const float scale = 1.0f / channels;
+    switch (format.sampleFormat()) {
+    case QAudioFormat::Float: {
+        const float *data = buffer.constData<float>();
+        for (int f = 0; f < frames; ++f) {
+            float sum = 0.0f;
+            for (int c = 0; c < channels; ++c)
+                sum += data[f * channels + c];
+            mono[f] = sum * scale;
+        }
+        break;
+    }
+    case QAudioFormat::Int16: {
+        const qint16 *data = buffer.constData<qint16>();
+        for (int f = 0; f < frames; ++f) {
+            int sum = 0;
+            for (int c = 0; c < channels; ++c)
+                sum += data[f * channels + c];
+            mono[f] = sum * scale / 32768.0f;
+        }
+        break;
+    }
+    case QAudioFormat::Int32: {
+        const qint32 *data = buffer.constData<qint32>();
+        for (int f = 0; f < frames; ++f) {
+            double sum = 0.0;
+            for (int c = 0; c < channels; ++c)
+                sum += data[f * channels + c];
+            mono[f] = float(sum * scale / 2147483648.0);
+        }
+        break;
+    }
+    case QAudioFormat::UInt8: {
+        const quint8 *data = buffer.constData<quint8>();
+        for (int f = 0; f < frames; ++f) {
+            int sum = 0;
+            for (int c = 0; c < channels; ++c)
+                sum += data[f * channels + c] - 128;
+            mono[f] = sum * scale / 128.0f;
+        }
+        break;
+    }
+    default:
+        return;
+    }
+
+    analyzer.setSampleRate(format.sampleRate());
+    const bool spectrum = analyzer.addSamples(mono, frames);
+    QVector<float> minima, maxima;
+    analyzer.takePeaks(&minima, &maxima);
+
+    {
+        QMutexLocker locker(&mutex);
+        if (spectrum)
+            bands = analyzer.bands();
+        for (int i = 0; i < minima.size(); ++i) {
+            waveMin[waveHead] = minima[i];
+            waveMax[waveHead] = maxima[i];
+            waveHead = (waveHead + 1) % kWaveColumns;
+        }
+    }
+    UiUpdateScheduler::instance().markDirty(frameUpdate);
+}
+
+void AudioVisualizer::paintEvent(QPaintEvent *)
+{
+    QVector<float> levels;
+    QVector<float> minima(width()), maxima(width());
+    {
+        // Kopia wyników (najnowsza kolumna przebiegu przy prawej krawędzi)
+        QMutexLocker locker(&mutex);
+        levels = bands;
+        const int columns = qMin(width(), kWaveColumns);
+        for (int x = 0; x < columns; ++x) {
+            const int column = (waveHead - columns + x + kWaveColumns) % kWaveColumns;
+            minima[width() - columns + x] = waveMin[column];
+            maxima[width() - columns + x] = waveMax[column];
+        }
+    }
+
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor("#0A0F22"));
+
+    // Widmo: słupki pasm
+    const int spectrumHeight = int(height() * kSpectrumHeight);
+    QLinearGradient gradient(0, spectrumHeight, 0, 0);
+    gradient.setColorAt(0.0, QColor("#2E6BFF"));
+    gradient.setColorAt(0.7, QColor("#7CFC9A"));
+    gradient.setColorAt(1.0, QColor("#FFD166"));
+    const double barWidth = double(width()) / levels.size();
+    for (int b = 0; b < levels.size(); ++b) {
+        const int barHeight = int(levels[b] * (spectrumHeight - 8));
+        painter.fillRect(QRectF(b * barWidth + 1, spectrumHeight - barHeight, barWidth - 2, barHeight), gradient);
+    }
+
+    // Przebieg: pionowa linia od minimum do maksimum w każdej kolumnie
+    const int waveTop = spectrumHeight + 4;
+    const double halfHeight = (height() - waveTop) / 2.0;
+    const double center = waveTop + halfHeight;
+    painter.setPen(QColor("#7080B0"));
+    for (int x = 0; x < width(); ++x)
+        painter.drawLine(QPointF(x, center - maxima[x] * halfHeight), QPointF(x, center - minima[x] * halfHeight));
+}
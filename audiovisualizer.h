@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QWidget>
+#include <QThread>              // Wątek analizy dźwięku
+#include <QMutex>
+#include <QPointer>
+#include <QVector>
+#include <QMediaPlayer>
+
+#include "spectrumanalyzer.h"   // FFT i szczyty przebiegu
+
+class QAudioBuffer;
+class QAudioBufferOutput;
+
+// Wizualizacja utworów audio: widmo w pasmach logarytmicznych i przewijany przebieg.
+// Zdekodowane bufory dźwięku (QAudioBufferOutput odtwarzacza) trafiają wprost do wątku
+// analizy; wątek GUI tylko kopiuje gotowe wyniki i rysuje nie częściej niż odświeża się ekran.
+// Wymaga Qt 6.8 (QAudioBufferOutput) — w starszych wersjach isSupported() zwraca false.
+class AudioVisualizer : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit AudioVisualizer(QWidget *parent = nullptr);
+    ~AudioVisualizer() override;
+
+    static bool isSupported();
+
+    // Odtwarzacz, z którego pochodzi dźwięk (zmiana przy zamianie zestawów odtwarzacza)
+    void attach(QMediaPlayer *player);
+
+    // Podgląd buforów bieżącego odtwarzacza (odtwarzacz ma tylko jeden — korzystają z niego
+    // też inne etapy przetwarzania dźwięku); nullptr bez obsługi w Qt
+    QAudioBufferOutput *audioBufferOutput() const { return bufferOutput; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    // Wątek analizy: zamiana bufora na mono i analiza
+    void processBuffer(const QAudioBuffer &buffer);
+
+    QPointer<QMediaPlayer> player;
+    QAudioBufferOutput *bufferOutput = nullptr;
+    QThread analysisThread;
+    QObject *analysisContext;           // Obiekt w wątku analizy (odbiorca buforów)
+
+    SpectrumAnalyzer analyzer;          // Używany tylko w wątku analizy
+    QVector<float> monoSamples;
+
+    // Wyniki przekazywane do rysowania
+    QMutex mutex;
+    QVector<float> bands;
+    QVector<float> waveMin;             // Kolumny przebiegu (bufor kołowy)
+    QVector<float> waveMax;
+    int waveHead = 0;                   // Miejsce następnej kolumny
+
+    // Odświeżanie w rytmie ekranu (UiUpdateScheduler), tylko gdy są nowe dane i widżet jest widoczny
+    int frameUpdate;
+};
@@ -0,0 +1,358 @@
+#include "batchrenderer.h"
+#include "tracing.h"
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QPainter>
+#include <QPdfDocument>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QSet>
+#include <QMutex>
+#include <QMutexLocker>
+#include <atomic>
+#include <cstring>
+#include <functional>
+
+namespace {
+
+// Komunikaty o pominiętych i nieudanych plikach (również z wątków roboczych)
+void printError(const QString &line)
+{
+    static QMutex mutex;
+    static QTextStream stream(stderr);
+    QMutexLocker locker(&mutex);
+    stream << line << "\n";
+    stream.flush();
+}
+
+QSet<QString> imageSuffixes()
+{
+    QSet<QString> suffixes;
+    for (const QByteArray &format : QImageReader::supportedImageFormats())
+        suffixes.insert(QString::fromLatin1(format).toLower());
+    suffixes.remove("pdf");
+    return suffixes;
+}
+
+}
+
+BatchRenderer::BatchRenderer(const BatchRenderOptions &options)
+    : options(options)
+{
+}
+
+int BatchRenderer::addInputs(const QStringList &paths)
+{
+    const int pagesBefore = pageCount();
+    for (const QString &path : paths) {
+        QFileInfo info(path);
+        if (info.isDir()) {
+            QDirIterator it(path, QDir::Files | QDir::Readable, QDirIterator::Subdirectories);
+            QStringList files;
+            while (it.hasNext())
+                files.append(it.next());
+            files.sort();           // Stała kolejność i nazwy wyników niezależnie od systemu plików
+            const QDir root(path);
+            for (const QString &file : std::as_const(files))
+                addFile(file, root.relativeFilePath(QFileInfo(file).path()));
+        } else if (info.isFile()) {
+            addFile(info.absoluteFilePath(), QString());
+        } else {
+            printError(QString("[batch] skipped file=\"%1\" reason=not_found").arg(path));
+        }
+    }
+    return pageCount() - pagesBefore;
+}
+
+void BatchRenderer::addFile(const QString &path, const QString &relativeDir)
+{
+    static const QSet<QString> suffixes = imageSuffixes();
+    const QFileInfo info(path);
+    const QString suffix = info.suffix().toLower();
+    const QString stem = relativeDir.isEmpty() || relativeDir == "."
+                             ? info.completeBaseName() : relativeDir + "/" + info.completeBaseName();
+
+    if (suffix == "pdf") {
+        // Liczba stron z jednego wczytania w wątku wywołującym; rendery już w wątkach roboczych
+        QPdfDocument document;
+        if (document.load(path) != QPdfDocument::Error::None) {
+            printError(QString("[batch] skipped file=\"%1\" reason=pdf_load_failed").arg(path));
+            return;
+        }
+        QStringList pageSuffixes;
+        for (int page = 0; page < document.pageCount(); ++page)
+            pageSuffixes.append(QString("-p%1").arg(page + 1, 4, 10, QChar('0')));
+        const QString documentStem = reserveOutput(stem, pageSuffixes, path);
+
+        const int index = int(pdfFiles.size());
+        pdfFiles.append(path);
+        for (int page = 0; page < document.pageCount(); ++page)
+            pageTasks.append(PageTask{index, page, documentStem + pageSuffixes[page]});
+    } else if (suffixes.contains(suffix)) {
+        imageTasks.append(ImageTask{path, reserveOutput(stem, { QString() }, path)});
+    }
+}
+
+QString BatchRenderer::reserveOutput(const QString &stem, const QStringList &suffixes, const QString &source)
+{
+    auto isFree = [&](const QString &candidate) {
+        for (const QString &suffix : suffixes) {
+            if (outputNames.contains((candidate + suffix).toLower()))
+                return false;
+        }
+        return true;
+    };
+
+    QString chosen = stem;
+    for (int n = 2; !isFree(chosen); ++n)
+        chosen = QString("%1-%2").arg(stem).arg(n);
+    for (const QString &suffix : suffixes)
+        outputNames.insert((chosen + suffix).toLower());
+
+    if (chosen != stem) {
+        ++renamed;
+        printError(QString("[batch] renamed file=\"%1\" output=\"%2\" reason=name_collision").arg(source, chosen));
+    }
+    return chosen;
+}
+
+BatchRenderStats BatchRenderer::run(int threads)
+{
+    BatchRenderStats stats;
+    stats.threads = threads > 0 ? threads : QThread::idealThreadCount();
+    QDir().mkpath(options.outputDir);
+
+    std::atomic<int> done{0};
+    std::atomic<int> failed{0};
+
+    // Każdy wątek pobiera kolejne zadania ze wspólnego licznika i czeka na resztę na końcu etapu
+    auto runStage = [&](int taskCount, const std::function<void(std::atomic<int> &)> &work) {
+        QElapsedTimer timer;
+        timer.start();
+        std::atomic<int> next{0};
+        QList<QThread *> workers;
+        for (int t = 0; t < qMin(stats.threads, taskCount); ++t) {
+            QThread *worker = QThread::create([&]() { work(next); });
+            worker->setObjectName("BatchRender");
+            worker->start();
+            workers.append(worker);
+        }
+        for (QThread *worker : workers) {
+            worker->wait();
+            delete worker;
+        }
+        return timer.elapsed();
+    };
+
+    // Strony PDF: zadania jednego dokumentu są obok siebie, więc wątek wczytuje każdy dokument raz
+    stats.pdfMs = runStage(pageCount(), [&](std::atomic<int> &next) {
+        QPdfDocument document;
+        int loaded = -1;
+        int i;
+        while ((i = next++) < pageTasks.size()) {
+            const PageTask &task = pageTasks[i];
+            if (task.document != loaded) {
+                TRACE_SCOPE_INFO("batch.pdf_load", pdfFiles[task.document]);
+                document.close();
+                loaded = document.load(pdfFiles[task.document]) == QPdfDocument::Error::None ? task.document : -1;
+            }
+            if (loaded >= 0 && renderPage(document, task)) {
+                ++done;
+            } else {
+                ++failed;
+                printError(QString("[batch] failed file=\"%1\" page=%2")
+                               .arg(pdfFiles[task.document]).arg(task.page + 1));
+            }
+        }
+    });
+    stats.pages = done.exchange(0);
+
+    stats.imageMs = runStage(imageCount(), [&](std::atomic<int> &next) {
+        int i;
+        while ((i = next++) < imageTasks.size()) {
+            if (resizeImage(imageTasks[i])) {
+                ++done;
+            } else {
+                ++failed;
+                printError(QString("[batch] failed file=\"%1\"").arg(imageTasks[i].path));
+            }
+        }
+    });
+    stats.images = done;
+    stats.failed = failed;
+    return stats;
+}
+
+// Rozmiar wyniku: strona w punktach przy options.dpi albo dopasowanie do options.maxSize
+QSize BatchRenderer::fitSize(const QSizeF &size) const
+{
+    if (size.isEmpty())
+        return QSize();
+    if (options.maxSize.width() <= 0 && options.maxSize.height() <= 0)
+        return (size * options.dpi / 72.0).toSize();
+
+    double scale = 0.0;
+    if (options.maxSize.width() > 0)
+        scale = options.maxSize.width() / size.width();
+    if (options.maxSize.height() > 0) {
+        const double fy = options.maxSize.height() / size.height();
+        scale = scale > 0.0 ? qMin(scale, fy) : fy;
+    }
+    return QSize(qMax(1, qRound(size.width() * scale)), qMax(1, qRound(size.height() * scale)));
+}
+
+bool BatchRenderer::renderPage(QPdfDocument &document, const PageTask &task) const
+{
+    TRACE_SCOPE_INFO("batch.page", QString("%1 page=%2").arg(pdfFiles[task.document]).arg(task.page + 1));
+    const QSize size = fitSize(document.pagePointSize(task.page));
+    if (size.isEmpty())
+        return false;
+    const QImage image = document.render(task.page, size);
+    if (image.isNull())
+        return false;
+    return save(image, task.output);
+}
+
+bool BatchRenderer::resizeImage(const ImageTask &task) const
+{
+    TRACE_SCOPE_INFO("batch.image", task.path);
+    QImageReader reader(task.path);
+    reader.setAutoTransform(true);
+    QImage image = reader.read();
+    if (image.isNull())
+        return false;
+
+    // Obrazy są tylko zmniejszane (jak fitFactor w ImageViewer); bez limitu — sama konwersja formatu
+    if (options.maxSize.width() > 0 || options.maxSize.height() > 0) {
+        const QSize target = fitSize(image.size());
+        if (target.width() < image.width())
+            image = image.scaled(target, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return save(image, task.output);
+}
+
+bool BatchRenderer::save(QImage image, const QString &output) const
+{
+    // Formaty bez przezroczystości: białe tło zamiast czarnego
+    const QByteArray format = options.format.toLower();
+    if (image.hasAlphaChannel() && (format == "jpg" || format == "jpeg" || format == "bmp")) {
+        QImage opaque(image.size(), QImage::Format_RGB32);
+        opaque.fill(Qt::white);
+        QPainter painter(&opaque);
+        painter.drawImage(0, 0, image);
+        painter.end();
+        image = opaque;
+    }
+
+    // Podkatalogi wyników odwzorowują katalogi wejściowe (mkpath toleruje równoległe wywołania)
+    const QString filePath = QDir(options.outputDir).filePath(output + "." + QString::fromLatin1(format));
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QImageWriter writer(filePath, format);
+    if (options.quality >= 0)
+        writer.setQuality(options.quality);
+    return writer.write(image);
+}
+
+bool BatchRenderer::isBatchCommand(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch-render") == 0)
+            return true;
+    }
+    return false;
+}
+
+int BatchRenderer::runCommandLine(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Batch render of PDF pages and image resizing without a display.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "PDF files, images or directories (searched recursively).", "inputs...");
+    const QCommandLineOption batchOption("batch-render", "Batch mode (instead of the window).");
+    const QCommandLineOption outputOption({ "o", "output" }, "Output directory.", "dir");
+    const QCommandLineOption formatOption("format", "Output format, e.g. png, jpg, webp (default png).", "format", "png");
+    const QCommandLineOption widthOption("width", "Maximum output width in pixels.", "px", "0");
+    const QCommandLineOption heightOption("height", "Maximum output height in pixels.", "px", "0");
+    const QCommandLineOption dpiOption("dpi", "PDF resolution when no size is given (default 150).", "dpi", "150");
+    const QCommandLineOption qualityOption("quality", "Output quality 0-100 (default: format default).", "q", "-1");
+    const QCommandLineOption threadsOption("threads", "Worker threads (default: all cores).", "n",
+                                           QString::number(QThread::idealThreadCount()));
+    const QCommandLineOption scalingOption("scaling", "Repeat the batch on 1, 2, 4... threads up to --threads "
+                                                      "and report throughput for each count.");
+    parser.addOptions({ batchOption, outputOption, formatOption, widthOption, heightOption,
+                        dpiOption, qualityOption, threadsOption, scalingOption });
+    parser.process(arguments);
+
+    BatchRenderOptions options;
+    options.outputDir = parser.value(outputOption);
+    options.format = parser.value(formatOption).toLatin1().toLower();
+    options.maxSize = QSize(parser.value(widthOption).toInt(), parser.value(heightOption).toInt());
+    options.dpi = parser.value(dpiOption).toInt();
+    options.quality = parser.value(qualityOption).toInt();
+    const int maxThreads = parser.value(threadsOption).toInt();
+
+    QString error;
+    if (options.outputDir.isEmpty())
+        error = "missing --output";
+    else if (parser.positionalArguments().isEmpty())
+        error = "no inputs";
+    else if (!QImageWriter::supportedImageFormats().contains(options.format))
+        error = "unsupported format " + QString::fromLatin1(options.format);
+    else if (options.dpi <= 0 || maxThreads <= 0 || options.quality > 100)
+        error = "invalid --dpi, --threads or --quality";
+    if (!error.isEmpty()) {
+        printError("[batch] " + error + "\n\n" + parser.helpText());
+        return 2;
+    }
+
+    BatchRenderer renderer(options);
+    renderer.addInputs(parser.positionalArguments());
+    QTextStream out(stdout);
+    out << QString("[batch] pdf_pages=%1 images=%2 renamed=%3 format=%4 max_size=%5x%6 dpi=%7 cores=%8\n")
+               .arg(renderer.pageCount()).arg(renderer.imageCount()).arg(renderer.renamedCount())
+               .arg(QString::fromLatin1(options.format))
+               .arg(options.maxSize.width()).arg(options.maxSize.height()).arg(options.dpi)
+               .arg(QThread::idealThreadCount());
+    out.flush();
+    if (renderer.pageCount() == 0 && renderer.imageCount() == 0)
+        return 1;
+
+    QList<int> threadCounts;
+    if (parser.isSet(scalingOption)) {
+        for (int n = 1; n < maxThreads; n *= 2)
+            threadCounts.append(n);
+    }
+    threadCounts.append(maxThreads);
+
+    // Przy --scaling przyspieszenie względem jednego wątku (kolejne przebiegi nadpisują wyniki)
+    bool anyFailed = false;
+    double basePages = 0.0, baseImages = 0.0;
+    for (int threads : std::as_const(threadCounts)) {
+        const BatchRenderStats stats = renderer.run(threads);
+        anyFailed = anyFailed || stats.failed > 0;
+        QString line = QString("[batch] threads=%1 pages=%2 pdf_ms=%3 pages_per_sec=%4 images=%5 image_ms=%6 "
+                               "images_per_sec=%7 failed=%8")
+                           .arg(stats.threads).arg(stats.pages).arg(stats.pdfMs)
+                           .arg(stats.pagesPerSecond(), 0, 'f', 1).arg(stats.images).arg(stats.imageMs)
+                           .arg(stats.imagesPerSecond(), 0, 'f', 1).arg(stats.failed);
+        if (threadCounts.size() > 1) {
+            if (threads == 1) {
+                basePages = stats.pagesPerSecond();
+                baseImages = stats.imagesPerSecond();
+            }
+            const double pageSpeedup = basePages > 0 ? stats.pagesPerSecond() / basePages : 0.0;
+            const double imageSpeedup = baseImages > 0 ? stats.imagesPerSecond() / baseImages : 0.0;
+            line += QString(" pages_speedup=%1 images_speedup=%2 pages_efficiency=%3 images_efficiency=%4")
+                        .arg(pageSpeedup, 0, 'f', 2).arg(imageSpeedup, 0, 'f', 2)
+                        .arg(pageSpeedup / stats.threads, 0, 'f', 2).arg(imageSpeedup / stats.threads, 0, 'f', 2);
+        }
+        out << line << "\n";
+        out.flush();
+    }
+    return anyFailed ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QImage>
+#include <QList>
+#include <QSet>
+
+class QPdfDocument;
+
+// Ustawienia wsadowego renderowania
+struct BatchRenderOptions {
+    QString outputDir;
+    QByteArray format = "png";  // Format plików wynikowych (obsługiwany przez QImageWriter)
+    QSize maxSize;              // Największy rozmiar wyniku w pikselach; 0 w wymiarze = bez limitu
+    int dpi = 150;              // Rozdzielczość stron PDF, gdy maxSize nie jest podany
+    int quality = -1;           // Jakość zapisu 0–100 (-1 = domyślna formatu)
+};
+
+// Wynik jednego przebiegu
+struct BatchRenderStats {
+    int threads = 0;
+    int pages = 0;              // Strony PDF zapisane
+    int images = 0;             // Obrazy zapisane
+    int failed = 0;
+    qint64 pdfMs = 0;           // Czas etapu stron PDF
+    qint64 imageMs = 0;         // Czas etapu obrazów
+
+    double pagesPerSecond() const { return pdfMs > 0 ? pages * 1000.0 / pdfMs : 0.0; }
+    double imagesPerSecond() const { return imageMs > 0 ? images * 1000.0 / imageMs : 0.0; }
+};
+
+// Wsadowe renderowanie stron PDF i zmniejszanie obrazów bez okna (tryb wiersza poleceń).
+// Strony i obrazy są rozdzielane między wątki ze wspólnego licznika; każdy wątek renderuje
+// strony własną instancją QPdfDocument (silnik PDF nie jest bezpieczny wątkowo).
+// Skalowanie obrazów jak w ImageViewer::updateImageDisplay (wygładzanie, zachowane proporcje).
+// Wyniki z katalogów wejściowych zachowują ścieżkę względną wewnątrz katalogu; nazwy są ustalane
+// przy dodawaniu plików, a kolizje (np. a/x.jpg i b/x.jpg, x.png i x.jpg) dostają przyrostek -2, -3...
+class BatchRenderer {
+public:
+    explicit BatchRenderer(const BatchRenderOptions &options);
+
+    // Pliki PDF i obrazy; katalogi są przeszukiwane rekurencyjnie. Zwraca liczbę stron PDF
+    // (dokumenty, których nie da się otworzyć, są pomijane z ostrzeżeniem).
+    int addInputs(const QStringList &paths);
+
+    int pageCount() const { return int(pageTasks.size()); }
+    int imageCount() const { return int(imageTasks.size()); }
+    // Wyniki, które dostały przyrostek z powodu kolizji nazw
+    int renamedCount() const { return renamed; }
+
+    // Przebieg na podanej liczbie wątków (0 = liczba rdzeni)
+    BatchRenderStats run(int threads);
+
+    // Czy argumenty programu wybierają tryb wsadowy (--batch-render)
+    static bool isBatchCommand(int argc, char *argv[]);
+
+    // Tryb wiersza poleceń: odczyt opcji, przebieg (lub kilka — --scaling) i raport na stdout.
+    // Kod wyjścia: 0 = wszystko zapisane, 1 = część się nie udała, 2 = błędne argumenty.
+    static int runCommandLine(const QStringList &arguments);
+
+private:
+    struct PageTask {
+        int document;           // Indeks w pdfFiles
+        int page;
+        QString output;         // Ścieżka wyniku względem outputDir, bez rozszerzenia
+    };
+
+    struct ImageTask {
+        QString path;
+        QString output;
+    };
+
+    // relativeDir: katalog pliku względem katalogu wejściowego (pusty dla plików podanych wprost)
+    void addFile(const QString &path, const QString &relativeDir);
+    // Pierwsza wolna nazwa: stem albo stem-2, stem-3...; zajmuje stem + każdy z przyrostków
+    QString reserveOutput(const QString &stem, const QStringList &suffixes, const QString &source);
+    bool renderPage(QPdfDocument &document, const PageTask &task) const;
+    bool resizeImage(const ImageTask &task) const;
+    bool save(QImage image, const QString &output) const;
+    QSize fitSize(const QSizeF &size) const;
+
+    BatchRenderOptions options;
+    QStringList pdfFiles;
+    QList<PageTask> pageTasks;
+    QList<ImageTask> imageTasks;
+    QSet<QString> outputNames;  // Zajęte nazwy wyników (małymi literami — systemy plików bez wielkości liter)
+    int renamed = 0;
+};
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""Uruchamianie benchmarków i porównanie wyników z zapisaną bazą.
+
+Użycie:
+  bench.py run --bin-dir build/benchmarks --output wyniki.json [--only nazwa ...]
+  bench.py compare baza.json wyniki.json [--threshold 10]
+
+Każdy program *_bench wypisuje linie „[etykieta:] klucz=wartość ...”. Etykieta wiersza
+to tekst przed dwukropkiem i nienumeryczne pary przed pierwszą liczbą (np. „mode=parallel”,
+„page=image cmd=zoom_in/zoom_out”); gdy jej nie ma, etykietą jest pierwsza para
+(np. „user_scale=2.00”). Liczbowe pary trafiają do JSON:
+  {"meta": {...}, "results": {bench: {etykieta: {klucz: wartość}}}}
+
+compare porównuje tylko metryki czasu i przepustowości: *_ms, *_us, cpu_ms_per_*
+(mniej = lepiej) oraz *_per_sec, *realtime*, *speedup*, *efficiency* (więcej = lepiej),
+a także liczniki błędów (timeouts) — dla nich regresją jest każdy wzrost, także od zera.
+Kod wyjścia 1, gdy któraś metryka jest gorsza od bazy o więcej niż --threshold procent,
+gdy w wynikach brakuje wiersza lub porównywanej metryki z bazy (np. benchmark się wysypał,
+przekroczył limit czasu albo tryb nie dał żadnego pomiaru)
+albo gdy meta.failed wyników nie jest puste. Wyniki z --only porównuje się z bazą tego samego zestawu.
+"""
+
+import argparse
+import datetime
+import json
+import os
+import platform
+import re
+import subprocess
+import sys
+
+NUMBER = re.compile(r"^[-+]?\d+(\.\d+)?$")
+HIGHER_IS_BETTER = ("_per_sec", "realtime", "speedup", "efficiency")
+LOWER_IS_BETTER = ("_ms", "_us")
+# Liczniki błędów: regresją jest każdy wzrost względem bazy (baza zwykle 0, więc bez procentów)
+ERROR_COUNTS = ("timeouts",)
+
+# Bardzo krótkie czasy (poniżej tej wartości) zbyt mocno zależą od szumu pomiaru
+MIN_MS = 0.05
+MIN_US = 50.0
+
+
+def parse_line(line):
+    """Zwraca (etykieta, {klucz: liczba}) albo None dla linii bez par klucz=wartość."""
+    if "=" not in line:
+        return None
+    prefix, sep, rest = line.partition(":")
+    if sep and "=" not in prefix:
+        label_parts = [prefix.strip()]
+        tokens = rest.split()
+    else:
+        label_parts = []
+        tokens = line.split()
+
+    metrics = {}
+    in_label = True
+    for token in tokens:
+        key, eq, value = token.partition("=")
+        if not eq:
+            continue
+        if NUMBER.match(value):
+            in_label = False
+            metrics[key] = float(value)
+        elif in_label:
+            label_parts.append(token)
+    if not label_parts and len(tokens) > 1:
+        first = tokens[0]
+        label_parts.append(first)
+        metrics.pop(first.partition("=")[0], None)
+    return " ".join(label_parts), metrics
+
+
+def parse_output(text):
+    results = {}
+    for line in text.splitlines():
+        parsed = parse_line(line.strip())
+        if parsed is None:
+            continue
+        label, metrics = parsed
+        if metrics:
+            results.setdefault(label, {}).update(metrics)
+    return results
+
+
+def find_benchmarks(bin_dir, only):
+    names = []
+    for entry in sorted(os.listdir(bin_dir)):
+        path = os.path.join(bin_dir, entry)
+        name = os.path.splitext(entry)[0]
+        if not name.endswith("_bench") or not os.access(path, os.X_OK) or os.path.isdir(path):
+            continue
+        if only and name not in only:
+            continue
+        names.append((name, path))
+    return names
+
+
+def command_run(args):
+    benchmarks = find_benchmarks(args.bin_dir, args.only)
+    if not benchmarks:
+        print(f"[bench] brak programów *_bench w {args.bin_dir}", file=sys.stderr)
+        return 2
+
+    results = {}
+    failed = []
+    for name, path in benchmarks:
+        print(f"[bench] {name} ...", file=sys.stderr, flush=True)
+        try:
+            proc = subprocess.run([path], capture_output=True, text=True, timeout=args.timeout)
+        except subprocess.TimeoutExpired:
+            print(f"[bench] {name} przekroczył limit {args.timeout} s", file=sys.stderr)
+            failed.append(name)
+            continue
+        sys.stderr.write(proc.stdout)
+        if proc.returncode != 0:
+            print(f"[bench] {name} zakończył się kodem {proc.returncode}", file=sys.stderr)
+            failed.append(name)
+        results[name] = parse_output(proc.stdout)
+
+    report = {
+        "meta": {
+            "date": datetime.datetime.now().isoformat(timespec="seconds"),
+            "host": platform.node(),
+            "system": platform.platform(),
+            "failed": failed,
+        },
+        "results": results,
+    }
+    with open(args.output, "w", encoding="utf-8") as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+    print(f"[bench] wyniki zapisane w {args.output}", file=sys.stderr)
+    return 1 if failed else 0
+
+
+def direction(key):
+    """+1 gdy więcej = lepiej, -1 gdy mniej = lepiej, 0 dla metryk nieporównywanych."""
+    if any(part in key for part in HIGHER_IS_BETTER):
+        return 1
+    if key.startswith("cpu_ms_per_") or key.endswith(LOWER_IS_BETTER):
+        return -1
+    return 0
+
+
+def too_small(key, base, current):
+    if key.endswith("_us"):
+        return max(base, current) < MIN_US
+    if key.endswith("_ms"):
+        return max(base, current) < MIN_MS
+    return False
+
+
+def command_compare(args):
+    with open(args.baseline, encoding="utf-8") as f:
+        baseline = json.load(f)["results"]
+    with open(args.results, encoding="utf-8") as f:
+        report = json.load(f)
+    current = report["results"]
+    failed = report.get("meta", {}).get("failed", [])
+
+    regressions = []
+    improvements = []
+    missing = []
+    for bench, labels in sorted(baseline.items()):
+        for label, metrics in sorted(labels.items()):
+            now = current.get(bench, {}).get(label)
+            if now is None:
+                missing.append(f"{bench} [{label}]")
+                continue
+            for key, base in sorted(metrics.items()):
+                if key in ERROR_COUNTS:
+                    if key in now and now[key] > base:
+                        regressions.append(f"{bench} [{label}] {key}: {base:g} -> {now[key]:g}")
+                    continue
+                sign = direction(key)
+                if sign != 0 and key not in now:
+                    # Wiersz jest, ale bez pomiaru (np. same timeouty)
+                    missing.append(f"{bench} [{label}] {key}")
+                    continue
+                if sign == 0 or base <= 0 or too_small(key, base, now[key]):
+                    continue
+                change = (now[key] - base) / base * 100.0
+                line = f"{bench} [{label}] {key}: {base:g} -> {now[key]:g} ({change:+.1f}%)"
+                if -sign * change > args.threshold:
+                    regressions.append(line)
+                elif sign * change > args.threshold:
+                    improvements.append(line)
+
+    for title, lines in (("REGRESJE", regressions), ("Poprawy", improvements),
+                         ("Nieudane benchmarki", failed), ("Brak w wynikach", missing)):
+        if lines:
+            print(f"{title} ({len(lines)}):")
+            for line in lines:
+                print(f"  {line}")
+    if not regressions:
+        print(f"Brak regresji powyżej {args.threshold:g}%.")
+    # Benchmark, który nie dał wyników, nie może przejść jako „bez regresji”
+    if failed or missing:
+        print("Porównanie niepełne — wynik negatywny.")
+    return 1 if regressions or failed or missing else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    run = sub.add_parser("run", help="uruchom benchmarki i zapisz wyniki w JSON")
+    run.add_argument("--bin-dir", required=True, help="katalog z programami *_bench")
+    run.add_argument("--output", required=True, help="plik wynikowy JSON")
+    run.add_argument("--only", nargs="*", help="tylko wybrane benchmarki (np. image_zoom_bench)")
+    run.add_argument("--timeout", type=int, default=600, help="limit czasu jednego benchmarku w sekundach")
+    run.set_defaults(handler=command_run)
+
+    compare = sub.add_parser("compare", help="porównaj wyniki z bazą")
+    compare.add_argument("baseline", help="zapisana baza (JSON z bench.py run)")
+    compare.add_argument("results", help="nowe wyniki (JSON z bench.py run)")
+    compare.add_argument("--threshold", type=float, default=10.0, help="dopuszczalne pogorszenie w procentach")
+    compare.set_defaults(handler=command_compare)
+
+    args = parser.parse_args()
+    return args.handler(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
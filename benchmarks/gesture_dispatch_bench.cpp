@@ -0,0 +1,143 @@
+// Benchmark obsługi komend gestów w oknie głównym (MainWindow::handleGesture).
+//
+// Użycie: gesture_dispatch_bench [--iterations N]
+//   Komendy typowe dla każdej strony, wykonywane N razy (domyślnie 300) naprzemiennie
+//   parami (np. pan_left/pan_right, volume_up/volume_down), żeby stan strony się nie zmieniał:
+//     menu  — komenda bez działania (sam koszt rozdziału)
+//     text  — następny/poprzedni ekran pliku tekstowego (200 000 linii)
+//     image — przesuwanie i zoom obrazu 4000×3000
+//     media — głośność (pusta playlista)
+//   call_*  — samo wywołanie handleGesture
+//   frame_* — wywołanie, obsługa zdarzeń (w tym odświeżenie w rytmie klatek) i narysowanie okna
+//   Okno 1280×800, bez ekranu (domyślnie platforma offscreen).
+
+#include "../mainwindow.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QImage>
+#include <QFile>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+
+namespace {
+
+struct Stats {
+    QVector<double> callUs;
+    QVector<double> frameMs;
+};
+
+double percentile(QVector<double> values, double p)
+{
+    if (values.isEmpty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[qMin(int(values.size()) - 1, int(p * values.size()))];
+}
+
+double mean(const QVector<double> &values)
+{
+    double sum = 0.0;
+    for (double v : values)
+        sum += v;
+    return values.isEmpty() ? 0.0 : sum / values.size();
+}
+
+// Komendy pary wykonywane na przemian, iterations razy każda
+void measure(QTextStream &out, MainWindow &window, const char *page, const QString &first,
+             const QString &second, int iterations)
+{
+    Stats stats;
+    QElapsedTimer timer;
+    for (int i = 0; i < 2 * iterations; ++i) {
+        const QString &command = i % 2 ? second : first;
+        timer.start();
+        window.handleGesture(command);
+        stats.callUs.append(timer.nsecsElapsed() / 1e3);
+        QCoreApplication::processEvents();
+        window.repaint();
+        stats.frameMs.append(timer.nsecsElapsed() / 1e6);
+    }
+    out << QString("page=%1 cmd=%2 calls=%3 call_mean_us=%4 call_p95_us=%5 frame_mean_ms=%6 frame_p95_ms=%7\n")
+               .arg(page, -5).arg(first + "/" + second, -20).arg(stats.callUs.size())
+               .arg(mean(stats.callUs), 0, 'f', 1).arg(percentile(stats.callUs, 0.95), 0, 'f', 1)
+               .arg(mean(stats.frameMs), 0, 'f', 2).arg(percentile(stats.frameMs, 0.95), 0, 'f', 2);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    qputenv("QT_MEDIA_BACKEND", "ffmpeg");
+    QApplication app(argc, argv);
+    QStandardPaths::setTestModeEnabled(true);   // Bez playlisty i bazy biblioteki użytkownika
+
+    int iterations = 300;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--iterations" && i + 1 < args.size())
+            iterations = qMax(1, args[++i].toInt());
+    }
+
+    // Dane stron: obraz i plik tekstowy
+    QTemporaryDir dir;
+    const QString imagePath = dir.filePath("image.png");
+    QImage image(4000, 3000, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x)
+            line[x] = qRgb(x & 0xFF, y & 0xFF, (x ^ y) & 0xFF);
+    }
+    image.save(imagePath, "PNG", 90);
+    const QString textPath = dir.filePath("server.log");
+    {
+        QFile file(textPath);
+        if (file.open(QIODevice::WriteOnly)) {
+            for (int i = 0; i < 200000; ++i)
+                file.write(QString("line %1 INFO request handled in %2 ms\n").arg(i).arg(i % 97).toUtf8());
+        }
+    }
+
+    qInstallMessageHandler([](QtMsgType, const QMessageLogContext &, const QString &) {});
+
+    MainWindow window;
+    window.setPageWarmUpEnabled(false);
+    window.resize(1280, 800);
+    window.show();
+    QCoreApplication::processEvents();
+
+    QTextStream out(stdout);
+    measure(out, window, "menu", "noop", "noop", iterations);
+
+    window.handleGesture("open_text");
+    if (auto *viewer = window.findChild<TextViewer *>())
+        viewer->loadTextFile(textPath);
+    QCoreApplication::processEvents();
+    measure(out, window, "text", "next", "prev", iterations);
+    window.handleGesture("go_menu");
+
+    window.handleGesture("open_image");
+    if (auto *viewer = window.findChild<ImageViewer *>()) {
+        QEventLoop loaded;              // Obraz dekodowany w puli zadań
+        QObject::connect(viewer, &ImageViewer::fileAdded, &loaded, &QEventLoop::quit);
+        viewer->loadImage(imagePath);
+        loaded.exec();
+    }
+    QCoreApplication::processEvents();
+    measure(out, window, "image", "zoom_in", "zoom_out", iterations);
+    for (int i = 0; i < 3; ++i)
+        window.handleGesture("zoom_in");        // Powiększony obraz — jest co przesuwać
+    measure(out, window, "image", "pan_right", "pan_left", iterations);
+    window.handleGesture("go_menu");
+
+    window.handleGesture("open_media");
+    QCoreApplication::processEvents();
+    measure(out, window, "media", "volume_down", "volume_up", iterations);
+    window.handleGesture("go_menu");
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Benchmark przepustowości serwera gestów (GestureServer).
+//
+// Użycie: gesture_server_bench [--commands N] [--parallel K]
+//   Klient wysyła N komend (domyślnie 2000) tak jak gesture_client.py: jedno połączenie TCP
+//   z localhost:9999 na komendę. Mierzony jest czas od nawiązania połączenia do sygnału
+//   gestureReceived oraz liczba komend na sekundę:
+//     sequential — następna komenda dopiero po odebraniu poprzedniej
+//     parallel   — K połączeń w toku naraz (domyślnie 16), jak przy szybkiej serii gestów
+//   Kod wyjścia 1, gdy port jest zajęty (np. przez działającą aplikację) albo komendy giną.
+
+#include "../gesture_server.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QHash>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+constexpr int kTimeoutMs = 10000;
+const char *const kCommands[] = { "next", "prev", "zoom_in", "zoom_out", "volume_up", "toggle_play_pause" };
+
+struct RunResult {
+    QVector<double> latencyUs;
+    double seconds = 0.0;
+    int lost = 0;
+};
+
+// Wysłanie commands komend z najwyżej parallel połączeniami w toku
+RunResult run(GestureServer &server, int commands, int parallel)
+{
+    RunResult result;
+    QEventLoop loop;
+    QElapsedTimer clock;
+    QHash<QString, QList<qint64>> sentNs;       // Komenda → czasy wysłania (kolejka FIFO)
+    int started = 0;
+    int received = 0;
+
+    std::function<void()> sendNext = [&]() {
+        if (started >= commands)
+            return;
+        const QString command = QString("%1_%2").arg(kCommands[started % 6]).arg(started);
+        ++started;
+        auto *socket = new QTcpSocket(&loop);
+        QObject::connect(socket, &QTcpSocket::connected, socket, [socket, command]() {
+            socket->write(command.toUtf8());
+        });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        sentNs[command].append(clock.nsecsElapsed());
+        socket->connectToHost(QHostAddress::LocalHost, 9999);
+    };
+
+    auto connection = QObject::connect(&server, &GestureServer::gestureReceived, &loop, [&](const QString &command) {
+        QList<qint64> &times = sentNs[command];
+        if (!times.isEmpty())
+            result.latencyUs.append((clock.nsecsElapsed() - times.takeFirst()) / 1e3);
+        if (++received >= commands)
+            loop.quit();
+        else
+            sendNext();
+    });
+    QTimer::singleShot(kTimeoutMs + commands, &loop, &QEventLoop::quit);
+
+    clock.start();
+    for (int i = 0; i < parallel; ++i)
+        sendNext();
+    loop.exec();
+    result.seconds = clock.nsecsElapsed() / 1e9;
+    result.lost = commands - received;
+    QObject::disconnect(connection);
+    return result;
+}
+
+void report(QTextStream &out, const char *mode, int commands, RunResult result)
+{
+    std::sort(result.latencyUs.begin(), result.latencyUs.end());
+    auto at = [&](double p) {
+        return result.latencyUs.isEmpty()
+                   ? 0.0 : result.latencyUs[qMin(int(result.latencyUs.size()) - 1, int(p * result.latencyUs.size()))];
+    };
+    out << QString("mode=%1 commands=%2 commands_per_sec=%3 p50_us=%4 p95_us=%5 max_us=%6 lost=%7\n")
+               .arg(mode, -10).arg(commands)
+               .arg(result.seconds > 0 ? (commands - result.lost) / result.seconds : 0.0, 0, 'f', 0)
+               .arg(at(0.50), 0, 'f', 0).arg(at(0.95), 0, 'f', 0)
+               .arg(result.latencyUs.isEmpty() ? 0.0 : result.latencyUs.last(), 0, 'f', 0)
+               .arg(result.lost);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int commands = 2000;
+    int parallel = 16;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--commands" && i + 1 < args.size())
+            commands = qMax(1, args[++i].toInt());
+        else if (args[i] == "--parallel" && i + 1 < args.size())
+            parallel = qMax(1, args[++i].toInt());
+    }
+
+    // Serwer loguje każdą komendę — tutaj tylko wyniki
+    qInstallMessageHandler([](QtMsgType, const QMessageLogContext &, const QString &) {});
+
+    GestureServer server;
+    QTextStream out(stdout);
+
+    const RunResult sequential = run(server, commands, 1);
+    report(out, "sequential", commands, sequential);
+    const RunResult burst = run(server, commands, parallel);
+    report(out, "parallel", commands, burst);
+
+    return sequential.lost == 0 && burst.lost == 0 ? 0 : 1;
+}
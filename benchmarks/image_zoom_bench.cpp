@@ -0,0 +1,114 @@
+// Benchmark skalowania obrazu w przeglądarce (ImageViewer::updateImageDisplay).
+//
+// Użycie: image_zoom_bench [--width N] [--height N] [--repeat N]
+//   Wygenerowany obraz (domyślnie 6000×4000, gradient z szumem — jak zdjęcie) jest wczytywany
+//   do ImageViewer w oknie 1280×800 i powiększany krokami zoomInAtCenter() aż do granicy zoomu.
+//   Każdy krok to jedno updateImageDisplay() (skalowanie SmoothTransformation całego obrazu).
+//   Dla każdego poziomu zoomu: średni i najdłuższy czas kroku z N powtórzeń (domyślnie 3),
+//   a także czas wczytania obrazu z dopasowaniem do widoku.
+//   Bez ekranu (domyślnie platforma offscreen).
+
+#include "../imageviewer.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+
+namespace {
+
+QImage makePhoto(int width, int height)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+    QRandomGenerator random(42);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int noise = int(random.bounded(24));
+            line[x] = qRgb((x * 255 / width + noise) & 0xFF, (y * 255 / height + noise) & 0xFF, (x + y + noise) & 0xFF);
+        }
+    }
+    return image;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    int width = 6000;
+    int height = 4000;
+    int repeat = 3;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--width" && i + 1 < args.size())
+            width = qMax(16, args[++i].toInt());
+        else if (args[i] == "--height" && i + 1 < args.size())
+            height = qMax(16, args[++i].toInt());
+        else if (args[i] == "--repeat" && i + 1 < args.size())
+            repeat = qMax(1, args[++i].toInt());
+    }
+
+    QTemporaryDir dir;
+    const QString path = dir.filePath("photo.png");
+    if (!makePhoto(width, height).save(path, "PNG", 90))
+        return 1;
+
+    ImageViewer viewer({});
+    viewer.resize(1280, 800);
+    viewer.show();
+    QCoreApplication::processEvents();
+
+    // Dekodowanie idzie do puli zadań — wczytanie kończy się razem z sygnałem fileAdded
+    QEventLoop loaded;
+    QObject::connect(&viewer, &ImageViewer::fileAdded, &loaded, &QEventLoop::quit);
+
+    QTextStream out(stdout);
+    QVector<QVector<double>> stepMs;        // [krok zoomu][powtórzenie]
+    QVector<double> scales;
+    QVector<double> loadMs;
+    for (int r = 0; r < repeat; ++r) {
+        QElapsedTimer timer;
+        timer.start();
+        viewer.loadImage(path);             // Zoom użytkownika wraca do 1.0
+        loaded.exec();
+        loadMs.append(timer.nsecsElapsed() / 1e6);
+
+        // 1.25× na krok, zoom ograniczony do 10× (ImageViewer::zoom)
+        double scale = 1.0;
+        for (int step = 0; scale * 1.25 <= 10.0; ++step) {
+            scale *= 1.25;
+            timer.start();
+            viewer.zoomInAtCenter();
+            const double ms = timer.nsecsElapsed() / 1e6;
+            if (stepMs.size() <= step) {
+                stepMs.append({});
+                scales.append(scale);
+            }
+            stepMs[step].append(ms);
+        }
+    }
+
+    auto mean = [](const QVector<double> &values) {
+        double sum = 0.0;
+        for (double v : values)
+            sum += v;
+        return values.isEmpty() ? 0.0 : sum / values.size();
+    };
+    out << QString("load: image=%1x%2 mean_ms=%3 max_ms=%4\n")
+               .arg(width).arg(height).arg(mean(loadMs), 0, 'f', 2)
+               .arg(*std::max_element(loadMs.begin(), loadMs.end()), 0, 'f', 2);
+    for (int step = 0; step < stepMs.size(); ++step) {
+        out << QString("user_scale=%1 mean_ms=%2 max_ms=%3\n")
+                   .arg(scales[step], 0, 'f', 2)
+                   .arg(mean(stepMs[step]), 0, 'f', 2)
+                   .arg(*std::max_element(stepMs[step].begin(), stepMs[step].end()), 0, 'f', 2);
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Benchmark skanowania biblioteki multimediów (MediaLibrary).
+//
+// Użycie: library_scan_bench [katalog] [--files N]
+//   katalog    — prawdziwa kolekcja (metadane czytane z plików); bez niego powstaje
+//                syntetyczne drzewo N plików (domyślnie 2000), których metadane są nieczytelne,
+//                więc mierzy się głównie przejście katalogów, porównanie z bazą i zapis.
+//
+// Mierzone przebiegi (każdy na tej samej, początkowo pustej bazie):
+//   full         — pierwsze skanowanie, wszystkie pliki są nowe
+//   incremental  — ponowne skanowanie bez zmian (wszystkie pliki pominięte)
+//   touched_1pct — ponowne skanowanie po zmianie 1% plików
+
+#include "../medialibrary.h"
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QEventLoop>
+#include <QDir>
+#include <QFile>
+#include <QDirIterator>
+#include <QTextStream>
+
+namespace {
+
+LibraryScanStats runScan(MediaLibrary &library)
+{
+    LibraryScanStats result;
+    QEventLoop loop;
+    QObject::connect(&library, &MediaLibrary::scanFinished, &loop, [&](const LibraryScanStats &stats) {
+        result = stats;
+        loop.quit();
+    });
+    library.rescan();
+    loop.exec();
+    return result;
+}
+
+void report(const char *name, const LibraryScanStats &stats)
+{
+    QTextStream(stdout) << QString("%1: files=%2 skipped=%3 updated=%4 removed=%5 ms=%6 files_per_sec=%7\n")
+                               .arg(name, -13).arg(stats.files).arg(stats.skipped).arg(stats.updated)
+                               .arg(stats.removed).arg(stats.elapsedMs).arg(stats.filesPerSecond(), 0, 'f', 1);
+}
+
+// Drzewo katalogów po 100 plików z rozszerzeniem .mp3 (bez poprawnej zawartości)
+void createSyntheticTree(const QString &root, int fileCount)
+{
+    for (int i = 0; i < fileCount; ++i) {
+        const QString dir = QString("%1/artist%2/album%3").arg(root).arg(i / 1000).arg(i / 100);
+        QDir().mkpath(dir);
+        QFile file(QString("%1/track%2.mp3").arg(dir).arg(i));
+        if (file.open(QIODevice::WriteOnly))
+            file.write(QByteArray(512, char(i)));
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QString directory;
+    int fileCount = 2000;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--files" && i + 1 < args.size())
+            fileCount = args[++i].toInt();
+        else
+            directory = args[i];
+    }
+
+    QTemporaryDir workDir;
+    if (directory.isEmpty()) {
+        directory = workDir.path() + "/media";
+        createSyntheticTree(directory, fileCount);
+    }
+
+    MediaLibrary library(workDir.path() + "/library.sqlite");
+    library.setDirectories({ directory });
+
+    report("full", runScan(library));
+    report("incremental", runScan(library));
+
+    // Zmiana co setnego pliku (dopisanie bajtu zmienia rozmiar i datę modyfikacji)
+    if (directory.startsWith(workDir.path())) {
+        int n = 0;
+        QDirIterator it(directory, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            QFile file(it.next());
+            if (n++ % 100 == 0 && file.open(QIODevice::Append))
+                file.write("x");
+        }
+        report("touched_1pct", runScan(library));
+    }
+    return 0;
+}
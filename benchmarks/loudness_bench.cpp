@@ -0,0 +1,152 @@
+// Benchmark analizy głośności (LoudnessMeter, LoudnessAnalyzer) i jej skalowania z liczbą wątków.
+//
+// Użycie: loudness_bench [katalog] [--seconds N]
+//   Bez katalogu: pomiar syntetycznego dźwięku stereo 44,1 kHz (N sekund na wątek, domyślnie 120)
+//                 w 1, 2, 4… wątkach aż do liczby rdzeni — sama część obliczeniowa.
+//   Z katalogiem: pełna analiza (dekodowanie + pomiar) plików audio z katalogu przez
+//                 LoudnessAnalyzer w 1, 2, 4… wątkach, za każdym razem bez pamięci podręcznej
+//                 (tryb testowy QStandardPaths — pamięć podręczna użytkownika nie jest ruszana).
+//                 Pula daje zadaniom Background najwyżej połowę wątków, więc powyżej tej liczby
+//                 analiza przestaje się skalować.
+//
+// Dla każdej liczby wątków: realtime (ile razy szybciej niż czas rzeczywisty), przyspieszenie
+// względem jednego wątku i wydajność (przyspieszenie / wątki; 1.0 = skalowanie liniowe).
+
+#include "../loudnessmeter.h"
+#include "../loudnessanalyzer.h"
+#include "../cacheutils.h"
+#include "../playlistmodel.h"
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QDirIterator>
+#include <QDir>
+#include <QTextStream>
+#include <QThread>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+QList<int> threadCounts()
+{
+    QList<int> counts;
+    const int cores = QThread::idealThreadCount();
+    for (int n = 1; n < cores; n *= 2)
+        counts.append(n);
+    counts.append(cores);
+    return counts;
+}
+
+void report(int threads, double realtime, double baseline)
+{
+    const double speedup = baseline > 0 ? realtime / baseline : 0.0;
+    // Bez wyrównania i jednostek — etykieta i liczby muszą być czytelne dla bench.py
+    QTextStream(stdout) << QString("threads=%1 realtime=%2 speedup=%3 efficiency=%4\n")
+                               .arg(threads).arg(realtime, 0, 'f', 1).arg(speedup, 0, 'f', 2)
+                               .arg(speedup / threads, 0, 'f', 2);
+}
+
+// Każdy wątek mierzy własny sygnał (szum o zmiennej głośności) w paczkach po 4096 ramek
+double syntheticRealtime(int threads, int seconds)
+{
+    const int rate = 44100;
+    const int frames = 4096;
+    std::vector<float> block(frames * 2);
+    quint32 seed = 1;
+    for (int i = 0; i < frames * 2; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        block[i] = (int(seed >> 9) / float(1 << 22) - 1.0f) * 0.3f * float(1.0 + std::sin(i * 0.001));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<QThread *> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.append(QThread::create([&]() {
+            LoudnessMeter meter(rate, 2);
+            for (qint64 done = 0; done < qint64(seconds) * rate; done += frames)
+                meter.addFrames(block.data(), frames);
+            volatile double sink = meter.integratedLoudness() + meter.truePeak();
+            (void)sink;
+        }));
+        workers.last()->start();
+    }
+    for (QThread *worker : workers) {
+        worker->wait();
+        delete worker;
+    }
+    return double(threads) * seconds * 1000.0 / qMax<qint64>(1, timer.elapsed());
+}
+
+// false, gdy nie ma plików (analyze() nic wtedy nie zgłasza i pętla czekałaby bez końca)
+bool decodeRealtime(const QStringList &files, int threads, double *realtime)
+{
+    if (files.isEmpty())
+        return false;
+    QDir(CacheUtils::cacheDir("media")).removeRecursively();
+
+    LoudnessAnalyzer analyzer;
+    analyzer.setThreadCount(threads);
+    LoudnessStats result;
+    QEventLoop loop;
+    QObject::connect(&analyzer, &LoudnessAnalyzer::analysisFinished, &loop, [&](const LoudnessStats &stats) {
+        result = stats;
+        loop.quit();
+    });
+    analyzer.analyze(files);
+    loop.exec();
+    *realtime = result.realtimeFactor();
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStandardPaths::setTestModeEnabled(true);
+
+    QString directory;
+    int seconds = 120;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--seconds" && i + 1 < args.size())
+            seconds = args[++i].toInt();
+        else
+            directory = args[i];
+    }
+
+    double baseline = 0.0;
+    if (directory.isEmpty()) {
+        QTextStream(stdout) << "meter: synthetic stereo 44.1 kHz, " << seconds << " s per thread\n";
+        for (int threads : threadCounts()) {
+            const double realtime = syntheticRealtime(threads, seconds);
+            if (threads == 1)
+                baseline = realtime;
+            report(threads, realtime, baseline);
+        }
+        return 0;
+    }
+
+    QStringList files;
+    QDirIterator it(directory, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString file = it.next();
+        if (PlaylistModel::isMediaFile(file))
+            files.append(file);
+    }
+    QTextStream(stdout) << "decode+meter: " << files.size() << " files\n";
+    for (int threads : threadCounts()) {
+        double realtime = 0.0;
+        if (!decodeRealtime(files, threads, &realtime)) {
+            QTextStream(stderr) << "error: no audio files in " << directory << "\n";
+            return 1;
+        }
+        if (threads == 1)
+            baseline = realtime;
+        report(threads, realtime, baseline);
+    }
+    return 0;
+}
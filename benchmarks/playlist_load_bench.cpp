@@ -0,0 +1,93 @@
+// Benchmark wczytywania dużych playlist (PlaylistModel).
+//
+// Użycie: playlist_load_bench [--entries N]
+//   Tworzy playlistę M3U z N pozycjami (domyślnie 1 000 000, po 1000 plików w katalogu),
+//   a potem mierzy:
+//   m3u_import  — strumieniowy import: czas do pierwszych wierszy w modelu i całkowity
+//   qpl_save    — zapis w formacie binarnym
+//   qpl_load    — odczyt formatu binarnego (jeden odczyt pliku)
+
+#include "../playlistmodel.h"
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+namespace {
+
+void createM3u(const QString &fileName, int entryCount)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QByteArray chunk = "#EXTM3U\n";
+    for (int i = 0; i < entryCount; ++i) {
+        chunk += QString("#EXTINF:%1,Artist %2 - Track %3\n/music/artist%2/album%4/track%3.mp3\n")
+                     .arg(180 + i % 120).arg(i / 10000).arg(i).arg(i / 1000).toUtf8();
+        if (chunk.size() > (1 << 20)) {
+            file.write(chunk);
+            chunk.clear();
+        }
+    }
+    file.write(chunk);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int entryCount = 1000000;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--entries" && i + 1 < args.size())
+            entryCount = args[++i].toInt();
+    }
+
+    QTemporaryDir workDir;
+    const QString m3u = workDir.path() + "/bench.m3u";
+    const QString qpl = workDir.path() + "/bench.qpl";
+    createM3u(m3u, entryCount);
+
+    QTextStream out(stdout);
+
+    // Strumieniowy import: pierwsze wiersze (pierwszy importProgress) i koniec importu
+    {
+        PlaylistModel model;
+        QElapsedTimer timer;
+        qint64 firstRowsMs = -1;
+        QEventLoop loop;
+        QObject::connect(&model, &PlaylistModel::importProgress, &loop, [&]() {
+            if (firstRowsMs < 0)
+                firstRowsMs = timer.elapsed();
+        });
+        QObject::connect(&model, &PlaylistModel::importFinished, &loop, &QEventLoop::quit);
+        timer.start();
+        model.importPlaylist(m3u);
+        loop.exec();
+        out << QString("%1: entries=%2 first_rows_ms=%3 ms=%4 bytes_per_entry=%5\n")
+                   .arg("m3u_import", -11).arg(model.count()).arg(firstRowsMs).arg(timer.elapsed())
+                   .arg(model.bytesPerEntry(), 0, 'f', 1);
+
+        timer.start();
+        model.save(qpl);
+        out << QString("%1: entries=%2 ms=%3 file_bytes=%4\n")
+                   .arg("qpl_save", -11).arg(model.count()).arg(timer.elapsed()).arg(QFileInfo(qpl).size());
+    }
+
+    {
+        PlaylistModel model;
+        QElapsedTimer timer;
+        timer.start();
+        const bool ok = model.load(qpl);
+        out << QString("%1: entries=%2 ms=%3 ok=%4\n")
+                   .arg("qpl_load", -11).arg(model.count()).arg(timer.elapsed()).arg(ok ? 1 : 0);
+        if (!ok)
+            return 1;
+    }
+    return 0;
+}
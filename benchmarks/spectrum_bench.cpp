@@ -0,0 +1,74 @@
+// Mikrobenchmark analizy widma (SpectrumAnalyzer) — koszt na jeden bufor dźwięku.
+//
+// Użycie: spectrum_bench [--iterations N]
+//
+// Dla typowych rozmiarów bufora (1024, 2048, 4096 ramek, 48 kHz) mierzy czas addSamples()
+// (okno, FFT, pasma, szczyty przebiegu) i podaje średnią, 99. percentyl i maksimum.
+// Kod wyjścia 1, gdy 99. percentyl przekracza budżet 1 ms na bufor.
+
+#include "../spectrumanalyzer.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+constexpr qint64 kBudgetNs = 1000000;   // 1 ms na bufor
+constexpr int kSampleRate = 48000;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int iterations = 2000;
+    const QStringList args = app.arguments();
+    const int i = int(args.indexOf("--iterations"));
+    if (i > 0 && i + 1 < args.size())
+        iterations = qMax(1, args[i + 1].toInt());
+
+    QTextStream out(stdout);
+    bool withinBudget = true;
+
+    for (int frames : { 1024, 2048, 4096 }) {
+        // Sygnał: dwie sinusoidy + szum (bez wpływu na koszt, ale realistyczne pasma)
+        QVector<float> buffer(frames);
+        SpectrumAnalyzer analyzer(64, kSampleRate);
+        QVector<qint64> times;
+        times.reserve(iterations);
+        QVector<float> minima, maxima;
+
+        qint64 sampleIndex = 0;
+        for (int it = 0; it < iterations; ++it) {
+            for (int f = 0; f < frames; ++f, ++sampleIndex) {
+                const double t = double(sampleIndex) / kSampleRate;
+                buffer[f] = float(0.5 * qSin(2 * M_PI * 440 * t) + 0.25 * qSin(2 * M_PI * 3000 * t)
+                                  + 0.05 * (std::rand() / double(RAND_MAX) - 0.5));
+            }
+
+            QElapsedTimer timer;
+            timer.start();
+            analyzer.addSamples(buffer.constData(), frames);
+            analyzer.takePeaks(&minima, &maxima);
+            times.append(timer.nsecsElapsed());
+        }
+
+        std::sort(times.begin(), times.end());
+        double mean = 0;
+        for (qint64 t : times)
+            mean += t;
+        mean /= times.size();
+        const qint64 p99 = times[qMin(int(times.size()) - 1, int(times.size() * 0.99))];
+        const qint64 worst = times.last();
+        withinBudget = withinBudget && p99 < kBudgetNs;
+
+        out << QString("buffer_frames=%1 mean_us=%2 p99_us=%3 max_us=%4 budget_us=%5\n")
+                   .arg(frames).arg(mean / 1000.0, 0, 'f', 1).arg(p99 / 1000.0, 0, 'f', 1)
+                   .arg(worst / 1000.0, 0, 'f', 1).arg(kBudgetNs / 1000);
+    }
+
+    out << (withinBudget ? "PASS\n" : "FAIL: p99 above budget\n");
+    return withinBudget ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+// Benchmark startu aplikacji (MainWindow).
+//
+// Użycie: startup_bench
+//   menu_visible  — od początku main() do pierwszego narysowania menu (okno zmaksymalizowane)
+//   page=…        — pierwsze otwarcie strony: budowa, układ i narysowanie; potem drugie
+//                   otwarcie tej samej strony (już zbudowanej) dla porównania.
+//   Budowa stron w tle jest wyłączona, żeby każde pierwsze otwarcie obejmowało budowę strony.
+//   Katalogi danych w trybie testowym, więc zapisana playlista i baza biblioteki użytkownika
+//   nie są wczytywane. Bez ekranu (domyślnie platforma offscreen).
+
+#include "../mainwindow.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QWindow>
+#include <QStandardPaths>
+#include <QTextStream>
+
+namespace {
+
+// Otwarcie strony przez slot MainWindow i synchroniczne narysowanie okna
+double openPageMs(MainWindow &window, const char *slot)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QMetaObject::invokeMethod(&window, slot);
+    window.repaint();
+    const double ms = timer.nsecsElapsed() / 1e6;
+    QMetaObject::invokeMethod(&window, "goBackToMenu");
+    QCoreApplication::processEvents();
+    return ms;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QElapsedTimer sinceStart;
+    sinceStart.start();
+
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    qputenv("QT_MEDIA_BACKEND", "ffmpeg");
+    qputenv("QT_FFMPEG_HW", "0");
+    QApplication app(argc, argv);
+    QStandardPaths::setTestModeEnabled(true);
+
+    MainWindow window;
+    window.setPageWarmUpEnabled(false);
+    window.showMaximized();
+    while (!window.windowHandle() || !window.windowHandle()->isExposed())
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    window.repaint();
+    const double menuMs = sinceStart.nsecsElapsed() / 1e6;
+
+    QTextStream out(stdout);
+    out << QString("menu_visible_ms=%1\n").arg(menuMs, 0, 'f', 1);
+
+    const struct { const char *name; const char *slot; } pages[] = {
+        { "media", "openMediaPlayer" },
+        { "text", "openTextReader" },
+        { "image", "openImageViewer" },
+    };
+    for (const auto &page : pages) {
+        const double firstMs = openPageMs(window, page.slot);
+        const double againMs = openPageMs(window, page.slot);
+        out << QString("page=%1 first_open_ms=%2 reopen_ms=%3\n")
+                   .arg(page.name, -5).arg(firstMs, 0, 'f', 1).arg(againMs, 0, 'f', 1);
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+// Benchmark wyświetlania stron w przeglądarce dokumentów (TextViewer::showPage).
+//
+// Użycie: text_page_bench [--pages N]
+//   Generowane dokumenty (QPdfWriter) w trzech odmianach oraz duży plik tekstowy:
+//     text   — gęsty tekst (kilkadziesiąt linii na stronę)
+//     vector — kilka tysięcy odcinków na stronę (wykresy, rysunki techniczne)
+//     image  — duży obraz na każdej stronie (skany)
+//     log    — plik tekstowy 200 000 linii (tryb tekstowy: nextPage = następny ekran)
+//   Dla PDF: czas wczytania i pierwszego renderu (sygnał pdfLoaded), a potem dla każdej
+//   kolejnej strony (nextPage → showPage) czas do szkicu i do renderu w pełnej rozdzielczości
+//   (PdfView::pageRendered). Dla pliku tekstowego: nextPage z narysowaniem widoku.
+//   Okno 1280×900, bez ekranu (domyślnie platforma offscreen).
+
+#include "../textviewer.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QPdfWriter>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QFile>
+#include <QTimer>
+#include <QTextStream>
+#include <algorithm>
+
+namespace {
+
+constexpr int kRenderTimeoutMs = 10000;
+
+void writePdf(const QString &path, const QString &kind, int pages)
+{
+    QPdfWriter writer(path);
+    writer.setPageSize(QPageSize(QPageSize::A4));
+    writer.setResolution(300);
+    QPainter painter(&writer);
+    QRandomGenerator random(7);
+    const QRect area = painter.viewport();
+
+    // Wspólny „skan” dla odmiany image (ten sam obraz na każdej stronie, jak w typowym PDF)
+    QImage scan;
+    if (kind == "image") {
+        scan = QImage(2480, 3508, QImage::Format_RGB32);
+        for (int y = 0; y < scan.height(); ++y) {
+            QRgb *line = reinterpret_cast<QRgb *>(scan.scanLine(y));
+            for (int x = 0; x < scan.width(); ++x) {
+                const int v = 200 + int(random.bounded(56));
+                line[x] = qRgb(v, v, v - 10);
+            }
+        }
+    }
+
+    for (int page = 0; page < pages; ++page) {
+        if (page > 0)
+            writer.newPage();
+        if (kind == "text") {
+            painter.setFont(QFont("Serif", 10));
+            const int lineHeight = painter.fontMetrics().height();
+            for (int y = lineHeight; y < area.height(); y += lineHeight)
+                painter.drawText(0, y, QString("Strona %1, linia %2: Lorem ipsum dolor sit amet, consectetur "
+                                               "adipiscing elit, sed do eiusmod tempor incididunt ut labore.")
+                                           .arg(page + 1).arg(y / lineHeight));
+        } else if (kind == "vector") {
+            painter.setPen(QPen(Qt::black, 2));
+            for (int i = 0; i < 4000; ++i)
+                painter.drawLine(int(random.bounded(area.width())), int(random.bounded(area.height())),
+                                 int(random.bounded(area.width())), int(random.bounded(area.height())));
+        } else {
+            painter.drawImage(area, scan);
+        }
+    }
+}
+
+void writeLog(const QString &path, int lines)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QByteArray chunk;
+    for (int i = 0; i < lines; ++i) {
+        chunk += QString("2024-05-01 12:%1:%2 [worker-%3] INFO request id=%4 status=200 time_ms=%5\n")
+                     .arg(i / 60 % 60, 2, 10, QChar('0')).arg(i % 60, 2, 10, QChar('0'))
+                     .arg(i % 8).arg(i).arg(i % 97).toUtf8();
+        if (chunk.size() > (1 << 20)) {
+            file.write(chunk);
+            chunk.clear();
+        }
+    }
+    file.write(chunk);
+}
+
+double percentile(QVector<double> values, double p)
+{
+    if (values.isEmpty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[qMin(int(values.size()) - 1, int(p * values.size()))];
+}
+
+double mean(const QVector<double> &values)
+{
+    double sum = 0.0;
+    for (double v : values)
+        sum += v;
+    return values.isEmpty() ? 0.0 : sum / values.size();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QStandardPaths::setTestModeEnabled(true);   // Osobny katalog pamięci podręcznej renderów
+
+    int pages = 20;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--pages" && i + 1 < args.size())
+            pages = qMax(2, args[++i].toInt());
+    }
+
+    QTemporaryDir dir;
+    TextViewer viewer;
+    viewer.resize(1280, 900);
+    viewer.show();
+    QCoreApplication::processEvents();
+    PdfView *view = viewer.findChild<PdfView *>();
+
+    QTextStream out(stdout);
+    for (const QString kind : { "text", "vector", "image" }) {
+        const QString path = dir.filePath(kind + ".pdf");
+        writePdf(path, kind, pages);
+
+        qint64 loadMs = -1, firstRenderMs = -1;
+        {
+            QEventLoop loop;
+            QObject::connect(&viewer, &TextViewer::pdfLoaded, &loop, [&](const QString &, qint64 load, qint64 render) {
+                loadMs = load;
+                firstRenderMs = render;
+                loop.quit();
+            });
+            QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+            viewer.loadPdf(path);
+            loop.exec();
+        }
+        if (loadMs < 0) {
+            out << QString("doc=%1 error=load_timeout\n").arg(kind);
+            continue;
+        }
+
+        QVector<double> callMs, draftMs, fullMs;
+        int timeouts = 0;
+        for (int page = 1; page < pages; ++page) {
+            QElapsedTimer timer;
+            double draft = -1.0;
+            bool rendered = false;
+            QEventLoop loop;
+            QObject::connect(view, &PdfView::pageRendered, &loop, [&](const PdfRenderKey &key) {
+                if (key.page != page)
+                    return;
+                if (key.draft) {
+                    draft = timer.nsecsElapsed() / 1e6;
+                    return;
+                }
+                rendered = true;
+                loop.quit();
+            });
+            QTimer::singleShot(kRenderTimeoutMs, &loop, &QEventLoop::quit);
+
+            timer.start();
+            viewer.nextPage();
+            callMs.append(timer.nsecsElapsed() / 1e6);
+            loop.exec();
+            if (!rendered) {
+                ++timeouts;
+                continue;
+            }
+            fullMs.append(timer.nsecsElapsed() / 1e6);
+            if (draft >= 0)
+                draftMs.append(draft);
+        }
+
+        out << QString("doc=%1 pages=%2 load_ms=%3 first_render_ms=%4 call_mean_ms=%5 draft_mean_ms=%6 "
+                       "page_mean_ms=%7 page_p95_ms=%8 page_max_ms=%9 timeouts=%10\n")
+                   .arg(kind, -6).arg(pages).arg(loadMs).arg(firstRenderMs)
+                   .arg(mean(callMs), 0, 'f', 2).arg(mean(draftMs), 0, 'f', 2)
+                   .arg(mean(fullMs), 0, 'f', 2).arg(percentile(fullMs, 0.95), 0, 'f', 2)
+                   .arg(fullMs.isEmpty() ? 0.0 : *std::max_element(fullMs.begin(), fullMs.end()), 0, 'f', 2)
+                   .arg(timeouts);
+    }
+
+    // Plik tekstowy: następny ekran z narysowaniem (indeks linii budowany w tle)
+    {
+        const QString path = dir.filePath("server.log");
+        writeLog(path, 200000);
+        QElapsedTimer timer;
+        timer.start();
+        viewer.loadTextFile(path);
+        viewer.repaint();
+        const double openMs = timer.nsecsElapsed() / 1e6;
+
+        QVector<double> screenMs;
+        for (int i = 0; i < 200; ++i) {
+            timer.start();
+            viewer.nextPage();
+            viewer.repaint();
+            screenMs.append(timer.nsecsElapsed() / 1e6);
+            QCoreApplication::processEvents();
+        }
+        out << QString("doc=log    lines=200000 open_ms=%1 page_mean_ms=%2 page_p95_ms=%3 page_max_ms=%4\n")
+                   .arg(openMs, 0, 'f', 2).arg(mean(screenMs), 0, 'f', 2)
+                   .arg(percentile(screenMs, 0.95), 0, 'f', 2)
+                   .arg(*std::max_element(screenMs.begin(), screenMs.end()), 0, 'f', 2);
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Benchmark rozciągania czasu dźwięku (TimeStretcher, WSOLA).
+//
+// Użycie: timestretch_bench [--seconds N]
+//   Dla każdej prędkości 0.5×–3× przetwarza N sekund (domyślnie 60) syntetycznego dźwięku
+//   stereo 44,1 kHz w blokach po 1024 ramki (jak bufory dekodera) i podaje czas procesora
+//   na sekundę dźwięku wejściowego i wyjściowego oraz najdłuższy pojedynczy blok.
+//   Na koniec: zmiana prędkości co blok (przełączanie w trakcie) i sprawdzenie ciągłości.
+
+#include "../timestretcher.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr int kRate = 44100;
+constexpr int kChannels = 2;
+constexpr int kBlock = 1024;
+
+// Akord z wolną modulacją głośności (coś bliższego muzyce niż czysty sinus)
+void fillBlock(std::vector<float> &block, qint64 firstFrame)
+{
+    for (int i = 0; i < kBlock; ++i) {
+        const double t = double(firstFrame + i) / kRate;
+        const double envelope = 0.6 + 0.4 * std::sin(2 * M_PI * 0.5 * t);
+        const double v = envelope * (0.3 * std::sin(2 * M_PI * 220 * t) + 0.2 * std::sin(2 * M_PI * 277.2 * t)
+                                     + 0.15 * std::sin(2 * M_PI * 329.6 * t));
+        block[i * kChannels] = float(v);
+        block[i * kChannels + 1] = float(v * 0.9);
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int seconds = 60;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--seconds" && i + 1 < args.size())
+            seconds = args[++i].toInt();
+    }
+
+    QTextStream out(stdout);
+    std::vector<float> block(kBlock * kChannels);
+    const qint64 totalFrames = qint64(seconds) * kRate;
+
+    for (double speed : { 0.5, 0.75, 1.0, 1.25, 1.5, 2.0, 2.5, 3.0 }) {
+        TimeStretcher stretcher(kRate, kChannels);
+        stretcher.setSpeed(speed);
+        std::vector<float> output(size_t(stretcher.maxOutputFrames(kBlock)) * kChannels);
+
+        qint64 processNs = 0;
+        qint64 maxBlockNs = 0;
+        qint64 produced = 0;
+        QElapsedTimer timer;
+        for (qint64 done = 0; done < totalFrames; done += kBlock) {
+            fillBlock(block, done);
+            timer.start();
+            produced += stretcher.process(block.data(), kBlock, output.data());
+            const qint64 ns = timer.nsecsElapsed();
+            processNs += ns;
+            maxBlockNs = qMax(maxBlockNs, ns);
+        }
+
+        const double outputSeconds = double(produced) / kRate;
+        out << QString("speed=%1 cpu_ms_per_input_s=%2 cpu_ms_per_output_s=%3 max_block_us=%4 out_in_ratio=%5\n")
+                   .arg(speed, 4, 'f', 2)
+                   .arg(processNs / 1e6 / seconds, 0, 'f', 3)
+                   .arg(outputSeconds > 0 ? processNs / 1e6 / outputSeconds : 0.0, 0, 'f', 3)
+                   .arg(maxBlockNs / 1e3, 0, 'f', 1)
+                   .arg(outputSeconds / seconds, 0, 'f', 3);
+    }
+
+    // Zmiana prędkości w trakcie: największy skok między kolejnymi próbkami wyjścia
+    // (ciągły sygnał bez trzasków ma skoki rzędu pojedynczych kroków sinusa)
+    {
+        TimeStretcher stretcher(kRate, kChannels);
+        std::vector<float> output(size_t(stretcher.maxOutputFrames(kBlock)) * kChannels);
+        const double speeds[] = { 0.5, 1.0, 1.7, 3.0, 0.8, 2.2 };
+        float previous = 0.0f;
+        float maxStep = 0.0f;
+        qint64 produced = 0;
+        for (qint64 done = 0, n = 0; done < totalFrames; done += kBlock, ++n) {
+            stretcher.setSpeed(speeds[n % 6]);
+            fillBlock(block, done);
+            const int written = stretcher.process(block.data(), kBlock, output.data());
+            for (int i = 0; i < written; ++i) {
+                const float sample = output[i * kChannels];
+                if (produced + i > kRate)           // Bez wejścia okna na początku
+                    maxStep = qMax(maxStep, qAbs(sample - previous));
+                previous = sample;
+            }
+            produced += written;
+        }
+        out << QString("speed_switching: max_sample_step=%1\n").arg(maxStep, 0, 'f', 4);
+    }
+    return 0;
+}
@@ -0,0 +1,235 @@
+// Benchmark przełączania utworów w odtwarzaczu (MediaPlayer).
+//
+// Użycie: track_switch_bench [--tracks N] [--settle-ms N] [--gapless-tracks N]
+//   Playlista N wygenerowanych plików WAV (domyślnie 12; 44,1 kHz, stereo, 8 s tonu)
+//   zapisana jako .qpl i otwarta przez openPlaylist(). Mierzony jest czas od nextTrack()
+//   do sygnału trackStarted (pierwsza pozycja nowego utworu):
+//     cold     — pierwszy utwór (wczytanie od zera)
+//     prepared — kolejne utwory, przygotowane na drugim zestawie odtwarzacza
+//                (przed przełączeniem utwór gra przez --settle-ms, domyślnie 1500 ms)
+//     rapid    — przełączanie bez czekania (następny utwór zwykle nie jest jeszcze gotowy)
+//     gapless  — osobna playlista pierwszych --gapless-tracks plików (domyślnie 6; 0 = bez tego
+//                trybu) grana do końca bez ingerencji; gap_*_ms to |przerwa| między końcem
+//                utworu a początkiem następnego z MediaPlayer::gapMeasured (cel: poniżej 5 ms)
+//   Bez urządzenia audio pozycja może nie rosnąć — takie przełączenia liczą się jako timeouts.
+//   Tryb bez żadnego pomiaru nie ma metryk czasu (bench.py compare zgłosi brak); kod wyjścia 1,
+//   gdy był choć jeden timeout albo tryb bez pomiarów.
+//   Bez ekranu (domyślnie platforma offscreen).
+
+#include "../mediaplayer.h"
+#include "../playlistmodel.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QDataStream>
+#include <QFile>
+#include <QTimer>
+#include <QTextStream>
+#include <QVector>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+constexpr int kRate = 44100;
+constexpr int kChannels = 2;
+constexpr int kTrackSeconds = 8;
+constexpr int kSwitchTimeoutMs = 5000;
+
+bool writeWav(const QString &path, double frequency)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    const quint32 frames = kRate * kTrackSeconds;
+    const quint32 dataBytes = frames * kChannels * 2;
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData("RIFF", 4);
+    stream << quint32(36 + dataBytes);
+    stream.writeRawData("WAVEfmt ", 8);
+    stream << quint32(16) << quint16(1) << quint16(kChannels) << quint32(kRate)
+           << quint32(kRate * kChannels * 2) << quint16(kChannels * 2) << quint16(16);
+    stream.writeRawData("data", 4);
+    stream << dataBytes;
+    for (quint32 i = 0; i < frames; ++i) {
+        const qint16 sample = qint16(8000 * qSin(2 * M_PI * frequency * i / kRate));
+        stream << sample << sample;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+// Przerwy przy samoczynnych przejściach playlisty odtwarzanej od pierwszego utworu;
+// transitions przejść, każde najwyżej czas utworu + kSwitchTimeoutMs
+QVector<double> measureGaps(MediaPlayer &player, const QString &playlist, int transitions, int *timeouts)
+{
+    QVector<double> gaps;
+    QEventLoop loop;
+    QTimer deadline;
+    deadline.setSingleShot(true);
+    QObject::connect(&deadline, &QTimer::timeout, &loop, &QEventLoop::quit);
+    QObject::connect(&player, &MediaPlayer::gapMeasured, &loop, [&](int, double gapMs) {
+        gaps.append(qAbs(gapMs));
+        loop.quit();
+    });
+
+    player.openPlaylist(playlist);
+    player.nextTrack();
+    while (gaps.size() + *timeouts < transitions) {
+        const int before = int(gaps.size());
+        deadline.start(kTrackSeconds * 1000 + kSwitchTimeoutMs);
+        loop.exec();
+        if (gaps.size() == before) {
+            // Bez przejścia w limicie czasu — dalsze też by nie nastąpiły
+            *timeouts = transitions - int(gaps.size());
+            break;
+        }
+    }
+    return gaps;
+}
+
+// Czas od wywołania switchTrack do trackStarted (albo -1 po przekroczeniu limitu)
+template <typename Switch>
+double timeSwitch(MediaPlayer &player, Switch switchTrack)
+{
+    QEventLoop loop;
+    bool started = false;
+    QObject::connect(&player, &MediaPlayer::trackStarted, &loop, [&]() {
+        started = true;
+        loop.quit();
+    });
+    QTimer::singleShot(kSwitchTimeoutMs, &loop, &QEventLoop::quit);
+    QElapsedTimer timer;
+    timer.start();
+    switchTrack();
+    loop.exec();
+    return started ? timer.nsecsElapsed() / 1e6 : -1.0;
+}
+
+void wait(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+// false, gdy tryb ma timeouty albo żadnego pomiaru; prefix rozróżnia metryki (np. "gap_")
+bool report(QTextStream &out, const char *mode, QVector<double> values, int timeouts,
+            const QString &count = "switches", const QString &prefix = QString())
+{
+    if (values.isEmpty()) {
+        // Bez metryk czasu — zera wyglądałyby w porównaniu jak stuprocentowa poprawa
+        out << QString("mode=%1 %2=0 timeouts=%3\n").arg(mode, -8).arg(count).arg(timeouts);
+        return false;
+    }
+
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double v : values)
+        sum += v;
+    auto at = [&](double p) {
+        return values[qMin(int(values.size()) - 1, int(p * values.size()))];
+    };
+    out << QString("mode=%1 %2=%3 %4mean_ms=%5 %4p50_ms=%6 %4p95_ms=%7 %4max_ms=%8 timeouts=%9\n")
+               .arg(mode, -8).arg(count).arg(values.size()).arg(prefix)
+               .arg(sum / values.size(), 0, 'f', 2)
+               .arg(at(0.50), 0, 'f', 2).arg(at(0.95), 0, 'f', 2)
+               .arg(values.last(), 0, 'f', 2).arg(timeouts);
+    return timeouts == 0;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    qputenv("QT_MEDIA_BACKEND", "ffmpeg");
+    qputenv("QT_FFMPEG_HW", "0");
+    QApplication app(argc, argv);
+    QStandardPaths::setTestModeEnabled(true);   // Bez playlisty i bazy biblioteki użytkownika
+
+    int tracks = 12;
+    int settleMs = 1500;
+    int gaplessTracks = 6;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--tracks" && i + 1 < args.size())
+            tracks = qMax(3, args[++i].toInt());
+        else if (args[i] == "--settle-ms" && i + 1 < args.size())
+            settleMs = qMax(0, args[++i].toInt());
+        else if (args[i] == "--gapless-tracks" && i + 1 < args.size())
+            gaplessTracks = qMax(0, args[++i].toInt());
+    }
+
+    QTemporaryDir dir;
+    QStringList files;
+    for (int i = 0; i < tracks; ++i) {
+        const QString path = dir.filePath(QString("track%1.wav").arg(i, 2, 10, QChar('0')));
+        if (!writeWav(path, 220.0 * (1 + i % 4)))
+            return 1;
+        files.append(path);
+    }
+    const QString playlist = dir.filePath("bench.qpl");
+    const QString gaplessPlaylist = dir.filePath("gapless.qpl");
+    gaplessTracks = gaplessTracks > 0 ? qBound(2, gaplessTracks, tracks) : 0;
+    {
+        PlaylistModel model;
+        model.append(files);
+        if (!model.save(playlist))
+            return 1;
+        PlaylistModel gapless;
+        gapless.append(files.mid(0, gaplessTracks));
+        if (gaplessTracks > 0 && !gapless.save(gaplessPlaylist))
+            return 1;
+    }
+
+    qInstallMessageHandler([](QtMsgType, const QMessageLogContext &, const QString &) {});
+
+    MediaPlayer player;
+    player.resize(1280, 800);
+    player.show();
+    player.openPlaylist(playlist);
+    QCoreApplication::processEvents();
+
+    QTextStream out(stdout);
+    QVector<double> cold, prepared, rapid;
+    int coldTimeouts = 0, preparedTimeouts = 0, rapidTimeouts = 0;
+
+    const double first = timeSwitch(player, [&]() { player.nextTrack(); });
+    if (first >= 0)
+        cold.append(first);
+    else
+        ++coldTimeouts;
+
+    // Połowa playlisty z czasem na przygotowanie następnego utworu, reszta bez czekania
+    const int half = tracks / 2;
+    for (int i = 1; i < half; ++i) {
+        wait(settleMs);
+        const double ms = timeSwitch(player, [&]() { player.nextTrack(); });
+        if (ms >= 0)
+            prepared.append(ms);
+        else
+            ++preparedTimeouts;
+    }
+    for (int i = half; i < tracks; ++i) {
+        const double ms = timeSwitch(player, [&]() { player.nextTrack(); });
+        if (ms >= 0)
+            rapid.append(ms);
+        else
+            ++rapidTimeouts;
+    }
+
+    bool ok = report(out, "cold", cold, coldTimeouts);
+    ok = report(out, "prepared", prepared, preparedTimeouts) && ok;
+    ok = report(out, "rapid", rapid, rapidTimeouts) && ok;
+
+    if (gaplessTracks > 0) {
+        int gapTimeouts = 0;
+        const QVector<double> gaps = measureGaps(player, gaplessPlaylist, gaplessTracks - 1, &gapTimeouts);
+        ok = report(out, "gapless", gaps, gapTimeouts, "transitions", "gap_") && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#include "cacheutils.h"
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
+
+#ifdef Q_OS_WIN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+QString CacheUtils::fileIdentityKey(const QString &filePath)
+{
+    QFileInfo info(filePath);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(info.canonicalFilePath().toUtf8());
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString CacheUtils::cacheDir(const QString &category)
+{
+    QString path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/" + category;
+    QDir().mkpath(path);
+    return path;
+}
+
+qint64 CacheUtils::processCpuTimeMs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0;
+    auto toMs = [](const FILETIME &t) {
+        return ((qint64(t.dwHighDateTime) << 32) | t.dwLowDateTime) / 10000;   // 100 ns -> ms
+    };
+    return toMs(kernel) + toMs(user);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    auto toMs = [](const timeval &t) { return qint64(t.tv_sec) * 1000 + t.tv_usec / 1000; };
+    return toMs(usage.ru_utime) + toMs(usage.ru_stime);
+#endif
+}
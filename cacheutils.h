@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QString>
+
+// Pomocnicze funkcje dla pamięci podręcznych na dysku (indeksy, rendery stron itp.)
+// i pomiarów zużycia zasobów
+namespace CacheUtils {
+
+// Klucz tożsamości pliku: skrót ścieżki, rozmiaru i czasu modyfikacji.
+// Zmiana zawartości pliku (a więc rozmiaru lub daty) daje nowy klucz.
+QString fileIdentityKey(const QString &filePath);
+
+// Katalog pamięci podręcznej dla danej kategorii, np. "pdf/<klucz>" (tworzony w razie potrzeby)
+QString cacheDir(const QString &category);
+
+// Czas procesora zużyty dotąd przez cały proces (ms; wszystkie wątki)
+qint64 processCpuTimeMs();
+
+}
@@ -38,6 +38,7 @@ prev_time = 0                    # Poprzedni czas ramki
 open_hand_active = False         # Czy gest otwartej dłoni jest aktywny
 prev_seek_x = None               # Poprzednia pozycja X do przewijania (seek)
 prev_track_x = None              # Poprzednia pozycja X do zmiany utworu
+prev_step_x = None               # Poprzednia pozycja X do krokowania klatka po klatce
 prev_mid_x = None                # Poprzednia pozycja środkowego palca (dla PDF)
 last_volume_change_time = 0      # Czas ostatniej zmiany głośności
 last_action_time = 0             # Czas ostatniej wykonanej akcji (ogólny cooldown)
@@ -163,6 +164,23 @@ while True:
                 else:
                     prev_seek_x = None
 
+                # Krok o jedną klatkę — sam palec wskazujący w górze, kciuk przy małym
+                if index_up and not middle_up and not ring_up and thumb_near_pinky:
+                    gesture_x = handLms.landmark[8].x
+                    if prev_step_x is not None:
+                        delta = gesture_x - prev_step_x
+                        if abs(delta) > 0.02 and now - last_action_time > 0.2:
+                            if delta > 0:
+                                print("Next frame")
+                                send_command("step_forward")
+                            else:
+                                print("Previous frame")
+                                send_command("step_back")
+                            last_action_time = now
+                    prev_step_x = gesture_x
+                else:
+                    prev_step_x = None
+
                 # Następny/poprzedni utwor — trzy palce + kciuk przy małym palcu
                 if index_up and middle_up and ring_up and thumb_near_pinky:
                     gesture_x = handLms.landmark[8].x
@@ -1,4 +1,5 @@
 #include "gesture_server.h"     
+#include "tracing.h"
 #include <QDebug>               
 
 // Inicjalizuje serwer TCP i ustawia nasłuch na porcie 9999 (tylko lokalnie)
@@ -16,6 +17,7 @@ GestureServer::GestureServer(QObject *parent) : QObject(parent) {
         connect(client, &QTcpSocket::readyRead, this, [=]() {
             // Odczytanie wszystkich danych jako QString (UTF-8) i usunięcie białych znaków
             QString command = QString::fromUtf8(client->readAll()).trimmed();
+            TRACE_SCOPE_INFO("gesture.receive", command);
 
             // Wypisanie komendy w konsoli (debug)
             qDebug() << "Received gesture command:" << command;
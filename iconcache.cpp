@@ -0,0 +1,43 @@
+#include "iconcache.h"
+#include <QHash>
+#include <QFile>
+
+namespace {
+
+QString iconPath(const QString &name)
+{
+    const QString resource = ":/icons/" + name;
+    return QFile::exists(resource) ? resource : "./icons/" + name;
+}
+
+}
+
+namespace IconCache {
+
+const QIcon &icon(const QString &name)
+{
+    static QHash<QString, QIcon> icons;
+    auto it = icons.find(name);
+    if (it == icons.end()) {
+        // Dekodowanie od razu, żeby pierwsze narysowanie nie czytało pliku
+        const QPixmap image(iconPath(name));
+        it = icons.insert(name, image.isNull() ? QIcon() : QIcon(image));
+    }
+    return *it;
+}
+
+const QPixmap &pixmap(const QString &name, const QSize &size)
+{
+    static QHash<QString, QPixmap> pixmaps;
+    const QString key = size.isEmpty() ? name : QString("%1@%2x%3").arg(name).arg(size.width()).arg(size.height());
+    auto it = pixmaps.find(key);
+    if (it == pixmaps.end()) {
+        QPixmap image(iconPath(name));
+        if (!image.isNull() && !size.isEmpty())
+            image = image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        it = pixmaps.insert(key, image);
+    }
+    return *it;
+}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QIcon>
+#include <QPixmap>
+#include <QString>
+
+// Wspólna pamięć ikon aplikacji. Ikony są wbudowane w plik wykonywalny (icons.qrc, ":/icons/…")
+// i dekodowane raz — kolejne wywołania zwracają ten sam obiekt zamiast czytać plik z dysku.
+// Brak zasobu (build bez icons.qrc) — odczyt z katalogu ./icons jak wcześniej.
+// Używane tylko w wątku GUI.
+namespace IconCache {
+
+// Nazwa pliku bez katalogu, np. "play_button_proj.png"
+const QIcon &icon(const QString &name);
+
+// Obraz przeskalowany do size (z zachowaniem proporcji); pusty size = oryginalny rozmiar
+const QPixmap &pixmap(const QString &name, const QSize &size = QSize());
+
+}
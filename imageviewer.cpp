@@ -1,4 +1,5 @@
 #include "imageviewer.h"
+#include "tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -7,6 +8,8 @@
 #include <QPixmap>
 #include <QPalette>
 
+#include "uiupdatescheduler.h"
+
 
 ImageViewer::ImageViewer(const QStringList &recentImages, QWidget *parent)
     : QWidget(parent),
@@ -51,14 +54,20 @@ ImageViewer::ImageViewer(const QStringList &recentImages, QWidget *parent)
     mainLayout->addLayout(buttonLayout);
     setLayout(mainLayout);
 
+    // Przesuwanie (klawisze, gesty) trafia na suwaki raz na klatkę ekranu
+    panUpdate = UiUpdateScheduler::instance().add(this, [this]() { applyPendingPan(); });
+
     // Tytuł okna i domyślny rozmiar
     setWindowTitle(tr("Image Viewer"));
     resize(800, 600);
 }
 
-// Destruktor — nie trzeba ręcznie usuwać wskaźników (Qt robi to automatycznie)
+// Destruktor — nie trzeba ręcznie usuwać wskaźników (Qt robi to automatycznie);
+// wynik dekodowania w toku nie ma już dokąd trafić
 ImageViewer::~ImageViewer()
-{ }
+{
+    cancelLoad();
+}
 
 // Otwiera i ładuje plik obrazu
 void ImageViewer::openImage()
@@ -72,12 +81,41 @@ void ImageViewer::openImage()
             QString(),
             tr("Images (*.png *.jpg *.jpeg *.bmp *.gif);;All files (*)"));
 
-        if (fileName.isEmpty())
-            return;
+        if (!fileName.isEmpty())
+            loadImage(fileName);
+    }
+    catch (const std::exception &e) {
+        qDebug() << "Unexpected error:" << e.what();
+    }
+}
+
+// Dekoduje wskazany plik obrazu w puli zadań (VisibleNow); poprzednie dekodowanie jest anulowane
+void ImageViewer::loadImage(const QString &fileName)
+{
+    decodeTask.cancel();
+
+    // 2) Próba wczytania obrazu (poza wątkiem GUI)
+    decodeTask = TaskScheduler::instance().run(TaskPriority::VisibleNow, "image.load", this,
+        [fileName](const CancellationToken &) {
+            TRACE_SCOPE_INFO("image.decode", fileName);
+            QImage img;
+            img.load(fileName);
+            return img;
+        },
+        [this, fileName](const QImage &img) { showLoadedImage(fileName, img); });
+}
 
-        // 2) Próba wczytania obrazu
-        QImage img;
-        if (!img.load(fileName)) {
+void ImageViewer::cancelLoad()
+{
+    decodeTask.cancel();
+}
+
+// Pokazuje zdekodowany obraz i dopasowuje go do widoku
+void ImageViewer::showLoadedImage(const QString &fileName, const QImage &img)
+{
+    try
+    {
+        if (img.isNull()) {
             QMessageBox::warning(
                 this,
                 tr("Image Viewer"),
@@ -120,6 +158,7 @@ void ImageViewer::openImage()
 //  Czyści obraz i resetuje stan
 void ImageViewer::clearImage()
 {
+    cancelLoad();                  // obraz w trakcie dekodowania już się nie pojawi
     if (!currentImage.isNull() && !lastLoadedPath.isEmpty()) {
         emit fileRemoved(lastLoadedPath); // powiadom MainWindow
     }
@@ -145,6 +184,8 @@ void ImageViewer::updateImageDisplay()
         return;
     }
 
+    TRACE_SCOPE_INFO("image.scale", QString::number(fitFactor * userScale, 'f', 2));
+
     // Tworzenie pixmapy i przeskalowanie w oparciu o fitFactor * userScale
     QPixmap pixmap = QPixmap::fromImage(currentImage);
     double totalScale = fitFactor * userScale;
@@ -254,6 +295,9 @@ void ImageViewer::zoom(double factor, const QPointF &viewportAnchor)
     if (currentImage.isNull())
         return;
 
+    // 0) Zaległe przesunięcie przed odczytem suwaków
+    applyPendingPan();
+
     // 1) Oblicz stare i nowe skalowanie
     double oldTotal = fitFactor * userScale;
     double newUserScale = userScale * factor;
@@ -316,15 +360,26 @@ void ImageViewer::zoomOutAtCenter()
     zoom(1.0 / 1.25, centerPt);
 }
 
-// Przesuwanie (pan) obrazu o zadany wektor (dx, dy)
+// Przesuwanie (pan) obrazu o zadany wektor (dx, dy) — kroki z jednej klatki są sumowane
 void ImageViewer::panImage(int dx, int dy)
 {
+    pendingPan += QPoint(dx, dy);
+    UiUpdateScheduler::instance().markDirty(panUpdate);
+}
+
+// Ustawienie zebranego przesunięcia na suwakach
+void ImageViewer::applyPendingPan()
+{
+    if (pendingPan.isNull())
+        return;
+
     QScrollBar *hBar = scrollArea->horizontalScrollBar(); // pasek poziomy
     QScrollBar *vBar = scrollArea->verticalScrollBar();   // pasek pionowy
 
     // Obliczenie nowej pozycji pasków
-    int newH = hBar->value() + dx;
-    int newV = vBar->value() + dy;
+    int newH = hBar->value() + pendingPan.x();
+    int newV = vBar->value() + pendingPan.y();
+    pendingPan = QPoint();
 
     // Ograniczenie nowej wartości do dostępnego zakresu suwaków
     newH = qBound(hBar->minimum(), newH, hBar->maximum());
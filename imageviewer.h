@@ -11,12 +11,19 @@
 #include <QWheelEvent>
 #include <QScrollBar>
 
+#include "taskscheduler.h"
+
 class ImageViewer : public QWidget
 {
     Q_OBJECT
 
 public:
     explicit ImageViewer(const QStringList &recentImages, QWidget *parent = nullptr);
+    // Wczytanie obrazu z pliku (bez okna dialogowego); dekodowanie w tle,
+    // obraz pojawia się w widoku razem z sygnałem fileAdded
+    void loadImage(const QString &fileName);
+    // Anulowanie dekodowania w toku (wyjście z przeglądarki, Clear)
+    void cancelLoad();
     // Przesunięcie obrazu w poziomie i pionie
     void panImage(int dx, int dy);
     // Zoom w centrum widoku
@@ -36,12 +43,15 @@ protected:
 
 private:
     void updateImageDisplay();
+    void showLoadedImage(const QString &fileName, const QImage &img);
     void openImage();
     void clearImage();
     void onBackButtonClicked();
 
     // Pełna funkcja zoomująca wokół punktu viewportu
     void zoom(double factor, const QPointF &viewportAnchor);
+    // Zebrane kroki przesunięcia ustawiane na suwakach raz na klatkę (UiUpdateScheduler)
+    void applyPendingPan();
 
     QLabel *imageLabel;
     QScrollArea *scrollArea;
@@ -52,9 +62,13 @@ private:
     QStringList rememberedImages;
     QImage currentImage; // oryginalny obraz
     QString lastLoadedPath;
+    TaskHandle decodeTask; // dekodowanie w toku (anulowane przez nowe wczytanie, Clear i Back)
 
     // by domyślnie zmieścić oryginał w ~90% viewportu
     double fitFactor;
     // dodatkowy zoom zadany przez użytkownika
     double userScale;
+
+    QPoint pendingPan;   // przesunięcie jeszcze nieustawione na suwakach
+    int panUpdate;
 };
\ No newline at end of file
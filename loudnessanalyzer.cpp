@@ -0,0 +1,308 @@
+#include "loudnessanalyzer.h"
+#include "loudnessmeter.h"
+#include "cacheutils.h"
+#include <QMutexLocker>
+#include <QAudioDecoder>
+#include <QAudioBuffer>
+#include <QAudioFormat>
+#include <QEventLoop>
+#include <QTimer>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QUrl>
+#include <QDebug>
+#include <QtMath>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace {
+constexpr quint32 kLoudnessMagic = 0x4C554653;   // "LUFS"
+constexpr quint32 kLoudnessVersion = 1;
+// Poziom docelowy (jak ReplayGain 2.0) i najwyższy dopuszczalny szczyt po wzmocnieniu
+constexpr double kTargetLufs = -18.0;
+constexpr double kMaxTruePeakDb = -1.0;
+// Przerwanie dekodowania, gdy przez tyle czasu nie pojawił się nowy bufor
+constexpr int kStallTimeoutMs = 10000;
+
+QString cacheFile(const QString &path)
+{
+    return CacheUtils::cacheDir("media/" + CacheUtils::fileIdentityKey(path)) + "/loudness";
+}
+
+// Bufor dekodera jako przeplecione próbki float
+void toFloat(const QAudioBuffer &buffer, std::vector<float> *out)
+{
+    const QAudioFormat format = buffer.format();
+    const int samples = int(buffer.frameCount()) * format.channelCount();
+    out->resize(samples);
+    float *dst = out->data();
+    switch (format.sampleFormat()) {
+    case QAudioFormat::Float:
+        std::copy(buffer.constData<float>(), buffer.constData<float>() + samples, dst);
+        break;
+    case QAudioFormat::Int16: {
+        const qint16 *src = buffer.constData<qint16>();
+        for (int i = 0; i < samples; ++i)
+            dst[i] = src[i] / 32768.0f;
+        break;
+    }
+    case QAudioFormat::Int32: {
+        const qint32 *src = buffer.constData<qint32>();
+        for (int i = 0; i < samples; ++i)
+            dst[i] = float(src[i] / 2147483648.0);
+        break;
+    }
+    case QAudioFormat::UInt8: {
+        const quint8 *src = buffer.constData<quint8>();
+        for (int i = 0; i < samples; ++i)
+            dst[i] = (src[i] - 128) / 128.0f;
+        break;
+    }
+    default:
+        out->clear();
+        break;
+    }
+}
+}
+
+double TrackLoudness::gainDb() const
+{
+    if (!valid || !std::isfinite(integratedLufs))
+        return 0.0;
+    double gain = kTargetLufs - integratedLufs;
+    if (std::isfinite(truePeakDb))
+        gain = qMin(gain, kMaxTruePeakDb - truePeakDb);
+    return gain;
+}
+
+double TrackLoudness::gainFactor() const
+{
+    return qPow(10.0, gainDb() / 20.0);
+}
+
+LoudnessAnalyzer::LoudnessAnalyzer(QObject *parent)
+    : QObject(parent)
+{ }
+
+LoudnessAnalyzer::~LoudnessAnalyzer()
+{
+    cancel();
+}
+
+void LoudnessAnalyzer::cancel()
+{
+    analysisToken.cancel();
+    // Zadanie, które sprawdziło token tuż przed anulowaniem, mogło jeszcze zgłosić następne —
+    // powtarzane, aż lista zostanie pusta
+    forever {
+        QVector<TaskHandle> pending;
+        {
+            QMutexLocker locker(&taskMutex);
+            pending.swap(tasks);
+        }
+        if (pending.isEmpty())
+            break;
+        for (const TaskHandle &task : std::as_const(pending))
+            task.cancel();
+        for (const TaskHandle &task : std::as_const(pending))
+            task.waitForFinished();
+    }
+}
+
+bool LoudnessAnalyzer::isRunning() const
+{
+    QMutexLocker locker(&taskMutex);
+    return !tasks.isEmpty();
+}
+
+void LoudnessAnalyzer::analyze(const QStringList &paths)
+{
+    cancel();
+    if (paths.isEmpty())
+        return;
+
+    analysisToken = CancellationToken();
+    auto batch = std::make_shared<Batch>();
+    batch->paths = paths;
+    batch->token = analysisToken;
+    batch->stats.files = int(paths.size());
+    batch->stats.threads = qMin(threadCount > 0 ? threadCount : qMax(1, TaskScheduler::instance().workerCount() / 2),
+                                int(paths.size()));
+    batch->remaining = batch->stats.files;
+    batch->timer.start();
+
+    for (int t = 0; t < batch->stats.threads; ++t)
+        submitNext(batch);
+}
+
+void LoudnessAnalyzer::submitNext(const std::shared_ptr<Batch> &batch)
+{
+    const int index = batch->nextFile++;
+    if (index >= batch->paths.size())
+        return;
+
+    const TaskHandle handle = TaskScheduler::instance().submit(TaskPriority::Background, "loudness.analyze",
+                                                               [this, batch, index](const CancellationToken &token) {
+        analyzeFile(*batch, index, token);
+        if (token.isCancelled())
+            return;
+        submitNext(batch);
+        if (--batch->remaining == 0)
+            finishBatch(*batch);
+    }, batch->token);
+
+    QMutexLocker locker(&taskMutex);
+    tasks.removeIf([](const TaskHandle &task) { return task.isFinished(); });
+    tasks.append(handle);
+}
+
+TrackLoudness LoudnessAnalyzer::loudness(const QString &path)
+{
+    {
+        QMutexLocker locker(&mutex);
+        auto it = results.constFind(path);
+        if (it != results.constEnd())
+            return it.value();
+    }
+
+    TrackLoudness result;
+    if (loadFromCache(path, &result)) {
+        QMutexLocker locker(&mutex);
+        results.insert(path, result);
+    }
+    return result;
+}
+
+// Jeden plik przebiegu; wynik z pamięci albo z dysku ma pierwszeństwo przed dekodowaniem
+void LoudnessAnalyzer::analyzeFile(Batch &batch, int index, const CancellationToken &token)
+{
+    if (token.isCancelled())
+        return;
+    const QString &path = batch.paths[index];
+    {
+        QMutexLocker locker(&mutex);
+        if (results.contains(path)) {
+            ++batch.cached;
+            return;
+        }
+    }
+
+    TrackLoudness result;
+    if (loadFromCache(path, &result)) {
+        ++batch.cached;
+    } else {
+        double seconds = 0.0;
+        result = measure(path, &seconds, token);
+        if (token.isCancelled())
+            return;             // Przerwany pomiar nie trafia do pamięci podręcznej
+        saveToCache(path, result);
+        batch.audioMs += qRound64(seconds * 1000.0);
+        ++batch.analyzed;
+    }
+    {
+        QMutexLocker locker(&mutex);
+        results.insert(path, result);
+    }
+    emit trackAnalyzed(path, result);
+}
+
+// Podsumowanie przebiegu (zadanie ostatniego pliku)
+void LoudnessAnalyzer::finishBatch(Batch &batch)
+{
+    const CancellationToken &token = batch.token;
+    LoudnessStats stats = batch.stats;
+    stats.cached = batch.cached;
+    stats.analyzed = batch.analyzed;
+    stats.audioSeconds = batch.audioMs / 1000.0;
+    stats.elapsedMs = batch.timer.elapsed();
+    qDebug().noquote() << QString("[loudness] files=%1 cached=%2 analyzed=%3 threads=%4 ms=%5 audio_s=%6 "
+                                  "realtime=%7x per_thread=%8x")
+                              .arg(stats.files).arg(stats.cached).arg(stats.analyzed).arg(stats.threads)
+                              .arg(stats.elapsedMs).arg(stats.audioSeconds, 0, 'f', 1)
+                              .arg(stats.realtimeFactor(), 0, 'f', 1).arg(stats.realtimeFactorPerThread(), 0, 'f', 1);
+
+    // Wynik anulowanego przebiegu (także zastąpionego nowym) nie dociera do wątku GUI
+    TaskScheduler::instance().post(this, token, [this, stats]() {
+        {
+            QMutexLocker locker(&taskMutex);
+            tasks.clear();
+        }
+        emit analysisFinished(stats);
+    });
+}
+
+TrackLoudness LoudnessAnalyzer::measure(const QString &path, double *seconds, const CancellationToken &token)
+{
+    // Natywny format dekodera (bez przepróbkowania); próbki zamieniane na float przy odczycie
+    QAudioDecoder decoder;
+    QEventLoop loop;
+    QTimer stall;
+    stall.setSingleShot(true);
+    connect(&stall, &QTimer::timeout, &loop, &QEventLoop::quit);
+    connect(&decoder, &QAudioDecoder::finished, &loop, &QEventLoop::quit);
+    connect(&decoder, qOverload<QAudioDecoder::Error>(&QAudioDecoder::error), &loop, &QEventLoop::quit);
+
+    std::unique_ptr<LoudnessMeter> meter;
+    std::vector<float> samples;
+    connect(&decoder, &QAudioDecoder::bufferReady, &loop, [&]() {
+        while (decoder.bufferAvailable()) {
+            const QAudioBuffer buffer = decoder.read();
+            const QAudioFormat format = buffer.format();
+            if (!meter)
+                meter = std::make_unique<LoudnessMeter>(format.sampleRate(), format.channelCount());
+            toFloat(buffer, &samples);
+            meter->addFrames(samples.data(), int(samples.size()) / qMax(1, format.channelCount()));
+        }
+        if (token.isCancelled()) {
+            decoder.stop();
+            loop.quit();
+        } else {
+            stall.start(kStallTimeoutMs);
+        }
+    });
+
+    decoder.setSource(QUrl::fromLocalFile(path));
+    decoder.start();
+    stall.start(kStallTimeoutMs);
+    loop.exec();
+    decoder.stop();
+
+    TrackLoudness result;
+    if (meter && decoder.error() == QAudioDecoder::NoError) {
+        result.valid = true;
+        result.integratedLufs = meter->integratedLoudness();
+        result.truePeakDb = meter->truePeak();
+        *seconds = meter->seconds();
+    }
+    return result;
+}
+
+bool LoudnessAnalyzer::loadFromCache(const QString &path, TrackLoudness *result)
+{
+    QFile file(cacheFile(path));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic, version;
+    in >> magic >> version;
+    if (magic != kLoudnessMagic || version != kLoudnessVersion)
+        return false;
+    in >> result->valid >> result->integratedLufs >> result->truePeakDb;
+    return in.status() == QDataStream::Ok;
+}
+
+// Zapisywane są też pliki, których nie dało się zdekodować — nie są dekodowane ponownie
+void LoudnessAnalyzer::saveToCache(const QString &path, const TrackLoudness &result)
+{
+    QSaveFile file(cacheFile(path));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream out(&file);
+    out << kLoudnessMagic << kLoudnessVersion << result.valid << result.integratedLufs << result.truePeakDb;
+    file.commit();
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QObject>
+#include "taskscheduler.h"      // Analiza jako zadania puli
+#include <QMutex>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
+
+// Wynik analizy jednego utworu
+struct TrackLoudness {
+    bool valid = false;
+    double integratedLufs = 0.0;    // Głośność zintegrowana (EBU R128)
+    double truePeakDb = 0.0;        // Szczyt rzeczywisty (dBTP)
+
+    // Wzmocnienie do poziomu docelowego, ograniczone tak, żeby szczyt nie przekroczył -1 dBTP
+    double gainDb() const;
+    // To samo jako mnożnik głośności (1.0, gdy utworu nie przeanalizowano)
+    double gainFactor() const;
+};
+
+// Wynik jednego przebiegu analizy
+struct LoudnessStats {
+    int files = 0;           // Utwory w kolejce
+    int cached = 0;          // Wynik był już w pamięci podręcznej
+    int analyzed = 0;        // Zdekodowane i zmierzone teraz
+    int threads = 0;
+    double audioSeconds = 0; // Czas zdekodowanego dźwięku
+    qint64 elapsedMs = 0;
+
+    // Ile razy szybciej niż w czasie rzeczywistym (łącznie i na wątek)
+    double realtimeFactor() const { return elapsedMs > 0 ? audioSeconds * 1000.0 / elapsedMs : 0.0; }
+    double realtimeFactorPerThread() const { return threads > 0 ? realtimeFactor() / threads : 0.0; }
+};
+
+// Analiza głośności utworów w tle, równolegle we wspólnej puli (TaskScheduler, klasa Background).
+// Jedno zadanie to jeden plik (własny QAudioDecoder + LoudnessMeter); zadanie po skończeniu zgłasza
+// następny plik, więc naraz w puli jest najwyżej setThreadCount() zadań, a między plikami wątek
+// wraca do kolejek i pierwszeństwo mają zadania ważniejszych klas. Wyniki trafiają do pamięci
+// i do katalogu pamięci podręcznej pliku (klucz tożsamości pliku), więc każdy utwór jest
+// analizowany tylko raz.
+class LoudnessAnalyzer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit LoudnessAnalyzer(QObject *parent = nullptr);
+    ~LoudnessAnalyzer() override;
+
+    // Analiza plików w podanej kolejności (przerywa poprzednią; zapisane wyniki są pomijane)
+    void analyze(const QStringList &paths);
+    void cancel();
+    bool isRunning() const;
+
+    // Liczba plików analizowanych naraz (0 = połowa wątków puli — tyle pula i tak daje
+    // zadaniom Background)
+    void setThreadCount(int count) { threadCount = count; }
+
+    // Wynik dla pliku z pamięci albo z dysku (valid = false, gdy jeszcze nie ma)
+    TrackLoudness loudness(const QString &path);
+
+signals:
+    // trackAnalyzed emitowane z wątków puli, analysisFinished w wątku GUI
+    void trackAnalyzed(const QString &path, const TrackLoudness &result);
+    void analysisFinished(const LoudnessStats &stats);
+
+private:
+    // Wspólny stan jednego przebiegu analizy (dzielony przez jego zadania)
+    struct Batch {
+        QStringList paths;
+        LoudnessStats stats;
+        QElapsedTimer timer;
+        CancellationToken token;
+        std::atomic<int> nextFile{0};
+        std::atomic<int> remaining{0};      // Pliki jeszcze nieskończone
+        std::atomic<int> cached{0};
+        std::atomic<int> analyzed{0};
+        std::atomic<qint64> audioMs{0};
+    };
+
+    // Zgłoszenie zadania dla następnego pliku przebiegu (nic, gdy pliki się skończyły)
+    void submitNext(const std::shared_ptr<Batch> &batch);
+    void analyzeFile(Batch &batch, int index, const CancellationToken &token);
+    void finishBatch(Batch &batch);
+    TrackLoudness measure(const QString &path, double *seconds, const CancellationToken &token);
+    static bool loadFromCache(const QString &path, TrackLoudness *result);
+    static void saveToCache(const QString &path, const TrackLoudness &result);
+
+    mutable QMutex taskMutex;               // Chroni tasks (dopisywane także z wątków puli)
+    QVector<TaskHandle> tasks;              // Zadania bieżącego przebiegu (puste = brak analizy)
+    CancellationToken analysisToken;
+    int threadCount = 0;
+
+    QMutex mutex;                           // Chroni results
+    QHash<QString, TrackLoudness> results;
+};
@@ -0,0 +1,195 @@
+#include "loudnessmeter.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Długość bloku pomiarowego w odcinkach 100 ms (400 ms, nakładanie 75%)
+constexpr int kSegmentsPerBlock = 4;
+// Bramki: bezwzględna -70 LUFS, względna 10 LU poniżej średniej
+constexpr double kAbsoluteGateLufs = -70.0;
+constexpr double kRelativeGateLu = -10.0;
+// Nadpróbkowanie szczytu rzeczywistego: 4 fazy po 12 współczynników
+constexpr int kPhases = 4;
+constexpr int kTapsPerPhase = 12;
+
+double powerToLufs(double power)
+{
+    return -0.691 + 10.0 * std::log10(power);
+}
+
+double lufsToPower(double lufs)
+{
+    return std::pow(10.0, (lufs + 0.691) / 10.0);
+}
+
+// Współczynniki faz filtra interpolującego: sinc z oknem Blackmana, środek w 24. próbce,
+// więc faza 0 odtwarza próbki oryginalne; każda faza znormalizowana do wzmocnienia 1
+struct InterpolationTable {
+    float taps[kPhases][kTapsPerPhase];
+
+    InterpolationTable()
+    {
+        const int length = kPhases * kTapsPerPhase;
+        for (int p = 0; p < kPhases; ++p) {
+            double sum = 0.0;
+            double h[kTapsPerPhase];
+            for (int k = 0; k < kTapsPerPhase; ++k) {
+                const int m = k * kPhases + p;
+                const double x = (m - length / 2) / double(kPhases);
+                const double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+                const double window = 0.42 - 0.5 * std::cos(2.0 * M_PI * m / length)
+                                      + 0.08 * std::cos(4.0 * M_PI * m / length);
+                h[k] = sinc * window;
+                sum += h[k];
+            }
+            for (int k = 0; k < kTapsPerPhase; ++k)
+                taps[p][k] = float(h[k] / sum);
+        }
+    }
+};
+
+const InterpolationTable &interpolationTable()
+{
+    static const InterpolationTable table;
+    return table;
+}
+}
+
+LoudnessMeter::LoudnessMeter(int sampleRate, int channels)
+    : rate(std::max(1, sampleRate)),
+      channelCount(std::max(1, channels)),
+      segmentLength(std::max(1, rate / 10)),
+      oversample(rate < 96000)
+{
+    // Filtr ważący K dla dowolnej częstotliwości próbkowania (BS.1770, przeliczony z 48 kHz)
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(M_PI * f0 / rate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        shelf = { (vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                  2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+    }
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(M_PI * f0 / rate);
+        const double a0 = 1.0 + k / q + k * k;
+        highPass = { 1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+    }
+    state.assign(size_t(channelCount) * 8, 0.0);
+
+    // Wagi kanałów dla układów 5.0 i 5.1 (L R C [LFE] Ls Rs); pozostałe kanały z wagą 1
+    weights.assign(channelCount, 1.0);
+    if (channelCount == 5) {
+        weights[3] = weights[4] = 1.41;
+    } else if (channelCount == 6) {
+        weights[3] = 0.0;
+        weights[4] = weights[5] = 1.41;
+    }
+
+    // Historia podwojona, żeby okno filtra było zawsze ciągłe (bez modulo w pętli)
+    history.assign(size_t(channelCount) * kTapsPerPhase * 2, 0.0f);
+}
+
+void LoudnessMeter::addFrames(const float *samples, int frames)
+{
+    const InterpolationTable &table = interpolationTable();
+
+    for (int f = 0; f < frames; ++f) {
+        const float *frame = samples + size_t(f) * channelCount;
+        double energy = 0.0;
+
+        for (int c = 0; c < channelCount; ++c) {
+            const float x = frame[c];
+
+            // Dwa biquady w postaci bezpośredniej I
+            double *s = state.data() + c * 8;
+            const double y1 = shelf.b0 * x + shelf.b1 * s[0] + shelf.b2 * s[1] - shelf.a1 * s[2] - shelf.a2 * s[3];
+            s[1] = s[0];
+            s[0] = x;
+            s[3] = s[2];
+            s[2] = y1;
+            const double y2 = highPass.b0 * y1 + highPass.b1 * s[4] + highPass.b2 * s[5]
+                              - highPass.a1 * s[6] - highPass.a2 * s[7];
+            s[5] = s[4];
+            s[4] = y1;
+            s[7] = s[6];
+            s[6] = y2;
+            energy += weights[c] * y2 * y2;
+
+            // Szczyt rzeczywisty
+            if (oversample) {
+                float *h = history.data() + c * kTapsPerPhase * 2;
+                h[historyPos] = h[historyPos + kTapsPerPhase] = x;
+                // Najnowsza próbka na końcu okna, najstarsza na początku
+                const float *window = h + historyPos + 1;
+                for (int p = 0; p < kPhases; ++p) {
+                    float y = 0.0f;
+                    for (int k = 0; k < kTapsPerPhase; ++k)
+                        y += table.taps[p][k] * window[kTapsPerPhase - 1 - k];
+                    peak = std::max(peak, std::fabs(y));
+                }
+            } else {
+                peak = std::max(peak, std::fabs(x));
+            }
+        }
+        if (oversample)
+            historyPos = (historyPos + 1) % kTapsPerPhase;
+
+        segmentEnergy += energy;
+        if (++segmentFill == segmentLength)
+            finishSegment();
+    }
+    framesSeen += frames;
+}
+
+void LoudnessMeter::finishSegment()
+{
+    segments.push_back(segmentEnergy / segmentLength);
+    segmentEnergy = 0.0;
+    segmentFill = 0;
+    if (int(segments.size()) > kSegmentsPerBlock)
+        segments.erase(segments.begin());
+    if (int(segments.size()) == kSegmentsPerBlock) {
+        double sum = 0.0;
+        for (double segment : segments)
+            sum += segment;
+        blockPowers.push_back(sum / kSegmentsPerBlock);
+    }
+}
+
+double LoudnessMeter::integratedLoudness() const
+{
+    const double absoluteGate = lufsToPower(kAbsoluteGateLufs);
+    double sum = 0.0;
+    int count = 0;
+    for (double power : blockPowers) {
+        if (power > absoluteGate) {
+            sum += power;
+            ++count;
+        }
+    }
+    if (count == 0)
+        return -std::numeric_limits<double>::infinity();
+
+    const double gate = std::max(absoluteGate, sum / count * std::pow(10.0, kRelativeGateLu / 10.0));
+    sum = 0.0;
+    count = 0;
+    for (double power : blockPowers) {
+        if (power > gate) {
+            sum += power;
+            ++count;
+        }
+    }
+    return count > 0 ? powerToLufs(sum / count) : -std::numeric_limits<double>::infinity();
+}
+
+double LoudnessMeter::truePeak() const
+{
+    return peak > 0.0f ? 20.0 * std::log10(double(peak)) : -std::numeric_limits<double>::infinity();
+}
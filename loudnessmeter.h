@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+// Pomiar głośności według EBU R128 / ITU-R BS.1770 (bez zależności od Qt Multimedia,
+// żeby dało się go mierzyć osobno w benchmarku).
+// Próbki przechodzą przez filtr ważący K (półka + górnoprzepustowy, dwa biquady na kanał),
+// a energia jest zbierana w blokach 400 ms przesuwanych co 100 ms. Głośność zintegrowana
+// to średnia bloków po bramce bezwzględnej (-70 LUFS) i względnej (-10 LU).
+// Szczyt rzeczywisty (true peak) jest liczony z sygnału nadpróbkowanego 4× filtrem
+// interpolującym o 48 współczynnikach (12 na fazę).
+class LoudnessMeter {
+public:
+    LoudnessMeter(int sampleRate, int channels);
+
+    // Próbki przeplecione (kanał po kanale w każdej ramce), zakres -1..1
+    void addFrames(const float *samples, int frames);
+
+    // Głośność zintegrowana w LUFS (-HUGE_VAL, gdy za mało sygnału ponad bramką)
+    double integratedLoudness() const;
+    // Szczyt rzeczywisty w dBTP
+    double truePeak() const;
+
+    // Czas przeanalizowanego dźwięku
+    double seconds() const { return double(framesSeen) / rate; }
+
+private:
+    struct Biquad {
+        double b0, b1, b2, a1, a2;
+    };
+
+    void finishSegment();
+
+    int rate;
+    int channelCount;
+    Biquad shelf;
+    Biquad highPass;
+    std::vector<double> state;          // Stan obu filtrów: 4 wartości na filtr i kanał
+    std::vector<double> weights;        // Wagi kanałów (LFE pomijany, kanały tylne 1,41)
+
+    // Energia bieżącego odcinka 100 ms i gotowe odcinki/bloki
+    int segmentLength;
+    int segmentFill = 0;
+    double segmentEnergy = 0.0;
+    std::vector<double> segments;       // Ostatnie 4 odcinki (blok 400 ms)
+    std::vector<double> blockPowers;    // Średnia ważona moc każdego bloku
+    long long framesSeen = 0;
+
+    // Szczyt rzeczywisty: ostatnie próbki każdego kanału dla filtra interpolującego
+    bool oversample;
+    std::vector<float> history;
+    int historyPos = 0;
+    float peak = 0.0f;
+};
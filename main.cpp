@@ -1,16 +1,45 @@
 #include <iostream>         
 #include <QApplication>      
 #include "mainwindow.h"      
+#include "batchrenderer.h"
+#include "tracing.h"
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <cstdio>
+#endif
 
 int main(int argc, char *argv[]) {
+    // Tryb wsadowy (--batch-render): rendery stron PDF i obrazów bez okna, wyniki na stdout
+    if (BatchRenderer::isBatchCommand(argc, argv)) {
+#ifdef Q_OS_WIN
+        // Program okienkowy nie ma konsoli — wyjście do konsoli, z której go uruchomiono
+        if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+            freopen("CONOUT$", "w", stdout);
+            freopen("CONOUT$", "w", stderr);
+        }
+#endif
+        if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        QGuiApplication app(argc, argv);
+        return BatchRenderer::runCommandLine(app.arguments());
+    }
+
     qputenv("QT_MEDIA_BACKEND", "ffmpeg");  // Wymusza użycie FFmpeg jako backendu multimediów
     qputenv("QT_FFMPEG_HW", "0");           // Wyłącza sprzętowe przyspieszenie dekodowania
 
     QApplication app(argc, argv);           // Tworzenie aplikacji
 
+    // LIBRARY_TRACE=<plik.json>: śledzenie od startu, zapis śladu przy zamknięciu
+    const QString tracePath = qEnvironmentVariable("LIBRARY_TRACE");
+    if (!tracePath.isEmpty())
+        Tracing::setEnabled(true);
+
     MainWindow window;                      // Tworzenie głownego okna
     window.setWindowTitle("Multimedia Library Menu");  
     window.showMaximized();                            // Pokazuje okno w trybie pełnoekranowym
 
-    return app.exec();                      // Uruchamia główną pętlę zdarzeń aplikacji
+    const int result = app.exec();          // Uruchamia główną pętlę zdarzeń aplikacji
+    if (!tracePath.isEmpty() && Tracing::isEnabled())
+        Tracing::exportChromeTrace(tracePath);
+    return result;
 }
@@ -1,5 +1,9 @@
 #include "mainwindow.h"
 #include "gesture_server.h"
+#include "uiupdatescheduler.h"
+#include "taskscheduler.h"
+#include "iconcache.h"
+#include "tracing.h"
 #include <QFileDialog>
 #include <QDebug>
 #include <QLabel>
@@ -9,14 +13,25 @@
 #include <QMessageBox>
 #include <QCloseEvent>
 #include <QProcess>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QShortcut>
+#include <QDir>
 #include <filesystem>
 #include <stdexcept>
 
+namespace {
+// Odstęp między zbiorczymi wpisami wyjścia kamery w logu
+constexpr int kCameraLogIntervalMs = 500;
+// Po tylu ms od pokazania menu strony są budowane w tle (po jednej na obieg pętli zdarzeń)
+constexpr int kPageWarmUpDelayMs = 1500;
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
 {
     setWindowTitle("Multimedia Library");
-    setWindowIcon(QIcon("./icons/app_icon.png"));
+    setWindowIcon(IconCache::icon("app_icon.png"));
 
     stack = new QStackedWidget(this);
     setCentralWidget(stack);
@@ -60,113 +75,188 @@ MainWindow::MainWindow(QWidget *parent)
     mainLayout->addLayout(grid);
     menuPage->setLayout(mainLayout);
 
-    mediaPlayerPage = new MediaPlayer(this);
-    textViewerPage = new TextViewer(this);
-    imageViewerPage = new ImageViewer({}, this);
+    // Strony są budowane przy pierwszym otwarciu albo w tle po pokazaniu menu (warmUpPages)
 
     gestureServer = new GestureServer(this);
 
-    connect(gestureServer, &GestureServer::gestureReceived, this, [=](const QString &cmd) {
-        QWidget *current = stack->currentWidget();
-
-        if (stack->currentWidget() == menuPage) {
-            if (cmd == "open_media") {
-                openMediaPlayer();
-                return;
-            } else if (cmd == "open_text") {
-                openTextReader();
-                return;
-            } else if (cmd == "open_image") {
-                openImageViewer();
-                return;
-            } else if (cmd == "open_camera") {
-                openCamera();
-                return;
-            }
-        }
-
-        if (auto tv = qobject_cast<TextViewer *>(current)) {
-            if (cmd == "next") {
-                tv->nextPage();
-            } else if (cmd == "prev") {
-                tv->prevPage();
-            } else if (cmd == "go_menu") {
-                goBackToMenu();
-            }
-        }
-
-        if (auto mp = qobject_cast<MediaPlayer *>(current)) {
-            if (cmd == "toggle_play_pause") {
-                mp->togglePlayPause();
-            } else if (cmd == "fast_forward") {
-                mp->fastForward();
-            } else if (cmd == "rewind") {
-                mp->rewind();
-            } else if (cmd == "next_track") {
-                mp->nextTrack();
-            } else if (cmd == "prev_track") {
-                mp->previousTrack();
-            } else if (cmd == "volume_up") {
-                mp->increaseVolume();
-            } else if (cmd == "volume_down") {
-                mp->decreaseVolume();
-            } else if (cmd == "go_menu") {
-                goBackToMenu();
-            }
-        }
-
-        if (auto iv = qobject_cast<ImageViewer *>(current)) {
-            if (cmd == "pan_left") {
-                iv->panImage(-50, 0);
-            } else if (cmd == "pan_right") {
-                iv->panImage(50, 0);
-            } else if (cmd == "pan_up") {
-                iv->panImage(0, -50);
-            } else if (cmd == "pan_down") {
-                iv->panImage(0, 50);
-            } else if (cmd == "zoom_in") {
-                iv->zoomInAtCenter();
-            } else if (cmd == "zoom_out") {
-                iv->zoomOutAtCenter();
-            } else if (cmd == "go_menu") {
-                goBackToMenu();
-            }
-        }
-    });
+    connect(gestureServer, &GestureServer::gestureReceived, this, &MainWindow::handleGesture);
 
-    connect(textViewerPage, &TextViewer::backToMenuRequested, this, &MainWindow::goBackToMenu);
-    connect(mediaPlayerPage, &MediaPlayer::backToMenuRequested, this, &MainWindow::goBackToMenu);
-    connect(imageViewerPage, &ImageViewer::returnToMainMenuClicked, this, &MainWindow::goBackToMenu);
+    // Śledzenie włączane i wyłączane w trakcie działania; po wyłączeniu zapis do pliku
+    QShortcut *traceShortcut = new QShortcut(QKeySequence("Ctrl+Shift+T"), this);
+    traceShortcut->setContext(Qt::ApplicationShortcut);
+    connect(traceShortcut, &QShortcut::activated, this, &MainWindow::toggleTracing);
 
     stack->addWidget(menuPage);
-    stack->addWidget(mediaPlayerPage);
-    stack->addWidget(textViewerPage);
-    stack->addWidget(imageViewerPage);
     stack->setCurrentWidget(menuPage);
 
+    cameraLogUpdate = UiUpdateScheduler::instance().add(this, [this]() { flushCameraOutput(); }, kCameraLogIntervalMs);
+
     connect(mediaButton, &QPushButton::clicked, this, &MainWindow::openMediaPlayer);
     connect(textButton, &QPushButton::clicked, this, &MainWindow::openTextReader);
     connect(imageButton, &QPushButton::clicked, this, &MainWindow::openImageViewer);
     connect(cameraButton, &QPushButton::clicked, this, &MainWindow::openCamera);
+
+    QTimer::singleShot(kPageWarmUpDelayMs, this, &MainWindow::warmUpPages);
 }
 
 MainWindow::~MainWindow() {
     terminateCameraProcess();
 }
 
+// Komenda gestu dla bieżącej strony (menu albo otwarta strona)
+void MainWindow::handleGesture(const QString &cmd) {
+    TRACE_SCOPE_INFO("gesture.dispatch", cmd);
+    QWidget *current = stack->currentWidget();
+
+    if (stack->currentWidget() == menuPage) {
+        if (cmd == "open_media") {
+            openMediaPlayer();
+            return;
+        } else if (cmd == "open_text") {
+            openTextReader();
+            return;
+        } else if (cmd == "open_image") {
+            openImageViewer();
+            return;
+        } else if (cmd == "open_camera") {
+            openCamera();
+            return;
+        }
+    }
+
+    if (auto tv = qobject_cast<TextViewer *>(current)) {
+        if (cmd == "next") {
+            tv->nextPage();
+        } else if (cmd == "prev") {
+            tv->prevPage();
+        } else if (cmd == "zoom_in") {
+            tv->zoomIn();
+        } else if (cmd == "zoom_out") {
+            tv->zoomOut();
+        } else if (cmd == "go_menu") {
+            goBackToMenu();
+        }
+    }
+
+    if (auto mp = qobject_cast<MediaPlayer *>(current)) {
+        if (cmd == "toggle_play_pause") {
+            mp->togglePlayPause();
+        } else if (cmd == "fast_forward") {
+            mp->fastForward();
+        } else if (cmd == "rewind") {
+            mp->rewind();
+        } else if (cmd == "step_forward") {
+            mp->stepForward();
+        } else if (cmd == "step_back") {
+            mp->stepBackward();
+        } else if (cmd == "next_track") {
+            mp->nextTrack();
+        } else if (cmd == "prev_track") {
+            mp->previousTrack();
+        } else if (cmd == "volume_up") {
+            mp->increaseVolume();
+        } else if (cmd == "volume_down") {
+            mp->decreaseVolume();
+        } else if (cmd == "go_menu") {
+            goBackToMenu();
+        }
+    }
+
+    if (auto iv = qobject_cast<ImageViewer *>(current)) {
+        if (cmd == "pan_left") {
+            iv->panImage(-50, 0);
+        } else if (cmd == "pan_right") {
+            iv->panImage(50, 0);
+        } else if (cmd == "pan_up") {
+            iv->panImage(0, -50);
+        } else if (cmd == "pan_down") {
+            iv->panImage(0, 50);
+        } else if (cmd == "zoom_in") {
+            iv->zoomInAtCenter();
+        } else if (cmd == "zoom_out") {
+            iv->zoomOutAtCenter();
+        } else if (cmd == "go_menu") {
+            goBackToMenu();
+        }
+    }
+}
+
+void MainWindow::setPageWarmUpEnabled(bool enabled) {
+    pageWarmUp = enabled;
+}
+
+// Strony budowane przy pierwszym użyciu; czas budowy trafia do logu
+MediaPlayer *MainWindow::ensureMediaPlayer() {
+    if (!mediaPlayerPage) {
+        TRACE_SCOPE_INFO("page.construct", "media");
+        QElapsedTimer timer;
+        timer.start();
+        mediaPlayerPage = new MediaPlayer(this);
+        connect(mediaPlayerPage, &MediaPlayer::backToMenuRequested, this, &MainWindow::goBackToMenu);
+        stack->addWidget(mediaPlayerPage);
+        qDebug().noquote() << QString("[startup] page=media construct_ms=%1").arg(timer.elapsed());
+    }
+    return mediaPlayerPage;
+}
+
+TextViewer *MainWindow::ensureTextViewer() {
+    if (!textViewerPage) {
+        TRACE_SCOPE_INFO("page.construct", "text");
+        QElapsedTimer timer;
+        timer.start();
+        textViewerPage = new TextViewer(this);
+        connect(textViewerPage, &TextViewer::backToMenuRequested, this, &MainWindow::goBackToMenu);
+        stack->addWidget(textViewerPage);
+        qDebug().noquote() << QString("[startup] page=text construct_ms=%1").arg(timer.elapsed());
+    }
+    return textViewerPage;
+}
+
+ImageViewer *MainWindow::ensureImageViewer() {
+    if (!imageViewerPage) {
+        TRACE_SCOPE_INFO("page.construct", "image");
+        QElapsedTimer timer;
+        timer.start();
+        imageViewerPage = new ImageViewer({}, this);
+        connect(imageViewerPage, &ImageViewer::returnToMainMenuClicked, this, &MainWindow::goBackToMenu);
+        stack->addWidget(imageViewerPage);
+        qDebug().noquote() << QString("[startup] page=image construct_ms=%1").arg(timer.elapsed());
+    }
+    return imageViewerPage;
+}
+
+// Budowa brakujących stron w tle: jedna na obieg pętli zdarzeń, żeby menu reagowało
+// między nimi; odtwarzacz (urządzenia audio, QMediaPlayer) na końcu
+void MainWindow::warmUpPages() {
+    if (!pageWarmUp)
+        return;
+    if (!textViewerPage)
+        ensureTextViewer();
+    else if (!imageViewerPage)
+        ensureImageViewer();
+    else if (!mediaPlayerPage)
+        ensureMediaPlayer();
+    else
+        return;
+    QTimer::singleShot(0, this, &MainWindow::warmUpPages);
+}
+
 void MainWindow::openMediaPlayer() {
+    TRACE_SCOPE_INFO("page.switch", "media");
     qDebug() << "Switching to Media Player...";
-    stack->setCurrentWidget(mediaPlayerPage);
+    stack->setCurrentWidget(ensureMediaPlayer());
 }
 
 void MainWindow::openTextReader() {
+    TRACE_SCOPE_INFO("page.switch", "text");
     qDebug() << "Switching to Text Viewer...";
-    stack->setCurrentWidget(textViewerPage);
+    stack->setCurrentWidget(ensureTextViewer());
 }
 
 void MainWindow::openImageViewer() {
+    TRACE_SCOPE_INFO("page.switch", "image");
     qDebug() << "Opening Image Viewer...";
-    stack->setCurrentWidget(imageViewerPage);
+    stack->setCurrentWidget(ensureImageViewer());
 }
 
 void MainWindow::openCamera() {
@@ -184,10 +274,11 @@ void MainWindow::openCamera() {
             cameraProcess->setProcessChannelMode(QProcess::MergedChannels);
             cameraProcess->setReadChannel(QProcess::StandardOutput);
 
+            // Wyjście kamery jest zbierane i trafia do logu zbiorczo, nie przy każdym fragmencie
             connect(cameraProcess, &QProcess::readyRead, this, [this]() {
                 if (cameraProcess) {
-                    QByteArray output = cameraProcess->readAllStandardOutput();
-                    qDebug() << "[GESTURE]" << output;
+                    cameraOutput += cameraProcess->readAllStandardOutput();
+                    UiUpdateScheduler::instance().markDirty(cameraLogUpdate);
                 }
             });
 
@@ -213,10 +304,46 @@ void MainWindow::openCamera() {
     }
 }
 
+// Pełne wiersze wyjścia kamery w jednym wpisie logu
+void MainWindow::flushCameraOutput() {
+    const int end = cameraOutput.lastIndexOf('\n');
+    if (end < 0)
+        return;
+    const QByteArray lines = cameraOutput.left(end);
+    cameraOutput.remove(0, end + 1);
+    qDebug().noquote() << "[GESTURE]" << QString::fromLocal8Bit(lines).trimmed();
+}
+
 void MainWindow::goBackToMenu() {
+    TRACE_SCOPE_INFO("page.switch", "menu");
+
+    // Praca w tle dla opuszczanej strony jest już nieaktualna (przycisk powrotu albo gest go_menu)
+    QWidget *current = stack->currentWidget();
+    if (auto tv = qobject_cast<TextViewer *>(current))
+        tv->cancelLoad();
+    else if (auto iv = qobject_cast<ImageViewer *>(current))
+        iv->cancelLoad();
+    else if (auto mp = qobject_cast<MediaPlayer *>(current))
+        mp->cancelPreviewWork();
+
     stack->setCurrentWidget(menuPage);
 }
 
+void MainWindow::toggleTracing() {
+    const bool enable = !Tracing::isEnabled();
+    Tracing::setEnabled(enable);
+    UiUpdateScheduler::instance().updateStatsLogging();     // Statystyki w logu razem ze śledzeniem
+    TaskScheduler::instance().updateStatsLogging();
+    if (enable)
+        return;
+
+    QString fileName = QFileDialog::getSaveFileName(this, "Save Trace",
+                                                    QDir::homePath() + "/library-trace.json",
+                                                    "Chrome trace (*.json)");
+    if (!fileName.isEmpty() && !Tracing::exportChromeTrace(fileName))
+        QMessageBox::warning(this, "Save Trace", "Cannot write " + fileName);
+}
+
 void MainWindow::closeEvent(QCloseEvent *event) {
     qDebug() << "MainWindow is closing.";
     terminateCameraProcess();
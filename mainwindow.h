@@ -18,6 +18,13 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Budowa nieotwartych stron w tle po pokazaniu menu (domyślnie włączona;
+    // benchmark startu wyłącza ją, żeby zmierzyć pierwsze otwarcie każdej strony)
+    void setPageWarmUpEnabled(bool enabled);
+
+    // Wykonanie komendy gestu (np. "next", "zoom_in") na bieżącej stronie
+    void handleGesture(const QString &cmd);
+
 protected:
     void closeEvent(QCloseEvent *event) override;
 
@@ -27,14 +34,22 @@ private slots:
     void openImageViewer();
     void openCamera();
     void goBackToMenu(); 
+    void toggleTracing();   // Ctrl+Shift+T: start śledzenia / stop i zapis śladu
 
 private:
     QStackedWidget *stack; // stos stron
 
     QWidget *menuPage;
-    MediaPlayer *mediaPlayerPage;
-    TextViewer *textViewerPage;
-    ImageViewer *imageViewerPage;
+    // Strony tworzone przy pierwszym użyciu (nullptr do tego czasu)
+    MediaPlayer *mediaPlayerPage = nullptr;
+    TextViewer *textViewerPage = nullptr;
+    ImageViewer *imageViewerPage = nullptr;
+    bool pageWarmUp = true;
+
+    MediaPlayer *ensureMediaPlayer();
+    TextViewer *ensureTextViewer();
+    ImageViewer *ensureImageViewer();
+    void warmUpPages();
 
     QPushButton *mediaButton;
     QPushButton *textButton;
@@ -43,8 +58,11 @@ private:
 
     QProcess *cameraProcess = nullptr;
     bool cameraRunning = false;
+    QByteArray cameraOutput;     // Wyjście kamery czekające na wpis do logu
+    int cameraLogUpdate = -1;
 
     GestureServer *gestureServer; // pole do serwera gestów
     void terminateCameraProcess();
     void forceKillGestureClient();
+    void flushCameraOutput();
 };    
\ No newline at end of file
@@ -0,0 +1,395 @@
+#include "medialibrary.h"
+#include "cacheutils.h"
+#include "playlistmodel.h"      // Rozpoznawanie plików multimedialnych po rozszerzeniu
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QMediaPlayer>
+#include <QMediaMetaData>
+#include <QMediaFormat>
+#include <QUrl>
+#include <QDebug>
+
+namespace {
+// Zadania czytające metadane (każde otwiera pliki własnym QMediaPlayer)
+constexpr int kMaxProbeTasks = 4;
+// Limit czasu na wczytanie jednego pliku (uszkodzone pliki nie blokują skanowania)
+constexpr int kProbeTimeoutMs = 5000;
+// Co tyle czekanie na plik sprawdza anulowanie (cancelScan() czeka na skanowanie w wątku GUI)
+constexpr int kCancelPollMs = 50;
+// Odstęp między sygnałami postępu
+constexpr int kProgressIntervalMs = 100;
+// Pojemność pamięci nazw wyświetlanych na playliście
+constexpr int kTitleCacheSize = 4096;
+
+QSqlDatabase openConnection(const QString &path, const QString &name)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", name);
+    db.setDatabaseName(path);
+    if (!db.open()) {
+        qDebug() << "MediaLibrary: cannot open database" << path << db.lastError().text();
+        return db;
+    }
+
+    // WAL: zapytania z wątku GUI nie czekają na zapis wyników skanowania
+    QSqlQuery pragma(db);
+    pragma.exec("PRAGMA journal_mode=WAL");
+    pragma.exec("PRAGMA synchronous=NORMAL");
+    pragma.exec("PRAGMA busy_timeout=5000");
+    return db;
+}
+
+QString sortColumn(LibraryField field)
+{
+    switch (field) {
+    case LibraryField::Title:    return "title COLLATE NOCASE";
+    case LibraryField::Artist:   return "artist COLLATE NOCASE";
+    case LibraryField::Album:    return "album COLLATE NOCASE";
+    case LibraryField::Duration: return "duration";
+    case LibraryField::Codec:    return "codec COLLATE NOCASE";
+    case LibraryField::Path:     return "path";
+    }
+    return "path";
+}
+
+// Znaki specjalne LIKE w tekście filtra traktujemy dosłownie
+QString likePattern(const QString &filter)
+{
+    QString escaped = filter;
+    escaped.replace('\\', "\\\\").replace('%', "\\%").replace('_', "\\_");
+    return '%' + escaped + '%';
+}
+}
+
+QString LibraryTrack::displayTitle() const
+{
+    if (title.isEmpty())
+        return QString();
+    return artist.isEmpty() ? title : artist + " – " + title;
+}
+
+MediaLibrary::MediaLibrary(const QString &path, QObject *parent)
+    : QObject(parent),
+      databasePath(path.isEmpty() ? CacheUtils::cacheDir("library") + "/library.sqlite" : path),
+      connectionName(QString("MediaLibrary-%1").arg(quintptr(this))),
+      titleCache(kTitleCacheSize)
+{
+    QSqlDatabase db = openConnection(databasePath, connectionName);
+    open = db.isOpen();
+    if (open) {
+        QSqlQuery schema(db);
+        schema.exec("CREATE TABLE IF NOT EXISTS roots(path TEXT PRIMARY KEY)");
+        schema.exec("CREATE TABLE IF NOT EXISTS tracks("
+                    "path TEXT PRIMARY KEY, size INTEGER, mtime INTEGER, duration INTEGER, "
+                    "codec TEXT, title TEXT, artist TEXT, album TEXT)");
+        // Indeks dla każdego pola sortowania — ORDER BY czyta indeks zamiast sortować tabelę
+        schema.exec("CREATE INDEX IF NOT EXISTS tracks_title ON tracks(title COLLATE NOCASE)");
+        schema.exec("CREATE INDEX IF NOT EXISTS tracks_artist ON tracks(artist COLLATE NOCASE)");
+        schema.exec("CREATE INDEX IF NOT EXISTS tracks_album ON tracks(album COLLATE NOCASE)");
+        schema.exec("CREATE INDEX IF NOT EXISTS tracks_duration ON tracks(duration)");
+        schema.exec("CREATE INDEX IF NOT EXISTS tracks_codec ON tracks(codec COLLATE NOCASE)");
+    }
+
+    // Nazwy utworów mogły się zmienić (połączenie kolejkowe — wątek GUI)
+    connect(this, &MediaLibrary::scanFinished, this, [this]() { titleCache.clear(); });
+}
+
+MediaLibrary::~MediaLibrary()
+{
+    cancelScan();
+    QSqlDatabase::database(connectionName, false).close();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+QStringList MediaLibrary::directories() const
+{
+    QStringList result;
+    QSqlQuery query(QSqlDatabase::database(connectionName, false));
+    if (query.exec("SELECT path FROM roots ORDER BY path")) {
+        while (query.next())
+            result.append(query.value(0).toString());
+    }
+    return result;
+}
+
+void MediaLibrary::setDirectories(const QStringList &directories)
+{
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+    db.transaction();
+    QSqlQuery query(db);
+    query.exec("DELETE FROM roots");
+    query.prepare("INSERT OR IGNORE INTO roots(path) VALUES(?)");
+    for (const QString &directory : directories) {
+        query.addBindValue(QDir::cleanPath(directory));
+        query.exec();
+    }
+    db.commit();
+}
+
+int MediaLibrary::trackCount() const
+{
+    QSqlQuery query(QSqlDatabase::database(connectionName, false));
+    if (query.exec("SELECT COUNT(*) FROM tracks") && query.next())
+        return query.value(0).toInt();
+    return 0;
+}
+
+QVector<LibraryTrack> MediaLibrary::query(const QString &filter, LibraryField sortBy, Qt::SortOrder order) const
+{
+    QString sql = "SELECT path, duration, codec, title, artist, album FROM tracks";
+    if (!filter.isEmpty()) {
+        sql += " WHERE title LIKE :f ESCAPE '\\' OR artist LIKE :f ESCAPE '\\'"
+               " OR album LIKE :f ESCAPE '\\' OR path LIKE :f ESCAPE '\\'";
+    }
+    sql += " ORDER BY " + sortColumn(sortBy) + (order == Qt::AscendingOrder ? " ASC" : " DESC") + ", path";
+
+    QVector<LibraryTrack> tracks;
+    QSqlQuery query(QSqlDatabase::database(connectionName, false));
+    query.setForwardOnly(true);     // Bez buforowania wyników w pamięci sterownika
+    query.prepare(sql);
+    if (!filter.isEmpty())
+        query.bindValue(":f", likePattern(filter));
+    if (!query.exec()) {
+        qDebug() << "MediaLibrary: query failed" << query.lastError().text();
+        return tracks;
+    }
+
+    while (query.next()) {
+        LibraryTrack track;
+        track.path = query.value(0).toString();
+        track.durationMs = query.value(1).toLongLong();
+        track.codec = query.value(2).toString();
+        track.title = query.value(3).toString();
+        track.artist = query.value(4).toString();
+        track.album = query.value(5).toString();
+        tracks.append(track);
+    }
+    return tracks;
+}
+
+QStringList MediaLibrary::queryPaths(const QString &filter, LibraryField sortBy, Qt::SortOrder order) const
+{
+    QStringList paths;
+    const QVector<LibraryTrack> tracks = query(filter, sortBy, order);
+    paths.reserve(tracks.size());
+    for (const LibraryTrack &track : tracks)
+        paths.append(track.path);
+    return paths;
+}
+
+QString MediaLibrary::displayTitle(const QString &path) const
+{
+    if (const QString *cached = titleCache.object(path))
+        return *cached;
+
+    LibraryTrack track;
+    QSqlQuery query(QSqlDatabase::database(connectionName, false));
+    query.prepare("SELECT title, artist FROM tracks WHERE path = ?");
+    query.addBindValue(path);
+    if (query.exec() && query.next()) {
+        track.title = query.value(0).toString();
+        track.artist = query.value(1).toString();
+    }
+
+    const QString title = track.displayTitle();
+    titleCache.insert(path, new QString(title));
+    return title;
+}
+
+void MediaLibrary::cancelScan()
+{
+    scanTask.cancel();
+    scanTask.waitForFinished();
+    scanTask = TaskHandle();
+}
+
+void MediaLibrary::rescan()
+{
+    cancelScan();
+    if (!open)
+        return;
+
+    const QStringList roots = directories();
+    scanTask = TaskScheduler::instance().submit(TaskPriority::Background, "library.scan",
+                                                [this, roots](const CancellationToken &token) { runScan(roots, token); });
+}
+
+void MediaLibrary::runScan(const QStringList &roots, const CancellationToken &token)
+{
+    QElapsedTimer timer;
+    timer.start();
+    LibraryScanStats stats;
+
+    const QString scanConnection = connectionName + "-scan";
+    {
+        QSqlDatabase db = openConnection(databasePath, scanConnection);
+
+        // Stan z poprzedniego skanowania: ścieżka -> (rozmiar, data modyfikacji)
+        QHash<QString, QPair<qint64, qint64>> known;
+        QSqlQuery select(db);
+        select.setForwardOnly(true);
+        if (select.exec("SELECT path, size, mtime FROM tracks")) {
+            while (select.next())
+                known.insert(select.value(0).toString(), { select.value(1).toLongLong(), select.value(2).toLongLong() });
+        }
+
+        // Przejście katalogów: tylko nowe i zmienione pliki trafiają do odczytu metadanych
+        QVector<PendingFile> changed;
+        for (const QString &root : roots) {
+            QDirIterator it(root, QDir::Files | QDir::Readable, QDirIterator::Subdirectories);
+            while (it.hasNext() && !token.isCancelled()) {
+                it.next();
+                if (!PlaylistModel::isMediaFile(it.fileName()))
+                    continue;
+
+                const QFileInfo info = it.fileInfo();
+                const QString path = info.absoluteFilePath();
+                const qint64 size = info.size();
+                const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+                ++stats.files;
+
+                auto previous = known.constFind(path);
+                if (previous != known.constEnd() && previous->first == size && previous->second == mtime)
+                    ++stats.skipped;
+                else
+                    changed.append({ path, size, mtime });
+                known.remove(path);
+            }
+        }
+
+        const QVector<LibraryTrack> tracks = extractMetadata(changed, token);
+
+        // Jedna transakcja na całe skanowanie — pojedyncze INSERT-y byłyby rzędy wielkości wolniejsze
+        db.transaction();
+        QSqlQuery insert(db);
+        insert.prepare("INSERT OR REPLACE INTO tracks(path, size, mtime, duration, codec, title, artist, album) "
+                       "VALUES(?, ?, ?, ?, ?, ?, ?, ?)");
+        for (int i = 0; i < tracks.size(); ++i) {
+            const LibraryTrack &track = tracks[i];
+            if (track.path.isEmpty())   // Skanowanie przerwane przed odczytem tego pliku
+                continue;
+            insert.addBindValue(track.path);
+            insert.addBindValue(changed[i].size);
+            insert.addBindValue(changed[i].mtime);
+            insert.addBindValue(track.durationMs);
+            insert.addBindValue(track.codec);
+            insert.addBindValue(track.title);
+            insert.addBindValue(track.artist);
+            insert.addBindValue(track.album);
+            if (insert.exec())
+                ++stats.updated;
+        }
+
+        // Pliki z bazy, których nie znaleziono w katalogach (tylko po pełnym przejściu)
+        if (!token.isCancelled()) {
+            QSqlQuery remove(db);
+            remove.prepare("DELETE FROM tracks WHERE path = ?");
+            for (auto it = known.constBegin(); it != known.constEnd(); ++it) {
+                remove.addBindValue(it.key());
+                if (remove.exec())
+                    ++stats.removed;
+            }
+        }
+        db.commit();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(scanConnection);
+
+    stats.elapsedMs = timer.elapsed();
+    qDebug().noquote() << QString("[library-scan] files=%1 skipped=%2 updated=%3 removed=%4 ms=%5 files_per_sec=%6")
+                              .arg(stats.files).arg(stats.skipped).arg(stats.updated).arg(stats.removed)
+                              .arg(stats.elapsedMs).arg(stats.filesPerSecond(), 0, 'f', 1);
+    emit scanFinished(stats);
+}
+
+QVector<LibraryTrack> MediaLibrary::extractMetadata(const QVector<PendingFile> &files, const CancellationToken &token)
+{
+    QVector<LibraryTrack> tracks(files.size());
+    if (files.isEmpty())
+        return tracks;
+
+    std::atomic<int> nextFile{0};
+    std::atomic<int> processed{0};
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+    std::atomic<qint64> lastProgressMs{0};
+
+    // Każde zadanie pobiera kolejne pliki ze wspólnego licznika
+    auto probe = [&](const CancellationToken &probeToken) {
+        QMediaPlayer player;
+        QEventLoop loop;
+        QTimer timeout;
+        timeout.setSingleShot(true);
+        QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+        QObject::connect(&player, &QMediaPlayer::mediaStatusChanged, &loop, [&](QMediaPlayer::MediaStatus status) {
+            if (status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::InvalidMedia)
+                loop.quit();
+        });
+        QTimer cancelPoll;
+        QObject::connect(&cancelPoll, &QTimer::timeout, &loop, [&]() {
+            if (probeToken.isCancelled())
+                loop.quit();
+        });
+        cancelPoll.start(kCancelPollMs);
+
+        int i;
+        while (!probeToken.isCancelled() && (i = nextFile++) < files.size()) {
+            LibraryTrack &track = tracks[i];
+            track.path = files[i].path;
+
+            player.setSource(QUrl::fromLocalFile(track.path));
+            if (player.mediaStatus() == QMediaPlayer::LoadingMedia) {
+                timeout.start(kProbeTimeoutMs);
+                loop.exec();
+                timeout.stop();
+            }
+            if (probeToken.isCancelled()) {
+                // Przerwane wczytywanie — bez wpisu w bazie, plik zostanie przeczytany przy następnym skanowaniu
+                track.path.clear();
+                break;
+            }
+
+            // Pliki nieczytelne też trafiają do bazy (bez metadanych), żeby nie czytać ich ponownie
+            if (player.mediaStatus() == QMediaPlayer::LoadedMedia) {
+                const QMediaMetaData meta = player.metaData();
+                track.durationMs = player.duration();
+                track.title = meta.stringValue(QMediaMetaData::Title);
+                track.artist = meta.stringValue(QMediaMetaData::ContributingArtist);
+                if (track.artist.isEmpty())
+                    track.artist = meta.stringValue(QMediaMetaData::AlbumArtist);
+                track.album = meta.stringValue(QMediaMetaData::AlbumTitle);
+
+                QStringList codecs;
+                const QVariant video = meta.value(QMediaMetaData::VideoCodec);
+                if (video.isValid() && player.hasVideo())
+                    codecs.append(QMediaFormat::videoCodecName(video.value<QMediaFormat::VideoCodec>()));
+                const QVariant audio = meta.value(QMediaMetaData::AudioCodec);
+                if (audio.isValid() && player.hasAudio())
+                    codecs.append(QMediaFormat::audioCodecName(audio.value<QMediaFormat::AudioCodec>()));
+                track.codec = codecs.join(" / ");
+            }
+            player.setSource(QUrl());
+            const int done = ++processed;
+
+            // Postęp wysyła to zadanie, które pierwsze zauważy upływ odstępu
+            const qint64 now = progressTimer.elapsed();
+            qint64 last = lastProgressMs;
+            if (now - last >= kProgressIntervalMs && lastProgressMs.compare_exchange_strong(last, now))
+                emit scanProgress(done, int(files.size()));
+        }
+    };
+
+    // Skanowanie samo czyta pliki razem z zadaniami pomocniczymi z puli
+    const int taskCount = qBound(1, TaskScheduler::instance().workerCount() / 2, kMaxProbeTasks);
+    TaskScheduler::instance().runParallel(TaskPriority::Background, "library.probe",
+                                          qMin(taskCount, int(files.size())), probe, token);
+    emit scanProgress(processed, int(files.size()));
+    return tracks;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QObject>
+#include <QCache>
+#include <QStringList>
+#include <QVector>
+#include "taskscheduler.h"
+
+// Utwór w bibliotece: ścieżka i metadane wyciągnięte z pliku
+struct LibraryTrack {
+    QString path;
+    qint64 durationMs = 0;
+    QString codec;           // Np. "H.264 / AAC" albo "MP3"
+    QString title;
+    QString artist;
+    QString album;
+
+    // "Wykonawca – Tytuł" (albo sam tytuł); pusty, gdy plik nie ma tytułu
+    QString displayTitle() const;
+};
+
+// Pole, po którym można sortować wyniki zapytań
+enum class LibraryField {
+    Title,
+    Artist,
+    Album,
+    Duration,
+    Codec,
+    Path
+};
+
+// Wynik jednego skanowania (pełnego albo przyrostowego)
+struct LibraryScanStats {
+    int files = 0;           // Pliki multimedialne znalezione w katalogach
+    int skipped = 0;         // Bez zmian (rozmiar i data modyfikacji jak w bazie)
+    int updated = 0;         // Nowe lub zmienione — metadane wyciągnięte ponownie
+    int removed = 0;         // Usunięte z dysku (lub spoza katalogów) — usunięte z bazy
+    qint64 elapsedMs = 0;
+
+    double filesPerSecond() const { return elapsedMs > 0 ? files * 1000.0 / elapsedMs : 0.0; }
+};
+
+// Biblioteka multimediów w lokalnej bazie SQLite.
+// Skanowanie przechodzi skonfigurowane katalogi w wątku tła; metadane (czas trwania, kodek,
+// tytuł, wykonawca, album) czyta kilka wątków, każdy z własnym QMediaPlayer. Pliki o tym samym
+// rozmiarze i dacie modyfikacji co w bazie są pomijane, więc ponowne skanowanie kosztuje
+// tylko przejście katalogów. Zapytania korzystają z indeksów bazy po każdym polu sortowania.
+// Zapytania (query, displayTitle) należy wywoływać z wątku, w którym utworzono obiekt.
+class MediaLibrary : public QObject {
+    Q_OBJECT
+
+public:
+    // Pusta ścieżka = baza w katalogu pamięci podręcznej aplikacji
+    explicit MediaLibrary(const QString &databasePath = QString(), QObject *parent = nullptr);
+    ~MediaLibrary() override;
+
+    bool isOpen() const { return open; }
+
+    // Katalogi biblioteki (zapamiętywane w bazie)
+    QStringList directories() const;
+    void setDirectories(const QStringList &directories);
+
+    // Skanowanie katalogów w tle; przerywa skanowanie już trwające
+    void rescan();
+    void cancelScan();
+    bool isScanning() const { return scanTask.isValid() && !scanTask.isFinished(); }
+
+    // Utwory pasujące do filtra (tytuł, wykonawca, album lub ścieżka), posortowane po polu
+    QVector<LibraryTrack> query(const QString &filter = QString(),
+                                LibraryField sortBy = LibraryField::Title,
+                                Qt::SortOrder order = Qt::AscendingOrder) const;
+    QStringList queryPaths(const QString &filter = QString(),
+                           LibraryField sortBy = LibraryField::Title,
+                           Qt::SortOrder order = Qt::AscendingOrder) const;
+
+    // Nazwa utworu do wyświetlenia na playliście; pusta, gdy plik nie jest w bibliotece
+    QString displayTitle(const QString &path) const;
+
+    int trackCount() const;
+
+signals:
+    // Postęp wyciągania metadanych i koniec skanowania (emitowane z wątku tła)
+    void scanProgress(int processedFiles, int changedFiles);
+    void scanFinished(const LibraryScanStats &stats);
+
+private:
+    // Plik do (ponownego) odczytu metadanych
+    struct PendingFile {
+        QString path;
+        qint64 size;
+        qint64 mtime;
+    };
+
+    void runScan(const QStringList &roots, const CancellationToken &token);
+    QVector<LibraryTrack> extractMetadata(const QVector<PendingFile> &files, const CancellationToken &token);
+
+    QString databasePath;
+    QString connectionName;    // Połączenie wątku GUI (zapytania)
+    bool open = false;
+
+    TaskHandle scanTask;
+
+    // Nazwy wyświetlane na playliście — widok pyta o te same wiersze przy każdym rysowaniu
+    mutable QCache<QString, QString> titleCache;
+};
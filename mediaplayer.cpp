@@ -1,48 +1,104 @@
 #include "mediaplayer.h"
+#include "tracing.h"
 #include <QDebug>
 #include <QFileInfo>
 #include <QTimer>
+#include <QMessageBox>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QStyle>
+#include <QStandardPaths>
+#include <QMediaMetaData>
+#include <QVideoSink>
+#include <QScreen>
+
+#include "uiupdatescheduler.h"
+#include "iconcache.h"
 
 #include <QAudioFormat>      
 #include <QAudioOutput>      
 #include <QAudioDevice>      
 #include <QMediaDevices>     
 
+namespace {
+// Od tego momentu przed końcem utworu przejście jest planowane precyzyjnym zegarem
+constexpr qint64 kHandOffWindowMs = 500;
+// Górna granica wyprzedzenia startu następnego utworu
+constexpr qint64 kMaxHandOffLeadMs = 200;
+// Przewinięcie uznajemy za zakończone, gdy pozycja jest tak blisko celu albo minął limit czasu
+constexpr qint64 kSeekToleranceMs = 500;
+constexpr int kSeekSettleTimeoutMs = 300;
+// Ile utworów playlisty (od bieżącego) analizować pod kątem głośności
+constexpr int kLoudnessLookahead = 200;
+
+// Playlista zapisywana przy zamknięciu i wczytywana przy starcie
+QString autosavePlaylistPath()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dir);
+    return dir + "/playlist.qpl";
+}
+
+// Źródło pozycji playlisty: plik lokalny albo adres sieciowy z zaimportowanej playlisty
+QUrl playlistUrl(const QString &path)
+{
+    return path.contains("://") ? QUrl(path) : QUrl::fromLocalFile(path);
+}
+}
+
 MediaPlayer::MediaPlayer(QWidget *parent)
     : QWidget(parent)
 {
-    videoWidget = new QVideoWidget(this);  // Obiekt do wyświetlania obrazu wideo
-
     // Obrazek zastępczy — widoczny tylko przy odtwarzaniu plików audio
     imageLabel = new QLabel(this);
     imageLabel->setAlignment(Qt::AlignCenter);
-    QPixmap placeholder("./icons/music-notes.png");
-    imageLabel->setPixmap(placeholder.scaled(640, 360, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    imageLabel->setPixmap(IconCache::pixmap("music-notes.png", QSize(640, 360)));
     imageLabel->setVisible(false);  // Ukryty na start
 
+    // Wizualizacja dźwięku (widmo + przebieg) dla plików audio
+    audioVisualizer = new AudioVisualizer(this);
+    audioVisualizer->setVisible(false);
+
     rewindButton = new QPushButton("⏪", this);   
     playPauseButton = new QPushButton(this);     
-    playPauseButton->setIcon(QIcon("./icons/play_button_proj.png"));
+    playPauseButton->setIcon(IconCache::icon("play_button_proj.png"));
     playPauseButton->setIconSize(QSize(30, 30)); 
 
     forwardButton = new QPushButton("⏩", this);  
     playlistButton = new QPushButton("📂", this); 
     prevTrackButton = new QPushButton("⏮", this); 
     nextTrackButton = new QPushButton("⏭", this); 
+    stepBackButton = new QPushButton("◀|", this);
+    stepForwardButton = new QPushButton("|▶", this);
+    stepBackButton->setToolTip("Previous frame");
+    stepForwardButton->setToolTip("Next frame");
 
     prevTrackButton->setFlat(true);
     nextTrackButton->setFlat(true);
     rewindButton->setFlat(true);
     playPauseButton->setFlat(true);
     forwardButton->setFlat(true);
+    stepBackButton->setFlat(true);
+    stepForwardButton->setFlat(true);
     playlistButton->setFlat(true);
 
     QLabel *soundIcon = new QLabel(this);
-    QPixmap soundPixmap("./icons/volume_icon.png"); 
-    soundIcon->setPixmap(soundPixmap.scaled(20, 20, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    soundIcon->setPixmap(IconCache::pixmap("volume_icon.png", QSize(20, 20)));
 
     // Suwak - odtwarzania wideo/audio
     progressSlider = new QSlider(Qt::Horizontal, this);
+    progressSlider->setMouseTracking(true);     // Podgląd miniatury także bez wciśnięcia
+    progressSlider->installEventFilter(this);
+
+    // Podgląd klatki nad suwakiem (miniatury generowane przy pierwszym najechaniu)
+    scrubThumbnails = new ScrubThumbnailIndex(this);
+    scrubPreview = new QLabel(this);
+    scrubPreview->setStyleSheet("border: 1px solid #7080B0; background-color: black;");
+    scrubPreview->setVisible(false);
+
+    seekSettleTimer = new QTimer(this);
+    seekSettleTimer->setSingleShot(true);
+    seekSettleTimer->setInterval(kSeekSettleTimeoutMs);
 
     // Suwak głośności
     volumeSlider = new QSlider(Qt::Horizontal, this);
@@ -53,22 +109,83 @@ MediaPlayer::MediaPlayer(QWidget *parent)
     // Etykieta tekstowa, która pokazuje aktualny czas odtwarzania i całkowity czas
     timeDisplay->setAlignment(Qt::AlignRight); 
     timeDisplay->setStyleSheet("font-family: monospace; font-size: 14px;");
-    
+    positionUpdate = UiUpdateScheduler::instance().add(this, [this]() { refreshPositionDisplay(); });
+
     // Konfiguracja systemu audio
     QAudioDevice device = QMediaDevices::defaultAudioOutput();
     // Pobieranie domyślnego urządzenia wyjściowego audio
-    audioOutput = new QAudioOutput(device, this);
-    // Tworzenie obiektu audio związanego z tym urządzeniem
-    audioOutput->setVolume(1.0);
 
-    // Główny obiekt odtwarzacza multimediów
-    mediaPlayer = new QMediaPlayer(this);
+    // Dwa zestawy odtwarzacza: aktywny i przygotowujący następny utwór z playlisty
+    for (Deck &deck : decks) {
+        deck.video = new QVideoWidget(this);      // Obiekt do wyświetlania obrazu wideo
+        deck.audio = new QAudioOutput(device, this); // Obiekt audio związany z tym urządzeniem
+        deck.audio->setVolume(1.0);
+        deck.player = new QMediaPlayer(this);
+        deck.player->setVideoOutput(deck.video);  // Obraz (jeśli plik go zawiera)
+        deck.player->setAudioOutput(deck.audio);  // Dźwięk
+    }
+    mediaPlayer = decks[activeDeck].player;
+    audioOutput = decks[activeDeck].audio;
+    videoWidget = decks[activeDeck].video;
+
+    // Precyzyjny zegar przejścia do następnego utworu
+    handOffTimer = new QTimer(this);
+    handOffTimer->setSingleShot(true);
+    handOffTimer->setTimerType(Qt::PreciseTimer);
+    gapClock.start();
+
+    // Głośność utworów analizowana w tle; wynik wyrównuje głośność przy zmianie utworu
+    loudness = new LoudnessAnalyzer(this);
+    loudnessTimer = new QTimer(this);
+    loudnessTimer->setSingleShot(true);
+    loudnessTimer->setInterval(1000);
 
-    // Przypisanie widżetu wideo do odtwarzacza (jeśli plik zawiera obraz)
-    mediaPlayer->setVideoOutput(videoWidget);
+    // Telemetria: klatki z sinka widoku wideo aktywnego zestawu (widok dalej je wyświetla)
+    telemetry = new PlaybackTelemetry(this);
+    telemetry->attach(mediaPlayer, videoWidget->videoSink());
+    audioVisualizer->attach(mediaPlayer);
 
-    // Przypisanie wyjściowego dźwięku do odtwarzacza
-    mediaPlayer->setAudioOutput(audioOutput);
+    // Prędkość odtwarzania: rozciąganie czasu dźwięku między dekodowaniem a wyjściem audio
+    speedStage = new PlaybackSpeedStage(this);
+    speedStage->attach(mediaPlayer, audioOutput, audioVisualizer->audioBufferOutput());
+    speedBox = new QComboBox(this);
+    for (double speed : { 0.5, 0.75, 1.0, 1.25, 1.5, 1.75, 2.0, 2.5, 3.0 })
+        speedBox->addItem(QString::number(speed) + "×", speed);
+    speedBox->setCurrentIndex(speedBox->findData(1.0));
+    speedBox->setToolTip("Playback speed");
+    connect(speedBox, &QComboBox::currentIndexChanged, this, [=]() {
+        speedStage->setSpeed(speedBox->currentData().toDouble());
+    });
+
+    // Nakładka z wynikami nad obrazem (domyślnie ukryta)
+    telemetryOverlay = new QFrame(this);
+    telemetryOverlay->setStyleSheet("background-color: rgba(0, 0, 0, 170); color: #7CFC9A; border-radius: 4px;");
+    telemetryLabel = new QLabel(telemetryOverlay);
+    telemetryLabel->setStyleSheet("font-family: monospace; font-size: 12px; background: transparent;");
+    QPushButton *exportTelemetryButton = new QPushButton("Export…", telemetryOverlay);
+    exportTelemetryButton->setFlat(true);
+    QVBoxLayout *overlayLayout = new QVBoxLayout(telemetryOverlay);
+    overlayLayout->addWidget(telemetryLabel);
+    overlayLayout->addWidget(exportTelemetryButton, 0, Qt::AlignRight);
+    telemetryOverlay->setVisible(false);
+
+    telemetryButton = new QPushButton("📊", this);
+    telemetryButton->setFlat(true);
+    telemetryButton->setCheckable(true);
+    telemetryButton->setToolTip("Playback telemetry");
+
+    connect(telemetryButton, &QPushButton::toggled, this, [=](bool checked) {
+        telemetryOverlay->setVisible(checked);
+        updateTelemetryOverlay();
+    });
+    connect(telemetry, &PlaybackTelemetry::sampled, this, &MediaPlayer::updateTelemetryOverlay);
+    connect(exportTelemetryButton, &QPushButton::clicked, this, [=]() {
+        QString fileName = QFileDialog::getSaveFileName(this, "Export Telemetry",
+                                                        QDir::homePath() + "/playback-telemetry.json",
+                                                        "JSON (*.json)");
+        if (!fileName.isEmpty() && !telemetry->exportSessions(fileName))
+            QMessageBox::warning(this, "Export Telemetry", "Cannot write " + fileName);
+    });
 
     // Panel boczny z playlistą (na początku ukryty)
     playlistPanel = new QFrame(this);
@@ -90,6 +207,21 @@ MediaPlayer::MediaPlayer(QWidget *parent)
     removeFromPlaylistButton->setFixedSize(24, 24);
     removeFromPlaylistButton->setFlat(true);
 
+    importFolderButton = new QPushButton("📁", playlistPanel);
+    importFolderButton->setFixedSize(24, 24);
+    importFolderButton->setFlat(true);
+    importFolderButton->setToolTip("Import folder");
+
+    openPlaylistButton = new QPushButton("📃", playlistPanel);
+    openPlaylistButton->setFixedSize(24, 24);
+    openPlaylistButton->setFlat(true);
+    openPlaylistButton->setToolTip("Open playlist");
+
+    savePlaylistButton = new QPushButton("💾", playlistPanel);
+    savePlaylistButton->setFixedSize(24, 24);
+    savePlaylistButton->setFlat(true);
+    savePlaylistButton->setToolTip("Save playlist");
+
     // Przycisk powrotu do menu głównego
     QPushButton *backButton = new QPushButton("Back to Menu", this);
     backButton->setFixedSize(100, 30);
@@ -103,14 +235,62 @@ MediaPlayer::MediaPlayer(QWidget *parent)
     playlistHeader->addStretch();
     playlistHeader->addWidget(removeFromPlaylistButton);
     playlistHeader->addWidget(addToPlaylistButton);
+    playlistHeader->addWidget(importFolderButton);
+    playlistHeader->addWidget(openPlaylistButton);
+    playlistHeader->addWidget(savePlaylistButton);
+
+    // Biblioteka: wyszukiwanie, pole sortowania, dodanie folderu biblioteki, ponowne skanowanie
+    library = new MediaLibrary(QString(), this);
+
+    librarySearch = new QLineEdit(playlistPanel);
+    librarySearch->setPlaceholderText("Search library");
+    librarySearch->setClearButtonEnabled(true);
+
+    librarySort = new QComboBox(playlistPanel);
+    librarySort->addItem("Title", int(LibraryField::Title));
+    librarySort->addItem("Artist", int(LibraryField::Artist));
+    librarySort->addItem("Album", int(LibraryField::Album));
+    librarySort->addItem("Duration", int(LibraryField::Duration));
+    librarySort->addItem("Codec", int(LibraryField::Codec));
+    librarySort->addItem("Path", int(LibraryField::Path));
+
+    libraryFolderButton = new QPushButton("🗂", playlistPanel);
+    libraryFolderButton->setFixedSize(24, 24);
+    libraryFolderButton->setFlat(true);
+    libraryFolderButton->setToolTip("Add library folder");
+
+    rescanLibraryButton = new QPushButton("⟳", playlistPanel);
+    rescanLibraryButton->setFixedSize(24, 24);
+    rescanLibraryButton->setFlat(true);
+    rescanLibraryButton->setToolTip("Rescan library");
+
+    librarySearchTimer = new QTimer(this);
+    librarySearchTimer->setSingleShot(true);
+    librarySearchTimer->setInterval(250);
+
+    QHBoxLayout *libraryBar = new QHBoxLayout();
+    libraryBar->addWidget(librarySearch, 1);
+    libraryBar->addWidget(librarySort);
+    libraryBar->addWidget(libraryFolderButton);
+    libraryBar->addWidget(rescanLibraryButton);
+
+    // Lista elementów multimedialnych: model z playlistą + widok rysujący tylko widoczne wiersze
+    playlistModel = new PlaylistModel(this);
+    playlistModel->setLibrary(library);
+    playlistView = new QListView(playlistPanel);
+    playlistView->setModel(playlistModel);
+    playlistView->setUniformItemSizes(true);   // Bez pytania o rozmiar każdego z 100 tys. wierszy
+    playlistView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    playlistView->setStyleSheet("background-color: #0A0F22; color: white;");
 
-    // Lista elementów multimedialnych
-    playlistWidget = new QListWidget(playlistPanel);
-    playlistWidget->setStyleSheet("background-color: #0A0F22; color: white;");
+    playlistStatusLabel = new QLabel(playlistPanel);
+    playlistStatusLabel->setStyleSheet("color: #8890B0; font-size: 11px;");
 
     // Umieszczenie nagłówka i listy w layoucie playlisty
     playlistLayout->addLayout(playlistHeader);
-    playlistLayout->addWidget(playlistWidget);
+    playlistLayout->addLayout(libraryBar);
+    playlistLayout->addWidget(playlistView);
+    playlistLayout->addWidget(playlistStatusLabel);
     playlistPanel->setFixedWidth(300); // szerokość panelu
 
     // Układ główny interfejsu
@@ -121,8 +301,10 @@ MediaPlayer::MediaPlayer(QWidget *parent)
     // Układ poziomy: wideo + playlista
     QHBoxLayout *videoLayout = new QHBoxLayout();
     mediaStack = new QStackedLayout();  // Stos: obrazek lub wideo
-    mediaStack->addWidget(videoWidget);
+    mediaStack->addWidget(decks[0].video);
+    mediaStack->addWidget(decks[1].video);
     mediaStack->addWidget(imageLabel);
+    mediaStack->addWidget(audioVisualizer);
     videoLayout->addLayout(mediaStack);
     videoLayout->addWidget(playlistPanel);
 
@@ -134,6 +316,8 @@ MediaPlayer::MediaPlayer(QWidget *parent)
     QHBoxLayout *timeLayout = new QHBoxLayout();
     timeLayout->addWidget(timeDisplay);
     timeLayout->addStretch();
+    timeLayout->addWidget(speedBox);
+    timeLayout->addWidget(telemetryButton);
     timeLayout->addWidget(playlistButton);
 
     // Panel sterowania: przyciski
@@ -141,7 +325,9 @@ MediaPlayer::MediaPlayer(QWidget *parent)
     controlsLayout->addStretch();
     controlsLayout->addWidget(prevTrackButton);
     controlsLayout->addWidget(rewindButton);
+    controlsLayout->addWidget(stepBackButton);
     controlsLayout->addWidget(playPauseButton);
+    controlsLayout->addWidget(stepForwardButton);
     controlsLayout->addWidget(forwardButton);
     controlsLayout->addWidget(nextTrackButton);
     controlsLayout->addStretch();
@@ -163,7 +349,6 @@ MediaPlayer::MediaPlayer(QWidget *parent)
     mainLayout->addLayout(bottomLayout);
 
     setLayout(mainLayout);
-    showMaximized();
     setWindowTitle("Qt Media Player");
 
 
@@ -171,20 +356,45 @@ MediaPlayer::MediaPlayer(QWidget *parent)
     connect(playPauseButton, &QPushButton::clicked, this, &MediaPlayer::togglePlayPause);  
     connect(rewindButton, &QPushButton::clicked, this, &MediaPlayer::rewind);             
     connect(forwardButton, &QPushButton::clicked, this, &MediaPlayer::fastForward);        
+    connect(stepBackButton, &QPushButton::clicked, this, &MediaPlayer::stepBackward);
+    connect(stepForwardButton, &QPushButton::clicked, this, &MediaPlayer::stepForward);
 
-    //  Zmiana głośności na podstawie suwaka 
-    connect(volumeSlider, &QSlider::valueChanged, [=](int value) {
-        audioOutput->setVolume(value / 100.0);
+    //  Zmiana głośności na podstawie suwaka (oba zestawy — przygotowany gra tak samo głośno)
+    connect(volumeSlider, &QSlider::valueChanged, this, &MediaPlayer::applyVolume);
+
+    //  Analiza głośności po zmianie playlisty; wynik przygotowanego utworu od razu na jego zestawie
+    //  (bieżący utwór nie zmienia głośności w trakcie odtwarzania)
+    connect(loudnessTimer, &QTimer::timeout, this, &MediaPlayer::analyzeUpcomingLoudness);
+    connect(playlistModel, &QAbstractItemModel::rowsInserted, loudnessTimer, qOverload<>(&QTimer::start));
+    connect(playlistModel, &QAbstractItemModel::modelReset, loudnessTimer, qOverload<>(&QTimer::start));
+    connect(loudness, &LoudnessAnalyzer::trackAnalyzed, this, [=](const QString &path) {
+        Deck &next = standbyDeck();
+        if (next.index >= 0 && playlistModel->filePath(next.index) == path)
+            setDeckGain(next, path);
     });
 
     //  Przesuwanie odtwarzania przez suwak postępu 
     connect(progressSlider, &QSlider::sliderMoved, [=](int value) {
-        mediaPlayer->setPosition(value * 1000); // sekundy → ms
+        seekTo(qint64(value) * 1000);   // sekundy → ms; kolejne piksele przeciągania tylko zmieniają cel
+        showScrubPreview(qint64(value) * 1000,
+                         QStyle::sliderPositionFromValue(progressSlider->minimum(), progressSlider->maximum(),
+                                                         value, progressSlider->width()));
+    });
+    connect(progressSlider, &QSlider::sliderReleased, [=]() {
+        seekTo(qint64(progressSlider->value()) * 1000);
+        if (!progressSlider->underMouse())
+            scrubPreview->hide();
+    });
+    connect(seekSettleTimer, &QTimer::timeout, this, &MediaPlayer::onSeekSettled);
+    connect(scrubThumbnails, &ScrubThumbnailIndex::thumbnailReady, this, [=]() {
+        if (scrubPreview->isVisible())
+            showScrubPreview(scrubPreviewMs, scrubPreviewX);
     });
 
-    //  Aktualizacje suwaka i zegara podczas odtwarzania 
-    connect(mediaPlayer, &QMediaPlayer::positionChanged, this, &MediaPlayer::updatePosition);
-    connect(mediaPlayer, &QMediaPlayer::durationChanged, this, &MediaPlayer::updateDuration);
+    //  Aktualizacje suwaka i zegara podczas odtwarzania, przygotowanie następnego utworu
+    setupDeck(0);
+    setupDeck(1);
+    connect(handOffTimer, &QTimer::timeout, this, [=]() { handOff(true); });
 
     //  Pokaż/ukryj playlistę po kliknięciu przycisku 📂 
     connect(playlistButton, &QPushButton::clicked, [=]() {
@@ -192,33 +402,77 @@ MediaPlayer::MediaPlayer(QWidget *parent)
         playlistPanel->setVisible(isPlaylistVisible);
     });
 
-    //  Dodanie pliku do playlisty z exploratora plików
+    //  Dodanie plików do playlisty z exploratora plików
     connect(addToPlaylistButton, &QPushButton::clicked, [=]() {
-        QString fileName = QFileDialog::getOpenFileName(this, "Add to Playlist",
-                                                        QDir::homePath(),
-                                                        "Media Files (*.mp3 *.mp4 *.wav *.avi *.mkv *.mov)");
-        if (!fileName.isEmpty()) {
-            QListWidgetItem *item = new QListWidgetItem(QFileInfo(fileName).fileName());
-            item->setData(Qt::UserRole, fileName);
-            playlistWidget->addItem(item);
+        QStringList fileNames = QFileDialog::getOpenFileNames(this, "Add to Playlist",
+                                                              QDir::homePath(),
+                                                              "Media Files (*.mp3 *.mp4 *.m4a *.wav *.flac *.ogg *.avi *.mkv *.mov *.webm)");
+        playlistModel->append(fileNames);
+    });
+
+    //  Rekurencyjny import folderu — skanowanie w tle, pliki dopisywane partiami
+    connect(importFolderButton, &QPushButton::clicked, [=]() {
+        QString directory = QFileDialog::getExistingDirectory(this, "Import Folder", QDir::homePath());
+        if (!directory.isEmpty())
+            playlistModel->importFolder(directory);
+    });
+
+    //  Playlisty: własny format binarny zastępuje listę, M3U/M3U8/PLS są dopisywane strumieniowo
+    connect(openPlaylistButton, &QPushButton::clicked, [=]() {
+        QString fileName = QFileDialog::getOpenFileName(this, "Open Playlist", QDir::homePath(),
+                                                        "Playlists (*.qpl *.m3u *.m3u8 *.pls)");
+        if (!fileName.isEmpty())
+            openPlaylist(fileName);
+    });
+    connect(savePlaylistButton, &QPushButton::clicked, [=]() {
+        QString fileName = QFileDialog::getSaveFileName(this, "Save Playlist",
+                                                        QDir::homePath() + "/playlist.qpl",
+                                                        "Playlist (*.qpl)");
+        if (!fileName.isEmpty() && !playlistModel->save(fileName))
+            QMessageBox::warning(this, "Save Playlist", "Cannot write " + fileName);
+    });
+    connect(playlistModel, &PlaylistModel::importProgress, this, [=](int addedFiles) {
+        playlistStatusLabel->setText(QString("Importing… %1 files").arg(addedFiles));
+    });
+    connect(playlistModel, &PlaylistModel::importFinished, this, &MediaPlayer::updatePlaylistStatus);
+
+    //  Biblioteka: zapytanie po zmianie filtra lub pola sortowania
+    connect(librarySearch, &QLineEdit::textChanged, librarySearchTimer, qOverload<>(&QTimer::start));
+    connect(librarySearchTimer, &QTimer::timeout, this, &MediaPlayer::showLibrary);
+    connect(librarySort, &QComboBox::currentIndexChanged, this, &MediaPlayer::showLibrary);
+
+    connect(libraryFolderButton, &QPushButton::clicked, [=]() {
+        QString directory = QFileDialog::getExistingDirectory(this, "Add Library Folder", QDir::homePath());
+        if (!directory.isEmpty()) {
+            library->setDirectories(library->directories() << directory);
+            library->rescan();
         }
     });
+    connect(rescanLibraryButton, &QPushButton::clicked, library, &MediaLibrary::rescan);
+
+    connect(library, &MediaLibrary::scanProgress, this, [=](int processedFiles, int changedFiles) {
+        playlistStatusLabel->setText(QString("Scanning library… %1 / %2").arg(processedFiles).arg(changedFiles));
+    });
+    connect(library, &MediaLibrary::scanFinished, this, [=](const LibraryScanStats &stats) {
+        playlistModel->refreshTitles();   // Tytuły z nowych metadanych
+        updatePlaylistStatus();
+        if (stats.updated > 0 || stats.removed > 0)
+            playlistStatusLabel->setText(playlistStatusLabel->text()
+                                         + QString(" · library: %1 tracks").arg(library->trackCount()));
+    });
+
+    //  Nowe elementy mogą być następnym utworem
+    connect(playlistModel, &QAbstractItemModel::rowsInserted, this, [=]() {
+        prepareNext();
+        if (!playlistModel->isImporting())
+            updatePlaylistStatus();
+    });
 
     //  Usuwanie zaznaczonego pliku z playlisty 
     connect(removeFromPlaylistButton, &QPushButton::clicked, [=]() {
-        QListWidgetItem *selectedItem = playlistWidget->currentItem();
-        if (selectedItem) {
-            int row = playlistWidget->row(selectedItem);
-            delete playlistWidget->takeItem(row);
-            // Obsługa sytuacji gdy usunięto aktualnie odtwarzany plik
-            if (row == currentPlaylistIndex) {
-                mediaPlayer->stop();
-                playPauseButton->setIcon(QIcon("./icons/play_button_proj.png"));
-                currentPlaylistIndex = -1;
-            } else if (row < currentPlaylistIndex) {
-                currentPlaylistIndex--;
-            }
-        }
+        QModelIndex selected = playlistView->currentIndex();
+        if (selected.isValid())
+            removePlaylistItem(selected.row());
     });
 
     //  Przejście do poprzedniego/następnego utworu 
@@ -226,13 +480,104 @@ MediaPlayer::MediaPlayer(QWidget *parent)
     connect(nextTrackButton, &QPushButton::clicked, this, &MediaPlayer::nextTrack);
 
     //  Odtwórz plik po kliknięciu na liście 
-    connect(playlistWidget, &QListWidget::itemClicked, [=](QListWidgetItem *item) {
-        int index = playlistWidget->row(item);
-        playItemAtIndex(index);
+    connect(playlistView, &QListView::clicked, [=](const QModelIndex &index) {
+        playItemAtIndex(index.row());
     });
+
+    //  Playlista z poprzedniej sesji
+    playlistModel->load(autosavePlaylistPath());
+    updatePlaylistStatus();
+
+    //  Przyrostowe skanowanie biblioteki przy starcie — niezmienione pliki są pomijane
+    if (!library->directories().isEmpty())
+        library->rescan();
+}
+
+MediaPlayer::~MediaPlayer() {
+    loudness->cancel();
+    playlistModel->cancelImport();   // Zapisujemy tylko to, co już trafiło do modelu
+    playlistModel->save(autosavePlaylistPath());
+}
+
+void MediaPlayer::cancelPreviewWork() {
+    scrubThumbnails->stop();         // Gotowe miniatury zostają; reszta przy kolejnym najechaniu
+}
+
+//  Otwarcie playlisty: plik .qpl zastępuje bieżącą listę, M3U/M3U8/PLS jest importowany w tle
+void MediaPlayer::openPlaylist(const QString &fileName) {
+    if (QFileInfo(fileName).suffix().compare("qpl", Qt::CaseInsensitive) != 0) {
+        playlistModel->importPlaylist(fileName);
+        return;
+    }
+
+    if (!playlistModel->load(fileName)) {
+        QMessageBox::warning(this, "Open Playlist", "Invalid playlist file: " + fileName);
+        return;
+    }
+    currentPlaylistIndex = -1;       // Odtwarzany utwór nie należy do nowej listy
+    prepareNext();                   // Zwalnia utwór przygotowany ze starej listy
+    updatePlaylistStatus();
+}
+
+//  Wyniki zapytania do biblioteki jako playlista (bieżący utwór zostaje zaznaczony, jeśli pasuje)
+void MediaPlayer::showLibrary() {
+    const LibraryField sortBy = LibraryField(librarySort->currentData().toInt());
+    const QStringList paths = library->queryPaths(librarySearch->text().trimmed(), sortBy);
+    const QString current = playlistModel->filePath(currentPlaylistIndex);
+
+    // Przygotowany utwór odnosi się do starej listy
+    Deck &next = standbyDeck();
+    if (next.index >= 0) {
+        next.player->setSource(QUrl());
+        next.index = -1;
+        next.ready = false;
+    }
+
+    playlistModel->clear();
+    currentPlaylistIndex = current.isEmpty() ? -1 : int(paths.indexOf(current));
+    playlistModel->append(paths);
+    prepareNext();
+    if (currentPlaylistIndex >= 0)
+        playlistView->setCurrentIndex(playlistModel->index(currentPlaylistIndex));
+    updatePlaylistStatus();
 }
 
-MediaPlayer::~MediaPlayer() {}
+//  Usunięcie pozycji z playlisty wraz z korektą indeksów odtwarzanego i przygotowanego utworu
+void MediaPlayer::removePlaylistItem(int row) {
+    playlistModel->removeRow(row);
+
+    // Obsługa sytuacji gdy usunięto aktualnie odtwarzany plik
+    if (row == currentPlaylistIndex) {
+        mediaPlayer->stop();
+        playPauseButton->setIcon(IconCache::icon("play_button_proj.png"));
+        currentPlaylistIndex = -1;
+    } else if (row < currentPlaylistIndex) {
+        currentPlaylistIndex--;
+    }
+
+    // Przygotowany utwór też przesuwa się na liście (albo został usunięty)
+    Deck &next = standbyDeck();
+    if (row == next.index) {
+        next.player->setSource(QUrl());
+        next.index = -1;
+        next.ready = false;
+    } else if (row < next.index) {
+        next.index--;
+    }
+    prepareNext();
+    updatePlaylistStatus();
+}
+
+//  Liczba utworów i pamięć zajmowana średnio przez jedną pozycję playlisty
+void MediaPlayer::updatePlaylistStatus() {
+    const int tracks = playlistModel->count();
+    if (tracks == 0) {
+        playlistStatusLabel->setText("Empty playlist");
+        return;
+    }
+    playlistStatusLabel->setText(QString("%1 tracks · %2 B/track")
+                                     .arg(tracks).arg(playlistModel->bytesPerEntry(), 0, 'f', 1));
+}
 
 //  Otwieranie pliku multimedialnego przez okno dialogowe 
 void MediaPlayer::openFile() {
@@ -240,42 +585,285 @@ void MediaPlayer::openFile() {
                                                     QDir::homePath(),
                                                     "Media Files (*.mp3 *.mp4 *.m4a *.wav *.avi *.mkv)");
     if (!fileName.isEmpty()) {
+        TRACE_SCOPE_INFO("media.set_source", fileName);
+        currentPlaylistIndex = -1;                             // plik spoza playlisty
+        prepareNext();                                         // nic nie jest przygotowane jako następne
+        resetSeek();
+        setDeckGain(decks[activeDeck], fileName);              // wyrównanie głośności (jeśli znana)
         mediaPlayer->setSource(QUrl::fromLocalFile(fileName)); // ustawienie źródła
         mediaPlayer->play();                                   // rozpoczęcie odtwarzania
         updateMediaDisplay();                                  // pokaż obraz/wideo
-        playPauseButton->setIcon(QIcon("./icons/stop_button_proj.png"));
+        playPauseButton->setIcon(IconCache::icon("stop_button_proj.png"));
     }
 }
 
 
 //  Odtwieranie pliku z playlisty według indeksu 
 void MediaPlayer::playItemAtIndex(int index) {
-    if (index >= 0 && index < playlistWidget->count()) {
+    if (index >= 0 && index < playlistModel->count()) {
+        // Istnienie pliku jest sprawdzane dopiero teraz (import playlisty tego nie robi)
+        if (!playlistModel->fileExists(index)) {
+            playlistStatusLabel->setText("File not found: " + playlistModel->fileName(index));
+            return;
+        }
+
+        // Utwór przygotowany na drugim zestawie — natychmiastowa zamiana
+        const Deck &next = standbyDeck();
+        if (next.ready && next.index == index) {
+            handOff(false);
+            return;
+        }
+
         currentPlaylistIndex = index;
-        playlistWidget->setCurrentRow(currentPlaylistIndex);
+        playlistView->setCurrentIndex(playlistModel->index(currentPlaylistIndex));
+
+        handOffTimer->stop();
+        measuringGap = false;
+
+        // play() przed zakończeniem wczytywania jest zapamiętywane przez QMediaPlayer,
+        // a widok (wideo/obrazek) przełącza się po wykryciu ścieżek (hasVideoChanged)
+        QString filePath = playlistModel->filePath(index);
+        TRACE_SCOPE_INFO("media.set_source", filePath);
+        resetSeek();
+        setDeckGain(decks[activeDeck], filePath);
+        mediaPlayer->setSource(playlistUrl(filePath));
+        mediaPlayer->play();
+        awaitingTrackStart = true;
+
+        playPauseButton->setIcon(IconCache::icon("stop_button_proj.png"));
+        prepareNext();
+        loudnessTimer->start();     // Kolejka analizy od nowego miejsca playlisty
+    }
+}
+
+//  Połączenia sygnałów jednego zestawu; do interfejsu trafiają tylko sygnały aktywnego
+void MediaPlayer::setupDeck(int deckIndex) {
+    QMediaPlayer *player = decks[deckIndex].player;
+
+    connect(player, &QMediaPlayer::positionChanged, this, [=](qint64 position) {
+        if (player != mediaPlayer)
+            return;
+        if (seekInFlight >= 0 && qAbs(position - seekInFlight) <= kSeekToleranceMs)
+            onSeekSettled();
+        updatePosition(position);
+        if (awaitingTrackStart && position > 0) {
+            awaitingTrackStart = false;
+            TRACE_INSTANT("media.track_started", QString::number(currentPlaylistIndex));
+            emit trackStarted(currentPlaylistIndex);
+        }
 
-        QString filePath = playlistWidget->item(index)->data(Qt::UserRole).toString();
-        mediaPlayer->setSource(QUrl::fromLocalFile(filePath));
+        // Pierwsza pozycja nowego utworu = moment startu (do pomiaru przerwy)
+        if (measuringGap && incomingStartNs < 0 && position > 0) {
+            incomingStartNs = gapClock.nsecsElapsed() - position * 1000000;
+            reportGap();
+        }
+        armHandOff(position);
+    });
+    // Klatki aktywnego zestawu zostają w pamięci klatek; krok dekodowany kończy się na swojej klatce
+    connect(decks[deckIndex].video->videoSink(), &QVideoSink::videoFrameChanged, this, [=](const QVideoFrame &frame) {
+        if (player != mediaPlayer)
+            return;
+        frameCache.insert(frame);
+        if (stepPendingUs >= 0 && frame.isValid()
+            && qAbs(frame.startTime() - stepPendingUs) < frameDurationUs())
+            onStepFrameShown(frame, false);
+    });
+    connect(player, &QMediaPlayer::durationChanged, this, [=](qint64 duration) {
+        if (player == mediaPlayer)
+            updateDuration(duration);
+    });
+    connect(player, &QMediaPlayer::hasVideoChanged, this, [=]() {
+        if (player == mediaPlayer)
+            updateMediaDisplay();
+    });
+    connect(player, &QMediaPlayer::mediaStatusChanged, this, [=](QMediaPlayer::MediaStatus status) {
+        onDeckStatusChanged(deckIndex, status);
+    });
+}
+
+void MediaPlayer::onDeckStatusChanged(int deckIndex, QMediaPlayer::MediaStatus status) {
+    TRACE_INSTANT("media.status", QString("deck=%1 active=%2 status=%3")
+                                      .arg(deckIndex).arg(deckIndex == activeDeck).arg(int(status)));
+    Deck &deck = decks[deckIndex];
 
-        // Odświeżanie widoku i rozpoczęcie odtwarzania z małym opóźnieniem
-        QTimer::singleShot(150, this, [=]() { updateMediaDisplay(); });
-        QTimer::singleShot(100, this, [=]() {
-            mediaPlayer->setPosition(100);
-            mediaPlayer->play();
-        });
+    if (deckIndex != activeDeck) {
+        // Poprzedni utwór dograł się do końca — zestaw może przygotować kolejny
+        if (deckIndex == outgoingDeck && status == QMediaPlayer::EndOfMedia) {
+            outgoingDeck = -1;
+            outgoingEndNs = gapClock.nsecsElapsed();
+            deck.player->stop();
+            reportGap();
+            prepareNext();
+            return;
+        }
 
-        playPauseButton->setIcon(QIcon("./icons/stop_button_proj.png"));
+        // Następny utwór wczytany: pauza wstępnie buforuje dźwięk i pierwszą klatkę obrazu
+        if (status == QMediaPlayer::LoadedMedia && deck.index >= 0 && !deck.ready) {
+            deck.player->pause();
+            deck.ready = true;
+        } else if (status == QMediaPlayer::InvalidMedia) {
+            deck.ready = false;
+        }
+        return;
     }
+
+    if (status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::BufferedMedia) {
+        updateMediaDisplay();
+    } else if (status == QMediaPlayer::EndOfMedia) {
+        // Koniec utworu przed zaplanowanym przejściem (np. utwór krótszy niż okno przejścia)
+        outgoingEndNs = gapClock.nsecsElapsed();
+        if (standbyDeck().ready) {
+            handOff(true);
+        } else if (currentPlaylistIndex >= 0 && currentPlaylistIndex + 1 < playlistModel->count()) {
+            playItemAtIndex(currentPlaylistIndex + 1);
+        } else {
+            playPauseButton->setIcon(IconCache::icon("play_button_proj.png"));
+        }
+    }
+}
+
+//  Wczytanie następnego utworu z playlisty na zestaw rezerwowy
+void MediaPlayer::prepareNext() {
+    // Zestaw jeszcze dogrywa koniec poprzedniego utworu — przygotowanie po jego zakończeniu
+    if (outgoingDeck == 1 - activeDeck)
+        return;
+
+    Deck &next = standbyDeck();
+    const int index = currentPlaylistIndex + 1;
+    if (currentPlaylistIndex < 0 || index >= playlistModel->count()) {
+        if (next.index >= 0) {
+            next.player->setSource(QUrl());
+            next.index = -1;
+            next.ready = false;
+        }
+        return;
+    }
+    if (next.index == index)
+        return;
+
+    next.index = index;
+    next.ready = false;
+    const QString path = playlistModel->filePath(index);
+    TRACE_SCOPE_INFO("media.prepare_next", path);
+    setDeckGain(next, path);
+    next.player->setSource(playlistUrl(path));
+}
+
+//  Planowanie przejścia: w ostatnich kHandOffWindowMs utworu zegar jest ustawiany ponownie
+//  przy każdej zmianie pozycji, więc nie rozjeżdża się z zegarem odtwarzania
+void MediaPlayer::armHandOff(qint64 position) {
+    const qint64 duration = mediaPlayer->duration();
+    if (!standbyDeck().ready || duration <= 0
+        || mediaPlayer->playbackState() != QMediaPlayer::PlayingState) {
+        handOffTimer->stop();
+        return;
+    }
+
+    const qint64 remaining = duration - position;
+    if (remaining <= kHandOffWindowMs)
+        handOffTimer->start(int(qMax<qint64>(0, remaining - handOffLeadMs)));
+}
+
+//  Zamiana zestawów: przygotowany utwór startuje, a poprzedni dogrywa koniec
+//  (atTrackEnd) albo jest zatrzymywany od razu (następny/poprzedni utwór)
+void MediaPlayer::handOff(bool atTrackEnd) {
+    Deck &incoming = standbyDeck();
+    if (!incoming.ready)
+        return;
+
+    TRACE_SCOPE_INFO("media.hand_off", atTrackEnd ? "track_end" : "switch");
+    handOffTimer->stop();
+    incoming.player->play();
+    awaitingTrackStart = true;
+
+    const int previousDeck = activeDeck;
+    activeDeck = 1 - activeDeck;
+    mediaPlayer = incoming.player;
+    audioOutput = incoming.audio;
+    videoWidget = incoming.video;
+    currentPlaylistIndex = incoming.index;
+    incoming.ready = false;
+    telemetry->attach(mediaPlayer, videoWidget->videoSink());
+    audioVisualizer->attach(mediaPlayer);
+    speedStage->attach(mediaPlayer, audioOutput, audioVisualizer->audioBufferOutput());
+    resetSeek();
+
+    // Rodzaj mediów jest znany od wczytania, więc widok przełącza się od razu na właściwy
+    playlistView->setCurrentIndex(playlistModel->index(currentPlaylistIndex));
+    updateDuration(mediaPlayer->duration());
+    updateMediaDisplay();
+    playPauseButton->setIcon(IconCache::icon("stop_button_proj.png"));
+
+    Deck &outgoing = decks[previousDeck];
+    outgoing.index = -1;
+    outgoing.ready = false;
+    if (atTrackEnd) {
+        measuringGap = true;
+        incomingStartNs = -1;
+        if (outgoing.player->mediaStatus() == QMediaPlayer::EndOfMedia) {
+            outgoing.player->stop();
+            prepareNext();
+        } else {
+            outgoingEndNs = -1;
+            outgoingDeck = previousDeck;
+        }
+    } else {
+        measuringGap = false;
+        outgoingDeck = -1;
+        outgoing.player->stop();
+        prepareNext();
+    }
+}
+
+//  Przerwa między końcem poprzedniego a początkiem następnego utworu (ujemna = nakładanie).
+//  Wynik koryguje wyprzedzenie startu kolejnych przejść.
+void MediaPlayer::reportGap() {
+    if (!measuringGap || incomingStartNs < 0 || outgoingEndNs < 0)
+        return;
+
+    measuringGap = false;
+    const double gapMs = (incomingStartNs - outgoingEndNs) / 1e6;
+    qDebug().noquote() << QString("[gapless] track=%1 gap_ms=%2 lead_ms=%3")
+                              .arg(currentPlaylistIndex).arg(gapMs, 0, 'f', 2).arg(handOffLeadMs);
+    emit gapMeasured(currentPlaylistIndex, gapMs);
+
+    handOffLeadMs = qBound<qint64>(0, handOffLeadMs + qRound64(gapMs), kMaxHandOffLeadMs);
 }
 
 //  Przewijanie do przodu o 10 sekund 
 void MediaPlayer::fastForward() {
-    mediaPlayer->setPosition(mediaPlayer->position() + 10000);
+    seekTo(pendingSeekPosition() + 10000);   // Kolejne gesty sumują się z niezakończonym przewinięciem
 }
 
 //  Cofanie o 10 sekund 
 void MediaPlayer::rewind() {
-    mediaPlayer->setPosition(mediaPlayer->position() - 10000);
+    seekTo(pendingSeekPosition() - 10000);
+}
+
+//  Wzmocnienie utworu z analizy głośności (1.0, gdy utwór nie był jeszcze analizowany)
+void MediaPlayer::setDeckGain(Deck &deck, const QString &path) {
+    deck.gain = loudness->loudness(path).gainFactor();
+    applyVolume();
+}
+
+//  Głośność zestawu = suwak × wzmocnienie utworu. QAudioOutput nie wzmacnia ponad 1.0,
+//  więc ciche utwory są podciągane tylko w granicach zapasu suwaka.
+void MediaPlayer::applyVolume() {
+    for (Deck &deck : decks)
+        deck.audio->setVolume(qMin(1.0, volumeSlider->value() / 100.0 * deck.gain));
+}
+
+//  Analiza głośności bieżącego i kolejnych utworów (zapisane wyniki są pomijane w wątkach analizy)
+void MediaPlayer::analyzeUpcomingLoudness() {
+    const int first = qMax(0, currentPlaylistIndex);
+    const int last = qMin(playlistModel->count(), first + kLoudnessLookahead);
+    QStringList paths;
+    for (int i = first; i < last; ++i) {
+        const QString path = playlistModel->filePath(i);
+        if (!path.contains("://"))     // Adresy sieciowe nie są analizowane
+            paths.append(path);
+    }
+    loudness->analyze(paths);
 }
 
 //  Zwiększanie głośności o 5 
@@ -299,7 +887,9 @@ void MediaPlayer::decreaseVolume() {
 //  Przełączanie widoku — wideo lub obrazek muzyczny 
 void MediaPlayer::updateMediaDisplay() {
     if (mediaPlayer->hasVideo()) {
-        mediaStack->setCurrentWidget(videoWidget);
+        mediaStack->setCurrentWidget(videoWidget);  // Widok wideo aktywnego zestawu
+    } else if (AudioVisualizer::isSupported()) {
+        mediaStack->setCurrentWidget(audioVisualizer);  // Na żywo z dekodowanego dźwięku
     } else {
         mediaStack->setCurrentWidget(imageLabel);
     }
@@ -309,17 +899,93 @@ void MediaPlayer::updateMediaDisplay() {
 void MediaPlayer::togglePlayPause() {
     if (mediaPlayer->playbackState() == QMediaPlayer::PlayingState) {
         mediaPlayer->pause();
-        playPauseButton->setIcon(QIcon("./icons/play_button_proj.png"));
+        handOffTimer->stop();
+        playPauseButton->setIcon(IconCache::icon("play_button_proj.png"));
     } else {
+        // Klatka pokazana krokiem z pamięci — odtwarzacz stoi jeszcze w innym miejscu
+        if (stepFrameUs >= 0 && stepPendingUs < 0
+            && qAbs(mediaPlayer->position() * 1000 - stepFrameUs) >= frameDurationUs())
+            mediaPlayer->setPosition(stepFrameUs / 1000);
+        stepFrameUs = -1;
+        stepPendingUs = -1;
         mediaPlayer->play();
-        playPauseButton->setIcon(QIcon("./icons/stop_button_proj.png"));
+        playPauseButton->setIcon(IconCache::icon("stop_button_proj.png"));
     }
 }
 
+//  Następna / poprzednia klatka
+void MediaPlayer::stepForward() {
+    stepFrame(1);
+}
+
+void MediaPlayer::stepBackward() {
+    stepFrame(-1);
+}
+
+//  Krok o jedną klatkę (odtwarzanie jest najpierw wstrzymywane). Sąsiednia klatka z pamięci
+//  ostatnich klatek trafia wprost do sinka widoku, bez przewijania odtwarzacza; gdy jej tam nie ma,
+//  odtwarzacz jest przewijany na środek sąsiedniej klatki (dekodowanie od klatki kluczowej).
+void MediaPlayer::stepFrame(int direction) {
+    if (!mediaPlayer->hasVideo())
+        return;
+    if (mediaPlayer->playbackState() == QMediaPlayer::PlayingState)
+        togglePlayPause();
+    stepClock.start();
+
+    // Klatka odniesienia: oczekiwana z poprzedniego kroku, pokazana krokiem albo bieżąca w widoku
+    QVideoSink *sink = videoWidget->videoSink();
+    qint64 currentUs = stepPendingUs >= 0 ? stepPendingUs : stepFrameUs;
+    if (currentUs < 0)
+        currentUs = sink->videoFrame().startTime();
+    if (currentUs < 0)
+        currentUs = mediaPlayer->position() * 1000;
+
+    const qint64 frameUs = frameDurationUs();
+    const qint64 maxGapUs = frameUs * 3 / 2;
+    const QVideoFrame cached = direction < 0 ? frameCache.frameBefore(currentUs, maxGapUs)
+                                             : frameCache.frameAfter(currentUs, maxGapUs);
+    if (cached.isValid()) {
+        stepPendingUs = -1;
+        sink->setVideoFrame(cached);
+        onStepFrameShown(cached, true);
+        return;
+    }
+
+    if (direction < 0 && currentUs < frameUs)
+        return;     // Pierwsza klatka
+    stepPendingUs = currentUs + direction * frameUs;
+    mediaPlayer->setPosition((stepPendingUs + frameUs / 2) / 1000);
+}
+
+//  Klatka kroku jest w widoku — pozycja i opóźnienie kroku w telemetrii
+void MediaPlayer::onStepFrameShown(const QVideoFrame &frame, bool fromCache) {
+    stepFrameUs = frame.startTime();
+    stepPendingUs = -1;
+    updatePosition(stepFrameUs / 1000);
+    telemetry->recordStep(stepClock.nsecsElapsed() / 1e6, fromCache, displayFrameMs());
+}
+
+//  Długość klatki: z metadanych, z bieżącej klatki albo 40 ms (25 kl./s)
+qint64 MediaPlayer::frameDurationUs() const {
+    const qreal fps = mediaPlayer->metaData().value(QMediaMetaData::VideoFrameRate).toReal();
+    if (fps > 1.0)
+        return qRound64(1e6 / fps);
+    const QVideoFrame frame = videoWidget->videoSink()->videoFrame();
+    if (frame.endTime() > frame.startTime() && frame.startTime() >= 0)
+        return frame.endTime() - frame.startTime();
+    return 40000;
+}
+
+//  Cel opóźnienia kroku: jedna klatka ekranu
+double MediaPlayer::displayFrameMs() const {
+    const qreal refreshRate = screen() ? screen()->refreshRate() : 60.0;
+    return 1000.0 / qMax<qreal>(1.0, refreshRate);
+}
+
 //  Następny utwor na playliście 
 void MediaPlayer::nextTrack() {
-    if (currentPlaylistIndex < playlistWidget->count() - 1)
-        playItemAtIndex(currentPlaylistIndex + 1);
+    if (currentPlaylistIndex < playlistModel->count() - 1)
+        playItemAtIndex(currentPlaylistIndex + 1);  // Przygotowany utwór — bez wczytywania
 }
 
 //  Poprzedni utwor na playliście 
@@ -331,15 +997,28 @@ void MediaPlayer::previousTrack() {
 // Ustawienie maksymalnego czasu suwaka postępu
 void MediaPlayer::updateDuration(qint64 duration) {
     totalDuration = duration;
-    progressSlider->setMaximum(duration / 1000); // w sekundach
+    UiUpdateScheduler::instance().markDirty(positionUpdate);
 }
 
-// Aktualizacja pozycji suwaka i wyświetlacza czasu
+// Nowa pozycja odtwarzania — wyświetlana przy najbliższej klatce ekranu
 void MediaPlayer::updatePosition(qint64 position) {
-    int currentSecs = position / 1000; // dzielenie przez 1000, ponieważ czas jest w milisekundach
+    displayedPosition = position;
+    UiUpdateScheduler::instance().markDirty(positionUpdate);
+}
+
+// Aktualizacja pozycji suwaka i wyświetlacza czasu
+void MediaPlayer::refreshPositionDisplay() {
+    int currentSecs = displayedPosition / 1000; // dzielenie przez 1000, ponieważ czas jest w milisekundach
     int totalSecs = totalDuration / 1000;
 
-    progressSlider->setValue(currentSecs);
+    progressSlider->setMaximum(totalSecs); // w sekundach
+    if (!progressSlider->isSliderDown())   // Przeciągany suwak pokazuje cel, nie starą pozycję
+        progressSlider->setValue(currentSecs);
+
+    if (currentSecs == shownSecs && totalSecs == shownTotalSecs)
+        return;
+    shownSecs = currentSecs;
+    shownTotalSecs = totalSecs;
 
     QTime currentTime(0, 0, 0);
     currentTime = currentTime.addSecs(currentSecs);
@@ -348,4 +1027,111 @@ void MediaPlayer::updatePosition(qint64 position) {
 
     QString timeStr = currentTime.toString("hh:mm:ss") + " / " + totalTime.toString("hh:mm:ss");
     timeDisplay->setText(timeStr);
-}
\ No newline at end of file
+}
+
+// Nakładka telemetrii w lewym górnym rogu obrazu
+void MediaPlayer::updateTelemetryOverlay() {
+    if (!telemetryOverlay->isVisible())
+        return;
+    telemetryLabel->setText(telemetry->summaryText());
+    telemetryOverlay->adjustSize();
+    telemetryOverlay->move(mediaStack->geometry().topLeft() + QPoint(12, 12));
+    telemetryOverlay->raise();
+}
+
+//  Przewinięcie z łączeniem: w toku jest najwyżej jedno; żądania w tym czasie tylko zmieniają cel,
+//  a po zakończeniu bieżącego wysyłany jest wyłącznie najnowszy
+void MediaPlayer::seekTo(qint64 positionMs) {
+    stepFrameUs = -1;       // Krokowanie zaczyna się od nowa od klatki po przewinięciu
+    stepPendingUs = -1;
+    const qint64 duration = mediaPlayer->duration();
+    seekTarget = qBound<qint64>(0, positionMs, duration > 0 ? duration : qMax<qint64>(0, positionMs));
+    if (seekInFlight >= 0)
+        return;
+
+    seekInFlight = seekTarget;
+    seekTarget = -1;
+    mediaPlayer->setPosition(seekInFlight);
+    seekSettleTimer->start();
+}
+
+void MediaPlayer::onSeekSettled() {
+    seekSettleTimer->stop();
+    seekInFlight = -1;
+    if (seekTarget >= 0) {
+        const qint64 target = seekTarget;
+        seekTarget = -1;
+        if (qAbs(target - mediaPlayer->position()) > kSeekToleranceMs)
+            seekTo(target);
+    }
+}
+
+void MediaPlayer::resetSeek() {
+    seekSettleTimer->stop();
+    seekInFlight = -1;
+    seekTarget = -1;
+    frameCache.clear();     // Nowy plik (lub zestaw) — klatki poprzedniego nie pasują
+    stepFrameUs = -1;
+    stepPendingUs = -1;
+}
+
+//  Pozycja, na której odtwarzacz będzie po wykonaniu oczekujących przewinięć
+qint64 MediaPlayer::pendingSeekPosition() const {
+    if (seekTarget >= 0)
+        return seekTarget;
+    if (seekInFlight >= 0)
+        return seekInFlight;
+    return mediaPlayer->position();
+}
+
+//  Miniatura klatki z podpisem czasu nad wskazanym miejscem suwaka
+void MediaPlayer::showScrubPreview(qint64 positionMs, int sliderX) {
+    scrubPreviewMs = positionMs;
+    scrubPreviewX = sliderX;
+
+    const QString source = mediaPlayer->source().toLocalFile();
+    if (source.isEmpty() || !mediaPlayer->hasVideo() || totalDuration <= 0) {
+        scrubPreview->hide();
+        return;
+    }
+    scrubThumbnails->setSource(source);
+    scrubThumbnails->ensureBuilt();
+
+    QImage image = scrubThumbnails->thumbnailAt(positionMs);
+    if (image.isNull()) {
+        // Pierwsze miniatury jeszcze się generują — sam czas na czarnym tle
+        image = QImage(192, 108, QImage::Format_RGB32);
+        image.fill(Qt::black);
+    }
+
+    QPainter painter(&image);
+    const QString time = QTime(0, 0).addMSecs(int(positionMs)).toString("hh:mm:ss");
+    const QRect textRect(0, image.height() - 20, image.width(), 20);
+    painter.fillRect(textRect, QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    painter.drawText(textRect, Qt::AlignCenter, time);
+    painter.end();
+
+    scrubPreview->setPixmap(QPixmap::fromImage(image));
+    scrubPreview->adjustSize();
+    const QPoint anchor = progressSlider->mapTo(this, QPoint(sliderX, 0));
+    const int x = qBound(0, anchor.x() - scrubPreview->width() / 2, width() - scrubPreview->width());
+    scrubPreview->move(x, anchor.y() - scrubPreview->height() - 6);
+    scrubPreview->raise();
+    scrubPreview->show();
+}
+
+//  Najechanie kursorem na suwak postępu — podgląd klatki w tym miejscu
+bool MediaPlayer::eventFilter(QObject *watched, QEvent *event) {
+    if (watched == progressSlider) {
+        if (event->type() == QEvent::MouseMove && !progressSlider->isSliderDown()) {
+            const int x = qRound(static_cast<QMouseEvent *>(event)->position().x());
+            const int value = QStyle::sliderValueFromPosition(progressSlider->minimum(), progressSlider->maximum(),
+                                                              x, progressSlider->width());
+            showScrubPreview(qint64(value) * 1000, x);
+        } else if (event->type() == QEvent::Leave && !progressSlider->isSliderDown()) {
+            scrubPreview->hide();
+        }
+    }
+    return QWidget::eventFilter(watched, event);
+}
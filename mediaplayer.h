@@ -11,9 +11,22 @@
 #include <QMediaDevices>   
 #include <QSlider>         
 #include <QLCDNumber>      
-#include <QListWidget>     
+#include <QListView>       
+#include <QLineEdit>
+#include <QComboBox>
 #include <QFrame>          
 #include <QStackedLayout>  
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "playlistmodel.h"   // Playlista w zwartej pamięci (model dla QListView)
+#include "medialibrary.h"    // Biblioteka multimediów z metadanymi
+#include "playbacktelemetry.h" // Pomiary płynności odtwarzania
+#include "scrubthumbnails.h"   // Podgląd klatek przy przewijaniu
+#include "audiovisualizer.h"   // Widmo i przebieg dla utworów audio
+#include "loudnessanalyzer.h"  // Głośność utworów (EBU R128) i wyrównanie między nimi
+#include "videoframecache.h"   // Ostatnie klatki do krokowania klatka po klatce
+#include "playbackspeedstage.h" // Prędkość odtwarzania bez zmiany wysokości dźwięku
 
 // Obsługuje odtwarzanie multimediów (audio + wideo), playlistę, regulację głośności, suwak czasu, widok wideo lub obrazka
 class MediaPlayer : public QWidget {
@@ -28,21 +41,82 @@ public:
     void togglePlayPause();   
     void fastForward();       
     void rewind();           
+    void stepForward();       // O jedną klatkę (w pauzie)
+    void stepBackward();
     void nextTrack();         
     void previousTrack();     
     void increaseVolume();   
     void decreaseVolume();    
 
+    // Wczytanie playlisty z pliku (.qpl, M3U, PLS) bez okna dialogowego
+    void openPlaylist(const QString &fileName);
+
+    // Przerwanie pracy w tle potrzebnej tylko na ekranie odtwarzacza (miniatury przewijania);
+    // analiza głośności i odtwarzanie trwają dalej
+    void cancelPreviewWork();
+
 private:
+    // Zestaw odtwarzacza: własny QMediaPlayer, wyjście audio i widok wideo.
+    // Dwa zestawy pozwalają wczytać następny utwór i zatrzymać go na pierwszej klatce,
+    // zanim skończy się bieżący — przejście między utworami to tylko play() i zamiana zestawów.
+    struct Deck {
+        QMediaPlayer *player = nullptr;
+        QAudioOutput *audio = nullptr;
+        QVideoWidget *video = nullptr;
+        int index = -1;               // Pozycja na playliście (-1 = nic nie przygotowano)
+        bool ready = false;           // Wczytany i wstępnie zbuforowany (pauza na początku)
+        double gain = 1.0;            // Wyrównanie głośności utworu (mnożnik głośności suwaka)
+    };
+    Deck decks[2];
+    int activeDeck = 0;
+    Deck &standbyDeck() { return decks[1 - activeDeck]; }
+
+    // Elementy aktywnego zestawu (zamieniane przy przejściu do następnego utworu)
     QMediaPlayer *mediaPlayer;        
     QAudioOutput *audioOutput;        
     QVideoWidget *videoWidget;        
 
+    // Przejście do przygotowanego utworu tuż przed końcem bieżącego
+    QTimer *handOffTimer;
+    qint64 handOffLeadMs = 0;         // Wyprzedzenie startu, kalibrowane po każdym przejściu
+    int outgoingDeck = -1;            // Zestaw dogrywający koniec poprzedniego utworu
+
+    // Pomiar przerwy między utworami: koniec poprzedniego i początek następnego
+    QElapsedTimer gapClock;
+    qint64 outgoingEndNs = -1;
+    qint64 incomingStartNs = -1;
+    bool measuringGap = false;
+    bool awaitingTrackStart = false;  // Zmiana utworu czeka na pierwszą pozycję (trackStarted)
+
+    // Telemetria odtwarzania i nakładka z jej wynikami
+    PlaybackTelemetry *telemetry;
+    QFrame *telemetryOverlay;
+    QLabel *telemetryLabel;
+    QPushButton *telemetryButton;
+
+    // Prędkość odtwarzania (0.5×–3×)
+    PlaybackSpeedStage *speedStage;
+    QComboBox *speedBox;
+
     QFrame *playlistPanel;            
     QStackedLayout *mediaStack;       
     QLabel *imageLabel;               
-    QListWidget *playlistWidget;      
+    AudioVisualizer *audioVisualizer; // Zamiast obrazka, gdy wersja Qt pozwala na podgląd dźwięku
+    PlaylistModel *playlistModel;     
+    QListView *playlistView;          
+    QLabel *playlistStatusLabel;      // Liczba utworów, pamięć na pozycję, postęp importu
     QPushButton *addToPlaylistButton;       
+    QPushButton *importFolderButton;        
+    QPushButton *openPlaylistButton;        // .qpl, M3U/M3U8, PLS
+    QPushButton *savePlaylistButton;
+
+    // Biblioteka: wyszukiwanie i sortowanie wypełniają playlistę wynikami zapytania
+    MediaLibrary *library;
+    QLineEdit *librarySearch;
+    QComboBox *librarySort;
+    QPushButton *libraryFolderButton;
+    QPushButton *rescanLibraryButton;
+    QTimer *librarySearchTimer;             // Zapytanie dopiero po przerwie w pisaniu
     QPushButton *removeFromPlaylistButton;  
     bool isPlaylistVisible = false;         
 
@@ -50,24 +124,94 @@ private:
     QPushButton *playPauseButton;     
     QPushButton *rewindButton;        
     QPushButton *forwardButton;       
+    QPushButton *stepBackButton;
+    QPushButton *stepForwardButton;
     QPushButton *playlistButton;      
     QPushButton *prevTrackButton;     
     QPushButton *nextTrackButton;    
     int currentPlaylistIndex = -1;    
 
+    // Łączenie przewinięć: w toku jest najwyżej jedno, kolejne żądania nadpisują cel
+    QTimer *seekSettleTimer;
+    qint64 seekInFlight = -1;         // Pozycja wysłana do odtwarzacza (-1 = brak)
+    qint64 seekTarget = -1;           // Najnowszy cel czekający na zakończenie bieżącego
+
+    // Krokowanie klatka po klatce: ostatnie zdekodowane klatki i stan kroku
+    VideoFrameCache frameCache;
+    qint64 stepFrameUs = -1;          // Start klatki pokazanej krokiem (-1 = nie krokujemy)
+    qint64 stepPendingUs = -1;        // Klatka, na którą czeka krok dekodowany przez odtwarzacz
+    QElapsedTimer stepClock;
+
+    // Podgląd miniatury nad suwakiem postępu
+    ScrubThumbnailIndex *scrubThumbnails;
+    QLabel *scrubPreview;
+    qint64 scrubPreviewMs = -1;
+    int scrubPreviewX = 0;
+
+    // Analiza głośności utworów playlisty (od bieżącego w przód) i wyrównanie głośności
+    LoudnessAnalyzer *loudness;
+    QTimer *loudnessTimer;                  // Analiza dopiero, gdy playlista przestanie się zmieniać
+
     QSlider *progressSlider;          
     QSlider *volumeSlider;            
     QLabel *timeDisplay;              
     qint64 totalDuration = 0;         
 
+    // Pozycja i czas trwania trafiają na ekran raz na klatkę (UiUpdateScheduler), tekst
+    // czasu jest składany tylko przy zmianie pełnej sekundy
+    int positionUpdate = -1;
+    qint64 displayedPosition = 0;
+    int shownSecs = -1;
+    int shownTotalSecs = -1;
+
     // Funkcje reagujące na działania użytkownika
     void openFile();                     
     void updatePosition(qint64 position); 
     void updateDuration(qint64 duration); 
+    void refreshPositionDisplay();
     void updateMediaDisplay();            
     void playItemAtIndex(int index);      
+    void removePlaylistItem(int row);
+    void updatePlaylistStatus();
+    void showLibrary();
+    void updateTelemetryOverlay();
+
+    // Przewinięcia (łączone) i podgląd miniatur
+    void seekTo(qint64 positionMs);
+    void onSeekSettled();
+    void resetSeek();
+    qint64 pendingSeekPosition() const;
+    void showScrubPreview(qint64 positionMs, int sliderX);
+
+    // Krok o klatkę (direction = ±1), długość klatki bieżącego filmu i okres odświeżania ekranu
+    void stepFrame(int direction);
+    void onStepFrameShown(const QVideoFrame &frame, bool fromCache);
+    qint64 frameDurationUs() const;
+    double displayFrameMs() const;
+
+    // Wyrównanie głośności: wzmocnienie utworu zestawu i głośność obu zestawów
+    void setDeckGain(Deck &deck, const QString &path);
+    void applyVolume();
+    void analyzeUpcomingLoudness();
+
+    // Obsługa przygotowania i zamiany zestawów odtwarzacza
+    void setupDeck(int deckIndex);
+    void onDeckStatusChanged(int deckIndex, QMediaPlayer::MediaStatus status);
+    void prepareNext();
+    void armHandOff(qint64 position);
+    void handOff(bool atTrackEnd);
+    void reportGap();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 signals:
     // Sygnał informujący, że użytkownik chce wrócić do menu głównego
     void backToMenuRequested();
+
+    // Nowy utwór zaczął grać (pierwsza pozycja po zmianie utworu; do pomiaru opóźnienia przełączania)
+    void trackStarted(int index);
+
+    // Zmierzona przerwa przy samoczynnym przejściu do utworu index (ujemna = nakładanie)
+    void gapMeasured(int index, double gapMs);
 };
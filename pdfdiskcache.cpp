@@ -0,0 +1,169 @@
+#include "pdfdiskcache.h"
+#include "cacheutils.h"
+#include "taskscheduler.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// Domyślny limit rozmiaru pamięci na dysku
+constexpr qint64 kDefaultMaxBytes = 512ll * 1024 * 1024;
+// Po przekroczeniu limitu sprzątamy do 80%, żeby nie sprzątać przy każdym zapisie
+constexpr double kTrimTarget = 0.8;
+// Jakość PNG (w Qt oznacza stopień kompresji; wyższa = szybszy zapis, większy plik)
+constexpr int kPngQuality = 80;
+// Limit zapisów czekających w kolejce (każdy trzyma cały obraz w pamięci)
+constexpr int kMaxPendingWrites = 16;
+constexpr qint64 kMaxPendingBytes = 64ll * 1024 * 1024;
+}
+
+PdfDiskCache &PdfDiskCache::instance()
+{
+    static PdfDiskCache cache;
+    return cache;
+}
+
+PdfDiskCache::PdfDiskCache()
+    : maxBytes(kDefaultMaxBytes)
+{ }
+
+QString PdfDiskCache::directoryFor(const QString &fileName)
+{
+    return CacheUtils::cacheDir("pdf/" + CacheUtils::fileIdentityKey(fileName) + "/pages");
+}
+
+QString PdfDiskCache::filePath(const QString &directory, const PdfRenderKey &key)
+{
+    // Np. "p12_1240x1754.png" albo dla kafelka "p12_4960x7016_t512_1024_512_512.png"
+    QString name = QString("p%1_%2x%3").arg(key.page).arg(key.pageSize.width()).arg(key.pageSize.height());
+    if (!key.clip.isNull()) {
+        name += QString("_t%1_%2_%3_%4").arg(key.clip.x()).arg(key.clip.y())
+                                        .arg(key.clip.width()).arg(key.clip.height());
+    }
+    return directory + "/" + name + ".png";
+}
+
+void PdfDiskCache::setMaxBytes(qint64 bytes)
+{
+    QMutexLocker locker(&mutex);
+    maxBytes = bytes;
+}
+
+QImage PdfDiskCache::load(const QString &directory, const PdfRenderKey &key)
+{
+    const QString path = filePath(directory, key);
+    QImage image;
+    if (!QFileInfo::exists(path) || !image.load(path, "PNG"))
+        return QImage();
+
+    // Data modyfikacji służy jako czas ostatniego użycia dla LRU
+    QFile file(path);
+    if (file.open(QIODevice::ReadWrite))
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+    return image;
+}
+
+void PdfDiskCache::store(const QString &directory, const PdfRenderKey &key, const QImage &image)
+{
+    if (directory.isEmpty() || image.isNull())
+        return;
+
+    // Zapis nie nadąża (np. szybkie przewijanie) — render jest pomijany zamiast czekać w pamięci;
+    // pojedynczy duży obraz przechodzi, gdy kolejka jest pusta
+    const qint64 bytes = image.sizeInBytes();
+    QMutexLocker locker(&mutex);
+    if (pendingWrites > 0 && (pendingWrites >= kMaxPendingWrites || pendingBytes + bytes > kMaxPendingBytes))
+        return;
+    ++pendingWrites;
+    pendingBytes += bytes;
+    writes.push_back(PendingWrite{filePath(directory, key), image});
+    if (!writing)
+        submitWrite();
+}
+
+void PdfDiskCache::submitWrite()
+{
+    writing = true;
+    PendingWrite next = std::move(writes.front());
+    writes.pop_front();
+
+    TaskScheduler::instance().submit(TaskPriority::Background, "pdf.disk_cache_write",
+                                     [this, next](const CancellationToken &) {
+        write(next.path, next.image);
+
+        // Następny zapis dopiero po tym — jeden plik naraz, wątek puli wolny między plikami
+        QMutexLocker locker(&mutex);
+        --pendingWrites;
+        pendingBytes -= next.image.sizeInBytes();
+        if (writes.empty())
+            writing = false;
+        else
+            submitWrite();
+    });
+}
+
+void PdfDiskCache::write(const QString &path, const QImage &image)
+{
+    // Strony są nieprzezroczyste — bez kanału alfa pliki są mniejsze
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)
+        || !image.convertToFormat(QImage::Format_RGB32).save(&file, "PNG", kPngQuality)
+        || !file.commit()) {
+        qDebug() << "PdfDiskCache: cannot write" << path;
+        return;
+    }
+
+    bool overLimit;
+    {
+        QMutexLocker locker(&mutex);
+        if (totalBytes >= 0)
+            totalBytes += QFileInfo(path).size();
+        overLimit = totalBytes < 0 || totalBytes > maxBytes;
+    }
+    if (overLimit)
+        trim();
+}
+
+void PdfDiskCache::trim()
+{
+    // Wszystkie rendery wszystkich dokumentów — limit jest wspólny
+    QList<QFileInfo> files;
+    qint64 total = 0;
+    QDirIterator it(CacheUtils::cacheDir("pdf"), { "*.png" }, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        files.append(it.fileInfo());
+        total += it.fileInfo().size();
+    }
+
+    qint64 limit;
+    {
+        QMutexLocker locker(&mutex);
+        limit = maxBytes;
+    }
+
+    if (total > limit) {
+        // Najdawniej używane pliki usuwamy pierwsze
+        std::sort(files.begin(), files.end(), [](const QFileInfo &a, const QFileInfo &b) {
+            return a.lastModified() < b.lastModified();
+        });
+
+        const qint64 target = qint64(limit * kTrimTarget);
+        for (const QFileInfo &info : files) {
+            if (total <= target)
+                break;
+            if (QFile::remove(info.filePath()))
+                total -= info.size();
+        }
+    }
+
+    QMutexLocker locker(&mutex);
+    totalBytes = total;
+}
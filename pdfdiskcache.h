@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QString>
+#include <QImage>
+#include <QMutex>
+#include <deque>
+
+#include "pdfrenderer.h"               // PdfRenderKey
+
+// Trwała pamięć podręczna wyrenderowanych stron PDF (między uruchomieniami aplikacji).
+// Rendery są zapisywane jako skompresowane pliki PNG w katalogu dokumentu
+// (obok indeksu wyszukiwania), a nazwa pliku koduje stronę, rozmiar w pikselach
+// urządzenia (a więc i devicePixelRatio) oraz wycinek. Łączny rozmiar jest ograniczony —
+// najdawniej używane pliki są usuwane jako pierwsze.
+// Zapisy są zadaniami Background wspólnej puli (TaskScheduler), po jednym pliku na zadanie;
+// kolejne zadanie zgłasza poprzednie, więc zapisy i sprzątanie idą po kolei.
+// Wszystkie metody są bezpieczne wątkowo.
+class PdfDiskCache {
+public:
+    static PdfDiskCache &instance();
+
+    // Katalog renderów danego dokumentu (klucz = tożsamość pliku: ścieżka, rozmiar, data)
+    static QString directoryFor(const QString &fileName);
+
+    // Odczyt renderu; pusty obraz, jeśli go nie ma. Trafienie odświeża pozycję w LRU.
+    QImage load(const QString &directory, const PdfRenderKey &key);
+
+    // Zapis renderu w tle; pomijany, gdy w kolejce czeka już zbyt wiele zapisów
+    void store(const QString &directory, const PdfRenderKey &key, const QImage &image);
+
+    void setMaxBytes(qint64 bytes);
+
+private:
+    PdfDiskCache();
+
+    static QString filePath(const QString &directory, const PdfRenderKey &key);
+
+    struct PendingWrite {
+        QString path;
+        QImage image;
+    };
+
+    // Zgłoszenie zadania zapisu dla pierwszego pliku z kolejki (wywoływane z zablokowanym mutexem)
+    void submitWrite();
+
+    // Wykonywane w zadaniu zapisu
+    void write(const QString &path, const QImage &image);
+    void trim();
+
+    QMutex mutex;                      // Chroni pola poniżej
+    qint64 maxBytes;
+    qint64 totalBytes = -1;            // -1 = jeszcze nie policzony
+    std::deque<PendingWrite> writes;   // Czekające na zapis (bez zapisu w toku)
+    bool writing = false;              // Zadanie zapisu zgłoszone albo w toku
+    int pendingWrites = 0;             // Zapisy w kolejce i w toku
+    qint64 pendingBytes = 0;           // Pamięć trzymana przez te zapisy
+};
@@ -0,0 +1,51 @@
+#include "pdfrendercache.h"
+
+namespace {
+// Domyślny limit pamięci renderów wszystkich dokumentów razem
+constexpr qint64 kDefaultMaxBytes = 128ll * 1024 * 1024;
+}
+
+PdfRenderCache &PdfRenderCache::instance()
+{
+    static PdfRenderCache renderCache;
+    return renderCache;
+}
+
+PdfRenderCache::PdfRenderCache()
+{
+    setMaxBytes(kDefaultMaxBytes);
+}
+
+void PdfRenderCache::setMaxBytes(qint64 bytes)
+{
+    cache.setMaxCost(qMax<qsizetype>(1, bytes / 1024));
+}
+
+qint64 PdfRenderCache::usedBytes() const
+{
+    return qint64(cache.totalCost()) * 1024;
+}
+
+bool PdfRenderCache::contains(const QString &document, const PdfRenderKey &key) const
+{
+    return cache.contains(Key{document, key});
+}
+
+QImage *PdfRenderCache::object(const QString &document, const PdfRenderKey &key) const
+{
+    return cache.object(Key{document, key});
+}
+
+void PdfRenderCache::insert(const QString &document, const PdfRenderKey &key, const QImage &image)
+{
+    cache.insert(Key{document, key}, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+}
+
+void PdfRenderCache::removeDocument(const QString &document)
+{
+    const QList<Key> keys = cache.keys();
+    for (const Key &key : keys) {
+        if (key.document == document)
+            cache.remove(key);
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QCache>                      // LRU z limitem kosztu
+#include <QImage>
+#include <QString>
+
+#include "pdfrenderer.h"               // PdfRenderKey
+
+// Wspólna pamięć podręczna wyrenderowanych stron wszystkich otwartych dokumentów.
+// Jeden limit bajtów i jedna kolejka LRU: gdy limit jest przekroczony, usuwany jest
+// render nieużywany najdłużej — niezależnie od tego, do którego dokumentu należy.
+// Dokument jest identyfikowany kluczem tożsamości pliku (CacheUtils::fileIdentityKey),
+// więc rendery przetrwają zamknięcie i ponowne wczytanie dokumentu w tej samej sesji.
+// Używana tylko w wątku GUI.
+class PdfRenderCache {
+public:
+    static PdfRenderCache &instance();
+
+    void setMaxBytes(qint64 bytes);
+    qint64 usedBytes() const;
+
+    bool contains(const QString &document, const PdfRenderKey &key) const;
+
+    // Odczyt renderu (nullptr, jeśli go nie ma); trafienie odświeża pozycję w LRU
+    QImage *object(const QString &document, const PdfRenderKey &key) const;
+
+    // Nieudany render też można zapamiętać (jako pusty obraz), żeby go nie ponawiać
+    void insert(const QString &document, const PdfRenderKey &key, const QImage &image);
+
+    // Usunięcie wszystkich renderów dokumentu (np. po zamknięciu jego karty)
+    void removeDocument(const QString &document);
+
+private:
+    PdfRenderCache();
+
+    struct Key {
+        QString document;
+        PdfRenderKey render;
+
+        bool operator==(const Key &other) const {
+            return document == other.document && render == other.render;
+        }
+        friend size_t qHash(const Key &key, size_t seed = 0) {
+            return qHashMulti(seed, key.document, key.render);
+        }
+    };
+
+    // Koszt liczony w kilobajtach
+    QCache<Key, QImage> cache;
+};
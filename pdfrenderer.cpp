@@ -0,0 +1,266 @@
+#include "pdfrenderer.h"
+#include "pdfdiskcache.h"
+#include "cacheutils.h"
+#include "tracing.h"
+#include <QPdfDocument>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+// Pliki otwarte przez renderery (klucz kopii → liczba rendererów)
+QMutex openMutex;
+QHash<QString, int> openDocuments;
+
+// Kopie dokumentów wczytane w bieżącym wątku puli
+struct ThreadDocument {
+    QString identity;
+    std::unique_ptr<QPdfDocument> document;
+};
+thread_local std::vector<ThreadDocument> threadDocuments;
+
+void retainDocument(const QString &identity)
+{
+    if (identity.isEmpty())
+        return;
+    QMutexLocker locker(&openMutex);
+    ++openDocuments[identity];
+}
+
+void releaseDocument(const QString &identity)
+{
+    if (identity.isEmpty())
+        return;
+    QMutexLocker locker(&openMutex);
+    if (--openDocuments[identity] <= 0)
+        openDocuments.remove(identity);
+}
+
+// Kopia dokumentu dla bieżącego wątku puli; kopie plików, których żaden renderer już nie
+// używa, są przy okazji zwalniane
+QPdfDocument *documentInThisThread(const QString &fileName, const QString &identity)
+{
+    {
+        QMutexLocker locker(&openMutex);
+        threadDocuments.erase(std::remove_if(threadDocuments.begin(), threadDocuments.end(),
+                                             [](const ThreadDocument &entry) {
+                                                 return !openDocuments.contains(entry.identity);
+                                             }),
+                              threadDocuments.end());
+    }
+    for (const ThreadDocument &entry : threadDocuments) {
+        if (entry.identity == identity)
+            return entry.document.get();
+    }
+
+    TRACE_SCOPE_INFO("pdf.worker_load", fileName);
+    auto document = std::make_unique<QPdfDocument>();
+    if (document->load(fileName) != QPdfDocument::Error::None)
+        qDebug() << "PdfRenderer: failed to load" << fileName;
+    threadDocuments.push_back(ThreadDocument{identity, std::move(document)});
+    return threadDocuments.back().document.get();
+}
+}
+
+PdfRenderer::PdfRenderer(TaskPriority priority, int maxTasks, QObject *parent)
+    : QObject(parent),
+      maxTasks(qMax(1, maxTasks))
+{
+    qRegisterMetaType<PdfRenderKey>();
+
+    // Zapas idzie klasę niżej (Background zostaje Background)
+    queues[0].priority = priority;
+    queues[1].priority = TaskPriority(qMin(int(priority) + 1, int(TaskPriority::Background)));
+}
+
+PdfRenderer::~PdfRenderer()
+{
+    QVector<TaskHandle> running;
+    {
+        QMutexLocker locker(&mutex);
+        for (Queue &queue : queues)
+            queue.pending.clear();
+        running.swap(tasks);
+    }
+
+    // Zadania z kolejki puli nie wystartują; uruchomione kończą się po bieżącym renderze
+    renderToken.cancel();
+    for (const TaskHandle &task : std::as_const(running))
+        task.cancel();
+    for (const TaskHandle &task : std::as_const(running))
+        task.waitForFinished();
+
+    releaseDocument(documentIdentity);
+}
+
+void PdfRenderer::setDocument(const QString &fileName)
+{
+    const QString cacheDir = (useDiskCache && !fileName.isEmpty())
+                                 ? PdfDiskCache::directoryFor(fileName)
+                                 : QString();
+    const QString identity = fileName.isEmpty() ? QString() : CacheUtils::fileIdentityKey(fileName);
+    retainDocument(identity);
+
+    QString previous;
+    {
+        QMutexLocker locker(&mutex);
+        for (Queue &queue : queues)
+            queue.pending.clear();
+        ++documentSerial;
+        documentFile = fileName;
+        previous = documentIdentity;
+        documentIdentity = identity;
+        diskCacheDir = cacheDir;
+        updateBusy();
+    }
+    releaseDocument(previous);
+}
+
+void PdfRenderer::requestRenders(const QList<PdfRenderKey> &keys, const QList<PdfRenderKey> &prefetch)
+{
+    QMutexLocker locker(&mutex);
+
+    // Zlecenia właśnie renderowane nie trafiają ponownie do kolejki
+    queues[0].pending.clear();
+    queues[1].pending.clear();
+    for (const PdfRenderKey &key : keys) {
+        if (!inFlight.contains(key))
+            queues[0].pending.append(key);
+    }
+    for (const PdfRenderKey &key : prefetch) {
+        if (!inFlight.contains(key))
+            queues[1].pending.append(key);
+    }
+
+    scheduleTasks();
+    updateBusy();
+}
+
+void PdfRenderer::yieldTo(PdfRenderer *other)
+{
+    {
+        QMutexLocker locker(&mutex);
+        yieldTarget = other;
+    }
+
+    // Gdy tamten renderer skończy pracę, wznawiamy wstrzymane zlecenia
+    connect(other, &PdfRenderer::idle, this, [this]() {
+        QMutexLocker locker(&mutex);
+        scheduleTasks();
+    });
+    connect(other, &QObject::destroyed, this, [this]() {
+        QMutexLocker locker(&mutex);
+        yieldTarget = nullptr;
+        scheduleTasks();
+    });
+}
+
+void PdfRenderer::scheduleTasks()
+{
+    if (documentIdentity.isEmpty() || (yieldTarget && yieldTarget->isBusy()))
+        return;
+
+    // Tyle zadań, ile jest zleceń w kolejce, najwyżej maxTasks na klasę
+    tasks.removeIf([](const TaskHandle &task) { return task.isFinished(); });
+    for (Queue &queue : queues) {
+        while (queue.tasks < maxTasks && queue.tasks < queue.pending.size()) {
+            ++queue.tasks;
+            Queue *q = &queue;
+            tasks.append(TaskScheduler::instance().submit(queue.priority, "pdf.render",
+                                                          [this, q](const CancellationToken &token) {
+                processQueue(q, token);
+            }, renderToken));
+        }
+    }
+}
+
+void PdfRenderer::updateBusy()
+{
+    const bool nowBusy = !queues[0].pending.isEmpty() || !queues[1].pending.isEmpty() || !inFlight.isEmpty();
+
+    // Powiadomienie o bezczynności trafia do wątku GUI
+    if (busy.exchange(nowBusy) && !nowBusy)
+        QMetaObject::invokeMethod(this, [this]() { emit idle(); }, Qt::QueuedConnection);
+}
+
+void PdfRenderer::processQueue(Queue *queue, const CancellationToken &token)
+{
+    PdfRenderKey key;
+    forever {
+        QString fileName;
+        QString identity;
+        QString cacheDir;
+        int serial;
+        {
+            QMutexLocker locker(&mutex);
+            if (key.page >= 0)
+                inFlight.removeOne(key);
+
+            // Zadanie kończy się, gdy: kolejka jest pusta, renderer jest usuwany albo renderer
+            // o wyższym priorytecie ma pracę (po jego idle zadania zostaną zgłoszone ponownie)
+            const bool yielding = yieldTarget && yieldTarget->isBusy();
+            if (queue->pending.isEmpty() || token.isCancelled() || yielding || documentIdentity.isEmpty()) {
+                --queue->tasks;
+                updateBusy();
+                return;
+            }
+            key = queue->pending.takeFirst();
+            inFlight.append(key);
+            fileName = documentFile;
+            identity = documentIdentity;
+            cacheDir = diskCacheDir;
+            serial = documentSerial;
+            TRACE_COUNTER("pdf.pending", queues[0].pending.size() + queues[1].pending.size());
+        }
+        TRACE_SCOPE_INFO("pdf.render", QString("page=%1 %2x%3%4").arg(key.page)
+                                            .arg(key.pageSize.width()).arg(key.pageSize.height())
+                                            .arg(key.clip.isNull() ? "" : " tile")
+                                            + (key.draft ? " draft" : ""));
+
+        // Szkice są tanie i krótkotrwałe — nie trafiają na dysk
+        if (key.draft)
+            cacheDir.clear();
+
+        // Render zapisany na dysku przy wcześniejszym otwarciu — bez rasteryzacji
+        QImage image;
+        if (!cacheDir.isEmpty()) {
+            TRACE_SCOPE("pdf.disk_cache_load");
+            image = PdfDiskCache::instance().load(cacheDir, key);
+        }
+
+        if (image.isNull()) {
+            QPdfDocument *document = documentInThisThread(fileName, identity);
+
+            TRACE_SCOPE("pdf.rasterize");
+            // Kafelek: renderujemy tylko wycinek strony przeskalowanej do pageSize
+            QPdfDocumentRenderOptions options;
+            QSize imageSize = key.pageSize;
+            if (!key.clip.isNull()) {
+                options.setScaledSize(key.pageSize);
+                options.setScaledClipRect(key.clip);
+                imageSize = key.clip.size();
+            }
+
+            // Szkic: bez wygładzania tekstu, grafiki i obrazów
+            if (key.draft) {
+                options.setRenderFlags(QPdfDocumentRenderOptions::RenderFlag::TextAliased
+                                       | QPdfDocumentRenderOptions::RenderFlag::ImageAliased
+                                       | QPdfDocumentRenderOptions::RenderFlag::PathAliased);
+            }
+
+            image = document->render(key.page, imageSize, options);
+            if (image.isNull())
+                qDebug() << "Unable to render PDF page" << key.page << imageSize;
+            else if (!cacheDir.isEmpty())
+                PdfDiskCache::instance().store(cacheDir, key, image);
+        }
+
+        // Wynik przekazujemy do wątku GUI; stare dokumenty są odrzucane po numerze
+        TaskScheduler::instance().post(this, token, [this, key, image, serial]() {
+            if (serial == documentSerial)
+                emit rendered(key, image);
+        });
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QObject>
+#include <QMutex>                      // Ochrona kolejki zleceń
+#include <QImage>
+#include <QList>
+#include <QHash>
+#include <QVector>
+#include <QPdfDocumentRenderOptions>
+#include <atomic>
+#include "taskscheduler.h"             // Rendery jako zadania wspólnej puli
+
+// Klucz wyrenderowanego fragmentu strony: numer strony, rozmiar całej strony
+// w pikselach urządzenia oraz wycinek (kafelek). Pusty wycinek = cała strona.
+// Szkic (draft) to szybki render bez wygładzania, zastępowany później pełnym renderem.
+struct PdfRenderKey {
+    int page = -1;
+    QSize pageSize;
+    QRect clip;
+    bool draft = false;
+
+    bool operator==(const PdfRenderKey &other) const {
+        return page == other.page && pageSize == other.pageSize && clip == other.clip
+               && draft == other.draft;
+    }
+};
+Q_DECLARE_METATYPE(PdfRenderKey)
+
+inline size_t qHash(const PdfRenderKey &key, size_t seed = 0) {
+    return qHashMulti(seed, key.page, key.pageSize.width(), key.pageSize.height(),
+                      key.clip.x(), key.clip.y(), key.clip.width(), key.clip.height(), key.draft);
+}
+
+// Renderuje strony PDF jako zadania wspólnej puli (TaskScheduler). Zlecenia z requestRenders
+// idą w klasie priority, zapas (prefetch) — klasę niżej; w każdej klasie naraz działa najwyżej
+// maxTasks zadań, a każde bierze kolejne zlecenia z kolejki, dopóki są.
+// Każdy wątek puli ma własną kopię dokumentu (QPdfDocument nie jest bezpieczny wątkowo, więc
+// wątek GUI zostaje przy swojej instancji); kopie są wczytywane przy pierwszym renderze w wątku
+// i zwalniane, gdy żaden renderer nie ma już tego pliku otwartego.
+// Każde wywołanie requestRenders zastępuje kolejkę oczekujących zleceń, dzięki czemu
+// strony, które zniknęły z widoku, nie są już renderowane.
+class PdfRenderer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PdfRenderer(TaskPriority priority = TaskPriority::VisibleNow, int maxTasks = 1,
+                         QObject *parent = nullptr);
+    ~PdfRenderer() override;
+
+    // Dokument kolejnych renderów; pusta ścieżka zamyka dokument
+    void setDocument(const QString &fileName);
+
+    // Zastępuje kolejkę zleceń (kolejność = priorytet, pierwsze renderowane najpierw);
+    // prefetch to strony poza widokiem, renderowane w niższej klasie
+    void requestRenders(const QList<PdfRenderKey> &keys,
+                        const QList<PdfRenderKey> &prefetch = QList<PdfRenderKey>());
+
+    // Przed każdym zleceniem ustępuje pierwszeństwa innemu rendererowi:
+    // dopóki tamten ma pracę, ten czeka (np. miniatury czekają na główny widok)
+    void yieldTo(PdfRenderer *other);
+
+    // Czy są zlecenia w kolejce lub w trakcie renderowania (bezpieczne wątkowo)
+    bool isBusy() const { return busy; }
+
+    // Korzystanie z trwałej pamięci renderów na dysku (PdfDiskCache): przed renderowaniem
+    // sprawdzany jest plik, a nowe rendery są zapisywane w tle. Ustawiane przed setDocument.
+    void setUseDiskCache(bool use) { useDiskCache = use; }
+
+signals:
+    // Wynik renderowania (obraz pusty, jeśli render się nie powiódł)
+    void rendered(const PdfRenderKey &key, const QImage &image);
+
+    // Kolejka opróżniona i żaden wątek nie renderuje
+    void idle();
+
+private:
+    // Kolejka jednej klasy zadań (główna albo zapas)
+    struct Queue {
+        TaskPriority priority;
+        QList<PdfRenderKey> pending;
+        int tasks = 0;                 // Zgłoszone zadania tej kolejki (w puli i w toku)
+    };
+
+    // Wywoływane z zablokowanym mutexem: zgłasza zadania, jeśli jest praca i wolne miejsce
+    void scheduleTasks();
+    void updateBusy();
+
+    // Wykonywane w wątku puli
+    void processQueue(Queue *queue, const CancellationToken &token);
+
+    const int maxTasks;
+    PdfRenderer *yieldTarget = nullptr;
+    bool useDiskCache = false;
+    std::atomic<bool> busy{false};
+    CancellationToken renderToken;     // Anulowany w destruktorze
+
+    QMutex mutex;                      // Chroni pola poniżej
+    Queue queues[2];                   // [0] zlecenia z widoku, [1] zapas
+    QList<PdfRenderKey> inFlight;      // Renderowane w tej chwili
+    QVector<TaskHandle> tasks;         // Zadania, na które czeka destruktor
+    int documentSerial = 0;            // Zwiększany przy każdej zmianie dokumentu
+    QString documentFile;
+    QString documentIdentity;          // Klucz kopii dokumentu w wątkach puli (pusty = brak)
+    QString diskCacheDir;              // Katalog renderów bieżącego dokumentu na dysku
+};
@@ -0,0 +1,273 @@
+#include "pdfsearchindex.h"
+#include "cacheutils.h"
+#include <QPdfDocument>
+#include <QPdfSelection>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QSaveFile>
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// Nagłówek pliku indeksu ("PSIX") i wersja formatu
+constexpr quint32 kIndexMagic = 0x50534958;
+constexpr quint32 kIndexVersion = 1;
+}
+
+PdfSearchIndex::PdfSearchIndex(QObject *parent)
+    : QObject(parent)
+{ }
+
+PdfSearchIndex::~PdfSearchIndex()
+{
+    stop();
+}
+
+void PdfSearchIndex::stop()
+{
+    indexTask.cancel();
+    indexTask.waitForFinished();
+    indexTask = TaskHandle();
+}
+
+void PdfSearchIndex::setDocument(const QString &fileName)
+{
+    stop();
+
+    {
+        QWriteLocker locker(&lock);
+        termIds.clear();
+        terms.clear();
+        postings.clear();
+        pageWords.clear();
+        totalPages = 0;
+        indexedPages = 0;
+    }
+
+    if (fileName.isEmpty())
+        return;
+
+    indexTask = TaskScheduler::instance().submit(TaskPriority::Background, "pdf.search_index",
+                                                 [this, fileName](const CancellationToken &token) {
+        run(fileName, token);
+    });
+}
+
+int PdfSearchIndex::indexedPageCount() const
+{
+    QReadLocker locker(&lock);
+    return indexedPages;
+}
+
+int PdfSearchIndex::pageCount() const
+{
+    QReadLocker locker(&lock);
+    return totalPages;
+}
+
+QVector<PdfSearchIndex::Token> PdfSearchIndex::tokenize(const QString &text)
+{
+    // Słowo = ciąg liter i cyfr; wielkość liter jest ujednolicana (case folding)
+    QVector<Token> tokens;
+    int start = -1;
+    for (int i = 0; i <= text.size(); ++i) {
+        const bool inWord = i < text.size() && text.at(i).isLetterOrNumber();
+        if (inWord && start < 0) {
+            start = i;
+        } else if (!inWord && start >= 0) {
+            tokens.append({ text.mid(start, i - start).toCaseFolded(), start, i - start });
+            start = -1;
+        }
+    }
+    return tokens;
+}
+
+void PdfSearchIndex::run(const QString &fileName, const CancellationToken &token)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Indeks zapisany wcześniej obok pamięci podręcznej stron tego dokumentu
+    const QString indexPath = CacheUtils::cacheDir("pdf/" + CacheUtils::fileIdentityKey(fileName))
+                              + "/search.idx";
+    if (loadFromFile(indexPath)) {
+        qDebug() << "PdfSearchIndex: loaded" << indexPath << "in" << timer.elapsed() << "ms";
+        emit progress(indexedPageCount(), pageCount());
+        emit finished();
+        return;
+    }
+
+    // Osobna instancja dokumentu — QPdfDocument nie jest bezpieczny wątkowo
+    QPdfDocument document;
+    if (document.load(fileName) != QPdfDocument::Error::None) {
+        qDebug() << "PdfSearchIndex: failed to load" << fileName;
+        return;
+    }
+
+    const int count = document.pageCount();
+    {
+        QWriteLocker locker(&lock);
+        totalPages = count;
+        pageWords.resize(count);
+    }
+
+    for (int page = 0; page < count; ++page) {
+        if (token.isCancelled())
+            return;
+
+        // Wyciąganie tekstu i podział na słowa odbywa się bez blokady indeksu
+        addPage(page, tokenize(document.getAllText(page).text()));
+        emit progress(page + 1, count);
+    }
+
+    qDebug() << "PdfSearchIndex: indexed" << count << "pages in" << timer.elapsed() << "ms";
+    saveToFile(indexPath);
+    emit finished();
+}
+
+void PdfSearchIndex::addPage(int page, const QVector<Token> &tokens)
+{
+    QWriteLocker locker(&lock);
+
+    QVector<WordPos> &words = pageWords[page];
+    words.reserve(tokens.size());
+    for (const Token &token : tokens) {
+        quint32 id;
+        auto it = termIds.constFind(token.term);
+        if (it == termIds.constEnd()) {
+            id = quint32(terms.size());
+            termIds.insert(token.term, id);
+            terms.append(token.term);
+            postings.append({});
+        } else {
+            id = it.value();
+        }
+
+        postings[id].append({ page, qint32(words.size()) });
+        words.append({ id, token.charIndex, token.length });
+    }
+
+    indexedPages = page + 1;
+}
+
+QList<PdfSearchHit> PdfSearchIndex::search(const QString &query, int fromPage, int *searchedPages) const
+{
+    const QVector<Token> queryTokens = tokenize(query);
+    QReadLocker locker(&lock);
+    if (searchedPages)
+        *searchedPages = indexedPages;
+    if (queryTokens.isEmpty())
+        return {};
+
+    // Każde słowo zapytania musi już występować w słowniku
+    QVector<quint32> ids;
+    for (const Token &token : queryTokens) {
+        auto it = termIds.constFind(token.term);
+        if (it == termIds.constEnd())
+            return {};
+        ids.append(it.value());
+    }
+
+    // Fraza: kolejne słowa zapytania na kolejnych pozycjach tej samej strony
+    // Wystąpienia są posortowane po stronach — strony przeszukane wcześniej są pomijane od razu
+    const QVector<Posting> &candidates = postings[ids.first()];
+    auto begin = std::lower_bound(candidates.cbegin(), candidates.cend(), fromPage,
+                                  [](const Posting &posting, int page) { return posting.page < page; });
+    QList<PdfSearchHit> hits;
+    for (auto it = begin; it != candidates.cend(); ++it) {
+        const Posting &posting = *it;
+        const QVector<WordPos> &words = pageWords[posting.page];
+        const int lastWord = posting.word + int(ids.size()) - 1;
+        if (lastWord >= words.size())
+            continue;
+
+        bool match = true;
+        for (int i = 1; i < ids.size() && match; ++i)
+            match = words[posting.word + i].term == ids[i];
+        if (!match)
+            continue;
+
+        const WordPos &first = words[posting.word];
+        const WordPos &last = words[lastWord];
+        hits.append({ posting.page, first.charIndex, last.charIndex + last.length - first.charIndex });
+    }
+    return hits;
+}
+
+bool PdfSearchIndex::loadFromFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic, version;
+    qint32 count;
+    QStringList loadedTerms;
+    in >> magic >> version;
+    if (magic != kIndexMagic || version != kIndexVersion)
+        return false;
+    in >> count >> loadedTerms;
+    if (in.status() != QDataStream::Ok || count < 0)
+        return false;
+
+    QVector<QVector<WordPos>> loadedWords(count);
+    for (QVector<WordPos> &words : loadedWords) {
+        qint32 wordCount;
+        in >> wordCount;
+        if (in.status() != QDataStream::Ok || wordCount < 0)
+            return false;
+        words.resize(wordCount);
+        for (WordPos &word : words) {
+            in >> word.term >> word.charIndex >> word.length;
+            if (word.term >= quint32(loadedTerms.size()))
+                return false;
+        }
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    // Wystąpienia odtwarzamy ze słów stron (są tańsze do odbudowania niż do zapisania)
+    QVector<QVector<Posting>> loadedPostings(loadedTerms.size());
+    for (int page = 0; page < count; ++page) {
+        const QVector<WordPos> &words = loadedWords[page];
+        for (int w = 0; w < words.size(); ++w)
+            loadedPostings[words[w].term].append({ page, w });
+    }
+
+    QWriteLocker locker(&lock);
+    terms = loadedTerms;
+    termIds.clear();
+    termIds.reserve(terms.size());
+    for (int i = 0; i < terms.size(); ++i)
+        termIds.insert(terms[i], quint32(i));
+    postings = std::move(loadedPostings);
+    pageWords = std::move(loadedWords);
+    totalPages = count;
+    indexedPages = count;
+    return true;
+}
+
+void PdfSearchIndex::saveToFile(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "PdfSearchIndex: cannot write" << path;
+        return;
+    }
+
+    QDataStream out(&file);
+    QReadLocker locker(&lock);
+    out << kIndexMagic << kIndexVersion << qint32(totalPages) << terms;
+    for (const QVector<WordPos> &words : pageWords) {
+        out << qint32(words.size());
+        for (const WordPos &word : words)
+            out << word.term << word.charIndex << word.length;
+    }
+    locker.unlock();
+
+    file.commit();
+}
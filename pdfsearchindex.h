@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QObject>
+#include "taskscheduler.h"      // Indeksowanie jako zadanie w tle
+#include <QReadWriteLock>       // Zapytania równolegle z indeksowaniem
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+
+// Trafienie wyszukiwania: strona i pozycja znakowa w tekście strony
+// (zgodna z QPdfDocument::getSelectionAtIndex)
+struct PdfSearchHit {
+    int page = -1;
+    int charIndex = 0;
+    int length = 0;
+};
+
+// Pełnotekstowy indeks dokumentu PDF.
+// Tekst stron jest wyciągany stopniowo w zadaniu tła (TaskScheduler, na własnej kopii dokumentu)
+// i trafia do odwróconego indeksu słów z pozycjami. Zapytania można zadawać w trakcie
+// indeksowania — zwracają trafienia ze stron zaindeksowanych do tej pory.
+// Gotowy indeks jest zapisywany w katalogu pamięci podręcznej dokumentu,
+// więc ponowne otwarcie pliku pomija wyciąganie tekstu.
+class PdfSearchIndex : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PdfSearchIndex(QObject *parent = nullptr);
+    ~PdfSearchIndex() override;
+
+    // Rozpoczyna indeksowanie dokumentu (pusta ścieżka tylko czyści indeks)
+    void setDocument(const QString &fileName);
+
+    // Wyszukuje frazę (całe słowa, bez rozróżniania wielkości liter); bezpieczne wątkowo.
+    // fromPage pomija strony przeszukane wcześniej; w searchedPages trafia liczba stron
+    // zaindeksowanych w chwili wyszukiwania (następne wyszukiwanie może zacząć od niej).
+    QList<PdfSearchHit> search(const QString &query, int fromPage = 0, int *searchedPages = nullptr) const;
+
+    // Liczba zaindeksowanych stron i wszystkich stron dokumentu
+    int indexedPageCount() const;
+    int pageCount() const;
+
+signals:
+    // Postęp indeksowania (emitowany z wątku puli)
+    void progress(int indexedPages, int pageCount);
+    void finished();
+
+private:
+    // Słowo na stronie: identyfikator słowa w słowniku i jego pozycja w tekście
+    struct WordPos {
+        quint32 term;
+        qint32 charIndex;
+        qint32 length;
+    };
+
+    // Wystąpienie słowa: strona i numer słowa na stronie
+    struct Posting {
+        qint32 page;
+        qint32 word;
+    };
+
+    // Słowo wyciągnięte z tekstu przed dodaniem do indeksu
+    struct Token {
+        QString term;
+        int charIndex;
+        int length;
+    };
+
+    static QVector<Token> tokenize(const QString &text);
+
+    void stop();
+    void run(const QString &fileName, const CancellationToken &token);
+    void addPage(int page, const QVector<Token> &tokens);
+    bool loadFromFile(const QString &path);
+    void saveToFile(const QString &path) const;
+
+    TaskHandle indexTask;
+
+    mutable QReadWriteLock lock;         // Chroni pola poniżej
+    QHash<QString, quint32> termIds;     // Słowo -> identyfikator
+    QStringList terms;                   // Identyfikator -> słowo
+    QVector<QVector<Posting>> postings;  // Identyfikator -> wystąpienia (rosnąco wg stron)
+    QVector<QVector<WordPos>> pageWords; // Strona -> kolejne słowa
+    int totalPages = 0;
+    int indexedPages = 0;
+};
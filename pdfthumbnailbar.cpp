@@ -0,0 +1,194 @@
+#include "pdfthumbnailbar.h"
+#include <QScrollBar>
+#include <QResizeEvent>
+#include <QColor>
+
+namespace {
+// Szerokość miniatury w pikselach logicznych (wysokość wg proporcji A4)
+constexpr int kThumbnailWidth = 90;
+constexpr int kThumbnailHeight = 127;
+// Limit pamięci podręcznej miniatur w kilobajtach
+constexpr int kThumbnailCacheKb = 16 * 1024;
+// Liczba zadań puli renderujących miniatury naraz (w każdej klasie)
+constexpr int kThumbnailTasks = 2;
+}
+
+PdfThumbnailModel::PdfThumbnailModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    thumbnails.setMaxCost(kThumbnailCacheKb);
+}
+
+void PdfThumbnailModel::setPointSizes(const QVector<QSizeF> &sizes)
+{
+    beginResetModel();
+    pointSizes = sizes;
+    thumbnails.clear();
+    endResetModel();
+}
+
+void PdfThumbnailModel::setThumbnail(int page, const QPixmap &pixmap)
+{
+    if (page < 0 || page >= pointSizes.size())
+        return;
+
+    const qsizetype cost = qMax<qsizetype>(1, qsizetype(pixmap.width()) * pixmap.height() * 4 / 1024);
+    thumbnails.insert(page, new QPixmap(pixmap), cost);
+
+    QModelIndex idx = index(page);
+    emit dataChanged(idx, idx, { Qt::DecorationRole });
+}
+
+int PdfThumbnailModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(pointSizes.size());
+}
+
+QVariant PdfThumbnailModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= pointSizes.size())
+        return QVariant();
+
+    if (role == Qt::DisplayRole)
+        return QString::number(index.row() + 1);
+
+    if (role == Qt::DecorationRole) {
+        if (QPixmap *pixmap = thumbnails.object(index.row()))
+            return *pixmap;
+        return QColor(Qt::white);  // Miejsce na miniaturę do czasu jej wyrenderowania
+    }
+
+    return QVariant();
+}
+
+PdfThumbnailBar::PdfThumbnailBar(QWidget *parent)
+    : QListView(parent),
+      model(new PdfThumbnailModel(this)),
+      renderer(new PdfRenderer(TaskPriority::NextLikely, kThumbnailTasks, this)),
+      scheduleTimer(new QTimer(this))
+{
+    setModel(model);
+
+    // Pionowy pasek ikon z numerem strony pod spodem; stały rozmiar elementów = szybki układ
+    setViewMode(QListView::IconMode);
+    setFlow(QListView::TopToBottom);
+    setWrapping(false);
+    setMovement(QListView::Static);
+    setResizeMode(QListView::Adjust);
+    setUniformItemSizes(true);
+    setIconSize(QSize(kThumbnailWidth, kThumbnailHeight));
+    setSpacing(4);
+    setSelectionMode(QAbstractItemView::SingleSelection);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+
+    scheduleTimer->setSingleShot(true);
+    scheduleTimer->setInterval(30);
+    connect(scheduleTimer, &QTimer::timeout, this, &PdfThumbnailBar::scheduleThumbnails);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, scheduleTimer, qOverload<>(&QTimer::start));
+
+    renderer->setUseDiskCache(true);
+    connect(renderer, &PdfRenderer::rendered, this, &PdfThumbnailBar::onRendered);
+    connect(this, &QListView::clicked, this, [this](const QModelIndex &index) {
+        emit pageActivated(index.row());
+    });
+}
+
+void PdfThumbnailBar::setDocument(QPdfDocument *document, const QString &fileName)
+{
+    QVector<QSizeF> sizes;
+    if (document) {
+        sizes.reserve(document->pageCount());
+        for (int i = 0; i < document->pageCount(); ++i)
+            sizes.append(document->pagePointSize(i));
+    }
+
+    model->setPointSizes(sizes);
+    renderer->setDocument(fileName);
+    scheduleTimer->start();
+}
+
+void PdfThumbnailBar::setCurrentPage(int page)
+{
+    QModelIndex idx = model->index(page);
+    if (!idx.isValid())
+        return;
+
+    setCurrentIndex(idx);
+    scrollTo(idx);
+}
+
+void PdfThumbnailBar::yieldTo(PdfRenderer *mainRenderer)
+{
+    renderer->yieldTo(mainRenderer);
+}
+
+void PdfThumbnailBar::resizeEvent(QResizeEvent *event)
+{
+    QListView::resizeEvent(event);
+    scheduleTimer->start();
+}
+
+QSize PdfThumbnailBar::thumbnailPixelSize(int page) const
+{
+    const QSizeF points = model->pointSize(page);
+    if (points.isEmpty())
+        return QSize();
+
+    const qreal dpr = devicePixelRatioF();
+    return points.scaled(QSizeF(iconSize()) * dpr, Qt::KeepAspectRatio).toSize().expandedTo(QSize(1, 1));
+}
+
+void PdfThumbnailBar::scheduleThumbnails()
+{
+    const int count = model->rowCount();
+    if (count == 0)
+        return;
+
+    // Pierwszy widoczny wiersz — wyszukiwanie binarne (przy stałym rozmiarze elementów
+    // visualRect nie wymaga układania całej listy)
+    int lo = 0, hi = count - 1;
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (visualRect(model->index(mid)).bottom() < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    const int firstVisible = lo;
+    int lastVisible = firstVisible;
+    while (lastVisible + 1 < count
+           && visualRect(model->index(lastVisible + 1)).top() <= viewport()->height())
+        ++lastVisible;
+
+    // Kolejność: widoczne, potem (jako zapas) tyle samo poniżej i powyżej
+    const int margin = lastVisible - firstVisible + 1;
+    QList<int> rows;
+    for (int row = firstVisible; row <= lastVisible; ++row)
+        rows.append(row);
+    for (int row = lastVisible + 1; row <= qMin(count - 1, lastVisible + margin); ++row)
+        rows.append(row);
+    for (int row = firstVisible - 1; row >= qMax(0, firstVisible - margin); --row)
+        rows.append(row);
+
+    QList<PdfRenderKey> keys;
+    QList<PdfRenderKey> prefetch;
+    for (int row : rows) {
+        const QSize pixelSize = thumbnailPixelSize(row);
+        if (!model->hasThumbnail(row) && !pixelSize.isEmpty()) {
+            QList<PdfRenderKey> &target = (row >= firstVisible && row <= lastVisible) ? keys : prefetch;
+            target.append(PdfRenderKey{row, pixelSize, QRect()});
+        }
+    }
+    renderer->requestRenders(keys, prefetch);
+}
+
+void PdfThumbnailBar::onRendered(const PdfRenderKey &key, const QImage &image)
+{
+    if (image.isNull())
+        return;
+
+    QPixmap pixmap = QPixmap::fromImage(image);
+    pixmap.setDevicePixelRatio(devicePixelRatioF());
+    model->setThumbnail(key.page, pixmap);
+}
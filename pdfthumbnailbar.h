@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QListView>                   // Lista wirtualizowana — rysuje tylko widoczne wiersze
+#include <QAbstractListModel>
+#include <QPdfDocument>
+#include <QCache>
+#include <QPixmap>
+#include <QVector>
+#include <QTimer>
+
+#include "pdfrenderer.h"               // Renderowanie miniatur w zadaniach puli
+
+// Model miniatur stron: jeden wiersz na stronę, ikona = miniatura z pamięci podręcznej
+// (do czasu jej wyrenderowania — białe pole)
+class PdfThumbnailModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit PdfThumbnailModel(QObject *parent = nullptr);
+
+    void setPointSizes(const QVector<QSizeF> &sizes);
+    QSizeF pointSize(int page) const { return pointSizes.value(page); }
+
+    void setThumbnail(int page, const QPixmap &pixmap);
+    bool hasThumbnail(int page) const { return thumbnails.contains(page); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    QVector<QSizeF> pointSizes;
+
+    // Miniatury; koszt liczony w kilobajtach
+    QCache<int, QPixmap> thumbnails;
+};
+
+// Pasek miniatur stron w lewym panelu TextViewer.
+// Miniatury są renderowane w niskiej rozdzielczości jako zadania puli: widoczne w klasie NextLikely,
+// sąsiednie w klasie Background. Renderowanie ustępuje pierwszeństwa rendererowi głównej strony.
+// Kliknięcie miniatury przenosi od razu do danej strony.
+class PdfThumbnailBar : public QListView {
+    Q_OBJECT
+
+public:
+    explicit PdfThumbnailBar(QWidget *parent = nullptr);
+
+    void setDocument(QPdfDocument *document, const QString &fileName);
+
+    // Zaznacza miniaturę bieżącej strony i przewija do niej pasek
+    void setCurrentPage(int page);
+
+    // Miniatury czekają, dopóki wskazany renderer ma pracę
+    void yieldTo(PdfRenderer *mainRenderer);
+
+signals:
+    void pageActivated(int page);
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    // Zlecenie renderowania miniatur widocznych wierszy (i marginesu) bez miniatury
+    void scheduleThumbnails();
+    void onRendered(const PdfRenderKey &key, const QImage &image);
+
+    // Rozmiar miniatury strony w pikselach urządzenia (mieści się w iconSize)
+    QSize thumbnailPixelSize(int page) const;
+
+    PdfThumbnailModel *model;
+    PdfRenderer *renderer;
+
+    // Łączy serię zdarzeń przewijania w jedno zlecenie
+    QTimer *scheduleTimer;
+};
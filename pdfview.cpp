@@ -0,0 +1,524 @@
+#include "pdfview.h"
+#include "cacheutils.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QWheelEvent>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+// Odstęp stron od krawędzi widoku i między stronami (piksele logiczne)
+constexpr int kPageMargin = 10;
+// Bok kafelka w pikselach urządzenia
+constexpr int kTileSize = 512;
+// Powyżej tej liczby pikseli strona jest renderowana kafelkami (ok. 16 MB w ARGB32)
+constexpr qint64 kWholePageMaxPixels = 2048 * 2048;
+// Skala szkicu względem pełnego renderu i górny limit jego liczby pikseli
+constexpr double kDraftScale = 0.35;
+constexpr qint64 kDraftMaxPixels = 768 * 768;
+// Granice zoomu użytkownika (jak w ImageViewer)
+constexpr double kMinZoom = 0.1;
+constexpr double kMaxZoom = 10.0;
+}
+
+PdfView::PdfView(QWidget *parent)
+    : QAbstractScrollArea(parent),
+      renderer(new PdfRenderer(TaskPriority::VisibleNow, 1, this))
+{
+    setFocusPolicy(Qt::StrongFocus);
+    horizontalScrollBar()->setSingleStep(20);
+    verticalScrollBar()->setSingleStep(20);
+
+    // Strony odczytane wcześniej wracają z dysku zamiast ponownej rasteryzacji
+    renderer->setUseDiskCache(true);
+    connect(renderer, &PdfRenderer::rendered, this, &PdfView::onRendered);
+}
+
+void PdfView::setDocument(QPdfDocument *doc, const QString &fileName)
+{
+    document = doc;
+    currentPage = 0;
+    userScale = 1.0;
+    documentKey = fileName.isEmpty() ? QString() : CacheUtils::fileIdentityKey(fileName);
+    latestWholePage.clear();
+    highlightPage = -1;
+    highlightBounds.clear();
+
+    // Rozmiary stron odczytujemy raz — układ trybu ciągłego nie wymaga renderowania
+    pointSizes.clear();
+    if (document) {
+        pointSizes.reserve(document->pageCount());
+        for (int i = 0; i < document->pageCount(); ++i)
+            pointSizes.append(document->pagePointSize(i));
+    }
+
+    renderer->setDocument(fileName);
+    relayout();
+    horizontalScrollBar()->setValue(0);
+    verticalScrollBar()->setValue(0);
+    viewport()->update();
+}
+
+void PdfView::setPage(int page)
+{
+    if (page < 0 || page >= pointSizes.size())
+        return;
+
+    currentPage = page;
+    pageTracking = false;
+    if (continuousMode) {
+        // Przewinięcie do początku strony (bez ponownego wyliczania currentPage z pozycji)
+        verticalScrollBar()->setValue(pageRects.value(page).top() - kPageMargin);
+    } else {
+        relayout();
+        horizontalScrollBar()->setValue(0);
+        verticalScrollBar()->setValue(0);
+    }
+    pageTracking = true;
+    viewport()->update();
+}
+
+void PdfView::setContinuous(bool continuous)
+{
+    if (continuousMode == continuous)
+        return;
+
+    continuousMode = continuous;
+    relayout();
+    setPage(currentPage);
+}
+
+void PdfView::showHighlight(int page, const QList<QPolygonF> &bounds)
+{
+    highlightPage = page;
+    highlightBounds = bounds;
+    setPage(page);
+
+    // Przewinięcie tak, by podświetlony obszar znalazł się na środku widoku
+    const int index = page - firstLayoutPage;
+    if (index < 0 || index >= pageRects.size() || bounds.isEmpty())
+        return;
+
+    QRectF pointRect;
+    for (const QPolygonF &polygon : bounds)
+        pointRect |= polygon.boundingRect();
+
+    const QRect pageRect = pageRects[index];
+    const double scale = pageRect.width() / pointSizes[page].width();
+    const QPointF center = QPointF(pageRect.topLeft()) + pointRect.center() * scale;
+
+    QScrollBar *hBar = horizontalScrollBar();
+    QScrollBar *vBar = verticalScrollBar();
+    pageTracking = false;
+    hBar->setValue(qBound(hBar->minimum(), int(center.x() - viewport()->width() / 2), hBar->maximum()));
+    vBar->setValue(qBound(vBar->minimum(), int(center.y() - viewport()->height() / 2), vBar->maximum()));
+    pageTracking = true;
+    viewport()->update();
+}
+
+void PdfView::clearHighlight()
+{
+    highlightPage = -1;
+    highlightBounds.clear();
+    viewport()->update();
+}
+
+void PdfView::zoomIn()
+{
+    QSize vpSz = viewport()->size();
+    zoom(1.25, QPointF(vpSz.width() / 2.0, vpSz.height() / 2.0));
+}
+
+void PdfView::zoomOut()
+{
+    QSize vpSz = viewport()->size();
+    zoom(1.0 / 1.25, QPointF(vpSz.width() / 2.0, vpSz.height() / 2.0));
+}
+
+void PdfView::resetZoom()
+{
+    setZoomFactor(1.0);
+}
+
+void PdfView::setZoomFactor(double factor)
+{
+    userScale = qBound(kMinZoom, factor, kMaxZoom);
+    relayout();
+    setPage(currentPage);
+}
+
+void PdfView::relayout()
+{
+    pageRects.clear();
+    contentSize = QSize();
+
+    const QSize available = viewport()->size() - QSize(2 * kPageMargin, 2 * kPageMargin);
+    if (!pointSizes.isEmpty() && !available.isEmpty()) {
+        if (!continuousMode) {
+            // Jedna strona dopasowana w całości do widoku, potem zoom użytkownika
+            QSizeF points = pointSizes.value(currentPage);
+            if (!points.isEmpty()) {
+                double fit = qMin(available.width() / points.width(),
+                                  available.height() / points.height());
+                QSize size = (points * fit * userScale).toSize().expandedTo(QSize(1, 1));
+                firstLayoutPage = currentPage;
+                pageRects.append(QRect(QPoint(kPageMargin, kPageMargin), size));
+                contentSize = size + QSize(2 * kPageMargin, 2 * kPageMargin);
+            }
+        } else {
+            // Wszystkie strony w jednej skali: najszersza dopasowana do szerokości widoku
+            double maxWidth = 0.0;
+            for (const QSizeF &points : pointSizes)
+                maxWidth = qMax(maxWidth, points.width());
+
+            if (maxWidth > 0.0) {
+                const double scale = available.width() / maxWidth * userScale;
+                const int columnWidth = qRound(maxWidth * scale);
+
+                firstLayoutPage = 0;
+                pageRects.reserve(pointSizes.size());
+                int y = kPageMargin;
+                for (const QSizeF &points : pointSizes) {
+                    QSize size = (points * scale).toSize().expandedTo(QSize(1, 1));
+                    pageRects.append(QRect(kPageMargin + (columnWidth - size.width()) / 2, y,
+                                           size.width(), size.height()));
+                    y += size.height() + kPageMargin;
+                }
+                contentSize = QSize(columnWidth + 2 * kPageMargin, y);
+            }
+        }
+    }
+
+    QSize vpSz = viewport()->size();
+    horizontalScrollBar()->setRange(0, qMax(0, contentSize.width() - vpSz.width()));
+    horizontalScrollBar()->setPageStep(vpSz.width());
+    verticalScrollBar()->setRange(0, qMax(0, contentSize.height() - vpSz.height()));
+    verticalScrollBar()->setPageStep(vpSz.height());
+}
+
+QPoint PdfView::contentOffset() const
+{
+    QSize vpSz = viewport()->size();
+
+    // Treść węższa niż widok jest wyśrodkowana, szersza — przesuwana paskiem
+    int x = (contentSize.width() <= vpSz.width())
+                ? (vpSz.width() - contentSize.width()) / 2
+                : -horizontalScrollBar()->value();
+    int y = -verticalScrollBar()->value();
+    return QPoint(x, y);
+}
+
+QRect PdfView::visibleContentRect() const
+{
+    return QRect(-contentOffset(), viewport()->size());
+}
+
+void PdfView::pagesInRange(int top, int bottom, int *first, int *last) const
+{
+    // Strony są ułożone rosnąco w pionie, więc wystarczy wyszukiwanie binarne
+    auto firstIt = std::lower_bound(pageRects.cbegin(), pageRects.cend(), top,
+                                    [](const QRect &rect, int y) { return rect.bottom() < y; });
+    auto lastIt = std::upper_bound(pageRects.cbegin(), pageRects.cend(), bottom,
+                                   [](int y, const QRect &rect) { return y < rect.top(); });
+    *first = int(firstIt - pageRects.cbegin());
+    *last = int(lastIt - pageRects.cbegin()) - 1;
+}
+
+QList<PdfRenderKey> PdfView::keysForPage(int page, const QRect &pageRect, const QRect &area) const
+{
+    // Rozdzielczość renderu = rozmiar logiczny * devicePixelRatio ekranu
+    const qreal dpr = viewport()->devicePixelRatioF();
+    const QSize pixelSize = (QSizeF(pageRect.size()) * dpr).toSize();
+    if (pixelSize.isEmpty())
+        return {};
+
+    // Mała strona — jeden render całości
+    if (qint64(pixelSize.width()) * pixelSize.height() <= kWholePageMaxPixels)
+        return { PdfRenderKey{page, pixelSize, QRect()} };
+
+    // Duża strona — tylko kafelki przecinające dany obszar
+    QRect visible = area.intersected(pageRect).translated(-pageRect.topLeft());
+    if (visible.isEmpty())
+        return {};
+
+    QRect deviceVisible = QRectF(QPointF(visible.topLeft()) * dpr, QSizeF(visible.size()) * dpr)
+                              .toAlignedRect()
+                              .intersected(QRect(QPoint(0, 0), pixelSize));
+
+    const int firstCol = deviceVisible.left() / kTileSize;
+    const int lastCol = deviceVisible.right() / kTileSize;
+    const int firstRow = deviceVisible.top() / kTileSize;
+    const int lastRow = deviceVisible.bottom() / kTileSize;
+
+    QList<PdfRenderKey> keys;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int col = firstCol; col <= lastCol; ++col) {
+            QRect tileRect = QRect(col * kTileSize, row * kTileSize, kTileSize, kTileSize)
+                                 .intersected(QRect(QPoint(0, 0), pixelSize));
+            keys.append(PdfRenderKey{page, pixelSize, tileRect});
+        }
+    }
+    return keys;
+}
+
+PdfRenderKey PdfView::draftKeyForPage(int page, const QRect &pageRect) const
+{
+    const qreal dpr = viewport()->devicePixelRatioF();
+    double scale = dpr * kDraftScale;
+    const double pixels = double(pageRect.width()) * pageRect.height() * scale * scale;
+    if (pixels > kDraftMaxPixels)
+        scale *= qSqrt(kDraftMaxPixels / pixels);
+
+    const QSize pixelSize = (QSizeF(pageRect.size()) * scale).toSize().expandedTo(QSize(1, 1));
+    return PdfRenderKey{page, pixelSize, QRect(), true};
+}
+
+bool PdfView::hasFallback(int page) const
+{
+    auto it = latestWholePage.constFind(page);
+    return it != latestWholePage.cend() && isCached(it.value());
+}
+
+void PdfView::scheduleRenders()
+{
+    if (pageRects.isEmpty())
+        return;
+
+    const QRect visible = visibleContentRect();
+    QList<PdfRenderKey> drafts;
+    QList<PdfRenderKey> missing;
+
+    // 1) Strony (lub kafelki) w widoku; strony bez żadnego obrazu dostają najpierw szkic
+    int first, last;
+    pagesInRange(visible.top(), visible.bottom(), &first, &last);
+    for (int i = first; i <= last; ++i) {
+        const int page = firstLayoutPage + i;
+        bool incomplete = false;
+        for (const PdfRenderKey &key : keysForPage(page, pageRects[i], visible)) {
+            if (!isCached(key)) {
+                missing.append(key);
+                incomplete = true;
+            }
+        }
+
+        if (incomplete && !hasFallback(page)) {
+            const PdfRenderKey draft = draftKeyForPage(page, pageRects[i]);
+            if (!isCached(draft))
+                drafts.append(draft);
+        }
+    }
+    missing = drafts + missing;
+
+    // 2) Margines — jeden ekran powyżej i poniżej, tylko strony renderowane w całości (zapas)
+    QList<PdfRenderKey> prefetch;
+    const int margin = viewport()->height();
+    int prefetchFirst, prefetchLast;
+    pagesInRange(visible.top() - margin, visible.bottom() + margin, &prefetchFirst, &prefetchLast);
+    for (int i = prefetchFirst; i <= prefetchLast; ++i) {
+        if (i >= first && i <= last)
+            continue;
+        const QList<PdfRenderKey> keys = keysForPage(firstLayoutPage + i, pageRects[i], pageRects[i]);
+        if (keys.size() == 1 && keys.first().clip.isNull() && !isCached(keys.first()))
+            prefetch.append(keys.first());
+    }
+
+    // Kolejka jest zastępowana — strony, które opuściły widok (np. przy szybkim
+    // przełączaniu stron), nie będą renderowane ani w pełnej jakości, ani jako szkic
+    renderer->requestRenders(missing, prefetch);
+}
+
+void PdfView::seedRender(const PdfRenderKey &key, const QImage &image)
+{
+    onRendered(key, image);
+}
+
+QSize PdfView::previewPixelSize(const QSizeF &points, const QSize &viewportSize,
+                                qreal devicePixelRatio, bool continuous)
+{
+    const QSize available = viewportSize - QSize(2 * kPageMargin, 2 * kPageMargin);
+    if (points.isEmpty() || available.isEmpty())
+        return QSize();
+
+    // Tak jak w relayout: cała strona w widoku albo (tryb ciągły) dopasowanie do szerokości
+    double scale = available.width() / points.width();
+    if (!continuous)
+        scale = qMin(scale, available.height() / points.height());
+    scale *= devicePixelRatio;
+
+    // Podgląd nie jest kafelkowany, więc ograniczamy go do progu renderu całej strony
+    const double pixels = points.width() * points.height() * scale * scale;
+    if (pixels > kWholePageMaxPixels)
+        scale *= qSqrt(kWholePageMaxPixels / pixels);
+
+    return (points * scale).toSize().expandedTo(QSize(1, 1));
+}
+
+bool PdfView::isCached(const PdfRenderKey &key) const
+{
+    return PdfRenderCache::instance().contains(documentKey, key);
+}
+
+QImage *PdfView::cachedImage(const PdfRenderKey &key) const
+{
+    return PdfRenderCache::instance().object(documentKey, key);
+}
+
+void PdfView::onRendered(const PdfRenderKey &key, const QImage &image)
+{
+    // Nieudany render też trafia do pamięci (jako pusty obraz), żeby nie ponawiać go w kółko
+    PdfRenderCache::instance().insert(documentKey, key, image);
+
+    // Szkic nie zastępuje pełnego renderu strony, który wciąż jest w pamięci
+    if (key.clip.isNull() && !image.isNull()) {
+        const PdfRenderKey previous = latestWholePage.value(key.page);
+        if (!key.draft || previous.draft || !isCached(previous))
+            latestWholePage.insert(key.page, key);
+    }
+
+    viewport()->update();
+    emit pageRendered(key);
+}
+
+void PdfView::updateCurrentPageFromScroll()
+{
+    if (!continuousMode || !pageTracking || pageRects.isEmpty())
+        return;
+
+    // Bieżąca strona = strona na wysokości górnej 1/3 widoku
+    const QRect visible = visibleContentRect();
+    const int probe = visible.top() + visible.height() / 3;
+    int first, last;
+    pagesInRange(probe, probe, &first, &last);
+
+    const int page = qBound(0, first, int(pageRects.size()) - 1);
+    if (page != currentPage) {
+        currentPage = page;
+        emit currentPageChanged(currentPage);
+    }
+}
+
+void PdfView::zoom(double factor, const QPointF &viewportAnchor)
+{
+    if (pageRects.isEmpty())
+        return;
+
+    double newUserScale = qBound(kMinZoom, userScale * factor, kMaxZoom);
+    if (qFuzzyCompare(newUserScale, userScale))
+        return;
+
+    // Względna pozycja punktu kotwiczenia w treści (0..1)
+    const QPoint offset = contentOffset();
+    double fx = (viewportAnchor.x() - offset.x()) / contentSize.width();
+    double fy = (viewportAnchor.y() - offset.y()) / contentSize.height();
+
+    userScale = newUserScale;
+    relayout();
+
+    // Ten sam punkt treści ma zostać pod punktem kotwiczenia po zmianie skali
+    QScrollBar *hBar = horizontalScrollBar();
+    QScrollBar *vBar = verticalScrollBar();
+    int hNew = int(fx * contentSize.width() - viewportAnchor.x());
+    int vNew = int(fy * contentSize.height() - viewportAnchor.y());
+    hBar->setValue(qBound(hBar->minimum(), hNew, hBar->maximum()));
+    vBar->setValue(qBound(vBar->minimum(), vNew, vBar->maximum()));
+
+    viewport()->update();
+}
+
+void PdfView::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), palette().dark());
+
+    if (!pageRects.isEmpty()) {
+        const qreal dpr = viewport()->devicePixelRatioF();
+        const QPoint offset = contentOffset();
+        const QRect area = event->rect().translated(-offset);  // Odświeżany obszar w układzie treści
+
+        int first, last;
+        pagesInRange(area.top(), area.bottom(), &first, &last);
+        for (int i = first; i <= last; ++i) {
+            const int page = firstLayoutPage + i;
+            const QRect target = pageRects[i].translated(offset);
+            painter.fillRect(target, Qt::white);
+
+            const QList<PdfRenderKey> keys = keysForPage(page, pageRects[i], area);
+
+            // Do czasu nowego renderu rysujemy poprzedni (np. sprzed zmiany zoomu), przeskalowany
+            bool complete = std::all_of(keys.cbegin(), keys.cend(),
+                                        [this](const PdfRenderKey &key) { return isCached(key); });
+            if (!complete && latestWholePage.contains(page)) {
+                if (QImage *fallback = cachedImage(latestWholePage.value(page)))
+                    painter.drawImage(target, *fallback);
+            }
+
+            for (const PdfRenderKey &key : keys) {
+                QImage *image = cachedImage(key);
+                if (!image || image->isNull())
+                    continue;
+
+                if (key.clip.isNull()) {
+                    painter.drawImage(target, *image);
+                } else {
+                    QRectF tileTarget(QPointF(target.topLeft()) + QPointF(key.clip.topLeft()) / dpr,
+                                      QSizeF(key.clip.size()) / dpr);
+                    painter.drawImage(tileTarget, *image);
+                }
+            }
+
+            // Podświetlenie w punktach strony przeliczone na piksele logiczne
+            if (page == highlightPage && !highlightBounds.isEmpty()) {
+                const double scale = target.width() / pointSizes[page].width();
+                painter.save();
+                painter.translate(target.topLeft());
+                painter.scale(scale, scale);
+                painter.setPen(Qt::NoPen);
+                painter.setBrush(QColor(255, 220, 0, 110));
+                for (const QPolygonF &polygon : highlightBounds)
+                    painter.drawPolygon(polygon);
+                painter.restore();
+            }
+        }
+    }
+
+    scheduleRenders();
+}
+
+void PdfView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+
+    // Nowy rozmiar widoku = nowa rozdzielczość renderu (poprzednie wpisy wygasną w LRU).
+    // W trybie ciągłym zachowujemy względną pozycję przewinięcia.
+    const double ratio = contentSize.height() > 0
+                             ? double(verticalScrollBar()->value()) / contentSize.height()
+                             : 0.0;
+    pageTracking = false;
+    relayout();
+    if (continuousMode)
+        verticalScrollBar()->setValue(int(ratio * contentSize.height()));
+    pageTracking = true;
+}
+
+void PdfView::wheelEvent(QWheelEvent *event)
+{
+    // Ctrl + kółko -> zoom wokół kursora, bez Ctrl -> zwykłe przewijanie
+    if (event->modifiers() & Qt::ControlModifier) {
+        if (event->angleDelta().y() > 0) {
+            zoom(1.25, event->position());
+        } else if (event->angleDelta().y() < 0) {
+            zoom(1.0 / 1.25, event->position());
+        }
+        event->accept();
+        return;
+    }
+
+    QAbstractScrollArea::wheelEvent(event);
+}
+
+void PdfView::scrollContentsBy(int, int)
+{
+    updateCurrentPageFromScroll();
+    viewport()->update();
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <QAbstractScrollArea>         // Bazowa klasa widoku z paskami przewijania
+#include <QPdfDocument>                // Dokument PDF (rozmiary stron w punktach)
+#include <QImage>
+#include <QHash>
+#include <QVector>
+#include <QPolygonF>
+
+#include "pdfrenderer.h"               // Renderowanie stron w zadaniach puli
+#include "pdfrendercache.h"            // Wspólny limit pamięci renderów wszystkich dokumentów
+
+// Widok stron PDF.
+// Rozdzielczość renderowania wynika z rozmiaru strony w punktach, rozmiaru widoku,
+// współczynnika zoomu i devicePixelRatio ekranu. Gdy strona w pikselach przekracza
+// próg, renderowane są tylko kafelki widocznego obszaru, a nie cała strona.
+//
+// Strona, dla której nie ma jeszcze żadnego obrazu (np. po przełączeniu), dostaje najpierw
+// szybki szkic w niższej rozdzielczości, a dopiero po nim pełny render.
+//
+// Tryb ciągły układa wszystkie strony jedna pod drugą. Miejsca na strony są wyliczane
+// od razu z ich rozmiarów w punktach, ale renderowane są tylko strony przecinające
+// widok (plus margines). Rendery trafiają do wspólnej pamięci PdfRenderCache, więc po
+// powrocie do wcześniej oglądanego dokumentu widoczne strony są od razu gotowe.
+class PdfView : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    explicit PdfView(QWidget *parent = nullptr);
+
+    // Ustawia dokument (bez przejmowania własności); strona 0 i zoom 1.0.
+    // Ścieżka pliku służy do wczytania kopii dokumentu w wątku renderującym
+    // i identyfikuje rendery dokumentu we wspólnej pamięci podręcznej.
+    void setDocument(QPdfDocument *document, const QString &fileName);
+
+    // Wyświetla wskazaną stronę (indeksowaną od 0) od jej początku
+    void setPage(int page);
+    int page() const { return currentPage; }
+
+    // Przełączanie między widokiem jednej strony a przewijaniem ciągłym
+    void setContinuous(bool continuous);
+    bool isContinuous() const { return continuousMode; }
+
+    // Zoom względem dopasowania strony do widoku
+    // (1.0 = cała strona, a w trybie ciągłym — szerokość strony)
+    void zoomIn();
+    void zoomOut();
+    void resetZoom();
+    void setZoomFactor(double factor);
+    double zoomFactor() const { return userScale; }
+
+    // Renderer stron widoku (np. żeby prace w tle mogły ustępować mu pierwszeństwa)
+    PdfRenderer *pageRenderer() const { return renderer; }
+
+    // Wstawia gotowy render (np. pierwszej strony wyrenderowanej razem z wczytaniem dokumentu).
+    // Jeśli rozmiar nie pasuje do układu, obraz jest rysowany przeskalowany do czasu nowego renderu.
+    void seedRender(const PdfRenderKey &key, const QImage &image);
+
+    // Rozmiar podglądu strony w pikselach urządzenia dla widoku o danym rozmiarze przy zoomie 1.0.
+    // Funkcja bez stanu — można ją wywołać w wątku wczytującym dokument.
+    static QSize previewPixelSize(const QSizeF &points, const QSize &viewportSize,
+                                  qreal devicePixelRatio, bool continuous);
+
+    // Podświetla obszar strony (wielokąty w punktach strony) i przewija widok tak, by był widoczny
+    void showHighlight(int page, const QList<QPolygonF> &bounds);
+    void clearHighlight();
+
+signals:
+    // Zmiana bieżącej strony wynikająca z przewijania w trybie ciągłym
+    void currentPageChanged(int page);
+
+    // Render strony (szkic, całość albo kafelek) trafił do widoku
+    void pageRendered(const PdfRenderKey &key);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    // Przeliczenie położenia stron i zakresów pasków przewijania
+    void relayout();
+
+    // Przesunięcie treści względem viewportu (uwzględnia paski i wyśrodkowanie)
+    QPoint contentOffset() const;
+
+    // Obszar treści widoczny w viewporcie
+    QRect visibleContentRect() const;
+
+    // Zakres indeksów pageRects przecinających pas [top, bottom] treści
+    void pagesInRange(int top, int bottom, int *first, int *last) const;
+
+    // Klucze renderów potrzebnych do pokrycia obszaru area strony (whole page lub kafelki)
+    QList<PdfRenderKey> keysForPage(int page, const QRect &pageRect, const QRect &area) const;
+
+    // Klucz szybkiego szkicu całej strony (niższa rozdzielczość, bez wygładzania)
+    PdfRenderKey draftKeyForPage(int page, const QRect &pageRect) const;
+
+    // Czy dla strony jest w pamięci jakikolwiek obraz do narysowania w zastępstwie
+    bool hasFallback(int page) const;
+
+    // Aktualizacja kolejki renderowania: widoczne strony najpierw, potem margines
+    void scheduleRenders();
+
+    // Dostęp do renderów bieżącego dokumentu we wspólnej pamięci podręcznej
+    bool isCached(const PdfRenderKey &key) const;
+    QImage *cachedImage(const PdfRenderKey &key) const;
+
+    // Odbiór gotowego renderu z wątku roboczego
+    void onRendered(const PdfRenderKey &key, const QImage &image);
+
+    // Aktualizacja currentPage na podstawie pozycji przewijania (tryb ciągły)
+    void updateCurrentPageFromScroll();
+
+    // Zoom wokół punktu viewportu (analogicznie do ImageViewer::zoom)
+    void zoom(double factor, const QPointF &viewportAnchor);
+
+    QPdfDocument *document = nullptr;
+    QString documentKey;               // Tożsamość pliku — klucz w PdfRenderCache
+    PdfRenderer *renderer;
+
+    int currentPage = 0;
+    bool continuousMode = false;
+
+    // Wyłączane na czas przewijania wywołanego przez setPage lub zmianę rozmiaru,
+    // żeby pozycja paska nie nadpisywała strony wybranej przez użytkownika
+    bool pageTracking = true;
+
+    // Dodatkowy zoom zadany przez użytkownika
+    double userScale = 1.0;
+
+    // Rozmiary wszystkich stron w punktach (odczytane raz po ustawieniu dokumentu)
+    QVector<QSizeF> pointSizes;
+
+    // Położenie stron w układzie treści; pageRects[i] to strona firstLayoutPage + i
+    QVector<QRect> pageRects;
+    int firstLayoutPage = 0;
+    QSize contentSize;
+
+    // Podświetlenie (np. trafienie wyszukiwania) w układzie punktów strony
+    int highlightPage = -1;
+    QList<QPolygonF> highlightBounds;
+
+    // Ostatni render całej strony (pełny lub szkic) — rysowany w zastępstwie do czasu nowego renderu
+    QHash<int, PdfRenderKey> latestWholePage;
+};
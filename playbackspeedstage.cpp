@@ -0,0 +1,258 @@
+#include "playbackspeedstage.h"
+#include <QAudioBuffer>
+#include <QAudioFormat>
+#include <QAudioSink>
+#include <QDebug>
+#include <algorithm>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+#include <QAudioBufferOutput>
+#define PLAYBACKSPEEDSTAGE_BUFFER_OUTPUT
+#endif
+
+namespace {
+// Bufor wyjścia dźwięku (opóźnienie etapu) i skok znacznika czasu uznawany za przewinięcie
+constexpr double kSinkBufferSeconds = 0.2;
+// Zapas na wynik, który chwilowo nie mieści się w wyjściu
+constexpr double kPendingSeconds = 0.2;
+constexpr qint64 kDiscontinuityUs = 100000;
+}
+
+PlaybackSpeedStage::PlaybackSpeedStage(QObject *parent)
+    : QObject(parent)
+{
+    audioContext = new QObject();
+    audioContext->moveToThread(&audioThread);
+    connect(&audioThread, &QThread::finished, audioContext, &QObject::deleteLater);
+    audioThread.setObjectName("PlaybackSpeed");
+    audioThread.start(QThread::TimeCriticalPriority);
+}
+
+PlaybackSpeedStage::~PlaybackSpeedStage()
+{
+    deactivate();
+    audioThread.quit();
+    audioThread.wait();
+}
+
+bool PlaybackSpeedStage::isSupported()
+{
+#ifdef PLAYBACKSPEEDSTAGE_BUFFER_OUTPUT
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PlaybackSpeedStage::attach(QMediaPlayer *newPlayer, QAudioOutput *newOutput, QAudioBufferOutput *newBufferOutput)
+{
+    deactivate();
+    player = newPlayer;
+    output = newOutput;
+    bufferOutput = newBufferOutput;
+    if (player)
+        player->setPlaybackRate(currentSpeed);
+    if (currentSpeed != 1.0)
+        activate();
+}
+
+void PlaybackSpeedStage::setSpeed(double speed)
+{
+    currentSpeed = std::clamp(speed, TimeStretcher::kMinSpeed, TimeStretcher::kMaxSpeed);
+    stretcher.setSpeed(currentSpeed);           // Od następnego okna, bez przełączania ścieżki
+    if (player)
+        player->setPlaybackRate(currentSpeed);
+    if (currentSpeed != 1.0)
+        activate();
+}
+
+void PlaybackSpeedStage::activate()
+{
+#ifdef PLAYBACKSPEEDSTAGE_BUFFER_OUTPUT
+    if (active || !player || !output || !bufferOutput)
+        return;
+
+    active = true;
+    resetRequested = true;
+    volume = output->volume();
+    outputDevice = output->device();
+    connect(output, &QAudioOutput::volumeChanged, this, [this](float value) { volume = value; });
+    output->setMuted(true);
+
+    // Bufory idą kolejką wprost do wątku dźwięku
+    bufferConnection = connect(bufferOutput, &QAudioBufferOutput::audioBufferReceived, audioContext,
+                               [this](const QAudioBuffer &buffer) { processBuffer(buffer); });
+#endif
+}
+
+void PlaybackSpeedStage::deactivate()
+{
+    if (!active)
+        return;
+
+    active = false;
+    disconnect(bufferConnection);
+    if (output) {
+        disconnect(output, nullptr, this, nullptr);
+        output->setMuted(false);
+    }
+    QMetaObject::invokeMethod(audioContext, [this]() { closeSink(); }, Qt::BlockingQueuedConnection);
+}
+
+void PlaybackSpeedStage::openSink(int sampleRate, int channels)
+{
+    closeSink();
+
+    // Ten sam rodzaj urządzenia co wyjście odtwarzacza; float, a gdy nieobsługiwany — 16 bit
+    const QAudioDevice device = outputDevice;
+    QAudioFormat format;
+    format.setSampleRate(sampleRate);
+    format.setChannelCount(channels);
+    format.setSampleFormat(QAudioFormat::Float);
+    sinkFloat = device.isFormatSupported(format);
+    if (!sinkFloat)
+        format.setSampleFormat(QAudioFormat::Int16);
+
+    // Przydział buforów tylko tutaj (zmiana formatu), nie przy każdym buforze
+    stretcher.configure(sampleRate, channels);     // Prędkość zostaje
+    inputSamples.resize(size_t(TimeStretcher::kMaxBlockFrames) * channels);
+    outputSamples.resize(size_t(stretcher.maxOutputFrames(TimeStretcher::kMaxBlockFrames)) * channels);
+    outputInt16.resize(sinkFloat ? 0 : outputSamples.size());
+    frameBytes = format.bytesPerFrame();
+    pending.resize(size_t(format.bytesForDuration(qint64(kPendingSeconds * 1e6)) / frameBytes * frameBytes));
+    pendingHead = pendingSize = 0;
+
+    sink = new QAudioSink(device, format, audioContext);
+    sink->setBufferSize(qsizetype(format.bytesForDuration(qint64(kSinkBufferSeconds * 1e6))));
+    sink->setVolume(volume);
+    sinkDevice = sink->start();
+    qDebug().noquote() << QString("[speed] sink rate=%1 channels=%2 format=%3")
+                              .arg(sampleRate).arg(channels).arg(sinkFloat ? "float" : "int16");
+}
+
+void PlaybackSpeedStage::closeSink()
+{
+    if (!sink)
+        return;
+    sink->stop();
+    delete sink;
+    sink = nullptr;
+    sinkDevice = nullptr;
+    expectedStartUs = -1;
+    pendingHead = pendingSize = 0;
+}
+
+void PlaybackSpeedStage::drainPending()
+{
+    while (pendingSize > 0) {
+        // Tylko całe ramki — inaczej kolejne zapisy przesunęłyby kanały i próbki
+        const qint64 free = sink->bytesFree() / frameBytes * frameBytes;
+        const qint64 chunk = qMin(qint64(qMin(pendingSize, pending.size() - pendingHead)), free);
+        if (chunk <= 0)
+            return;
+        const qint64 written = sinkDevice->write(pending.data() + pendingHead, chunk);
+        if (written <= 0)
+            return;
+        pendingHead = (pendingHead + size_t(written)) % pending.size();
+        pendingSize -= size_t(written);
+    }
+}
+
+void PlaybackSpeedStage::writeToSink(const char *data, qint64 bytes)
+{
+    drainPending();
+
+    // Wprost do wyjścia tylko wtedy, gdy nic nie czeka — kolejność próbek zostaje zachowana
+    qint64 offset = 0;
+    if (pendingSize == 0) {
+        const qint64 free = sink->bytesFree() / frameBytes * frameBytes;
+        if (free > 0)
+            offset = qMax<qint64>(0, sinkDevice->write(data, qMin(bytes, free)));
+    }
+
+    // Reszta czeka na miejsce w wyjściu; nadmiar ponad zapas (wyjście trwale nie nadąża)
+    // jest pomijany całymi ramkami
+    const qint64 room = qint64(pending.size() - pendingSize);
+    const qint64 rest = qMin(bytes - offset, room) / frameBytes * frameBytes;
+    for (qint64 copied = 0; copied < rest; ) {
+        const size_t tail = (pendingHead + pendingSize) % pending.size();
+        const qint64 chunk = qMin(rest - copied, qint64(pending.size() - tail));
+        std::copy_n(data + offset + copied, chunk, pending.data() + tail);
+        pendingSize += size_t(chunk);
+        copied += chunk;
+    }
+}
+
+void PlaybackSpeedStage::processBuffer(const QAudioBuffer &buffer)
+{
+    if (!active)
+        return;     // Bufor z kolejki sprzed wyłączenia
+
+    const QAudioFormat format = buffer.format();
+    const int channels = format.channelCount();
+    const int frames = int(buffer.frameCount());
+    if (channels <= 0 || frames <= 0)
+        return;
+
+    if (!sink || stretcher.sampleRate() != format.sampleRate() || stretcher.channels() != channels)
+        openSink(format.sampleRate(), channels);
+    if (!sinkDevice)
+        return;
+
+    // Przewinięcie albo nowy plik — okna nie łączą się z poprzednim fragmentem
+    const bool jump = expectedStartUs >= 0 && qAbs(buffer.startTime() - expectedStartUs) > kDiscontinuityUs;
+    if (resetRequested.exchange(false) || jump) {
+        stretcher.reset();
+        pendingHead = pendingSize = 0;      // Zaległy dźwięk sprzed przewinięcia
+    }
+    expectedStartUs = buffer.startTime() + buffer.duration();
+
+    if (sink->volume() != volume)
+        sink->setVolume(volume);
+
+    for (int done = 0; done < frames; done += TimeStretcher::kMaxBlockFrames) {
+        const int block = qMin(TimeStretcher::kMaxBlockFrames, frames - done);
+        const int samples = block * channels;
+        float *in = inputSamples.data();
+        const int offset = done * channels;
+
+        switch (format.sampleFormat()) {
+        case QAudioFormat::Float:
+            std::copy_n(buffer.constData<float>() + offset, samples, in);
+            break;
+        case QAudioFormat::Int16: {
+            const qint16 *src = buffer.constData<qint16>() + offset;
+            for (int i = 0; i < samples; ++i)
+                in[i] = src[i] / 32768.0f;
+            break;
+        }
+        case QAudioFormat::Int32: {
+            const qint32 *src = buffer.constData<qint32>() + offset;
+            for (int i = 0; i < samples; ++i)
+                in[i] = float(src[i] / 2147483648.0);
+            break;
+        }
+        case QAudioFormat::UInt8: {
+            const quint8 *src = buffer.constData<quint8>() + offset;
+            for (int i = 0; i < samples; ++i)
+                in[i] = (src[i] - 128) / 128.0f;
+            break;
+        }
+        default:
+            return;
+        }
+
+        const int written = stretcher.process(in, block, outputSamples.data()) * channels;
+        const char *data = reinterpret_cast<const char *>(outputSamples.data());
+        qint64 bytes = qint64(written) * sizeof(float);
+        if (!sinkFloat) {
+            for (int i = 0; i < written; ++i)
+                outputInt16[i] = qint16(qBound(-32768, qRound(outputSamples[i] * 32767.0f), 32767));
+            data = reinterpret_cast<const char *>(outputInt16.data());
+            bytes = qint64(written) * sizeof(qint16);
+        }
+
+        // Wyjście nie nadąża (np. chwilowo po zmianie prędkości) — reszta czeka w pending
+        writeToSink(data, bytes);
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QObject>
+#include <QThread>              // Wątek przetwarzania dźwięku
+#include <QPointer>
+#include <QMediaPlayer>
+#include <QAudioOutput>
+#include <QAudioDevice>
+#include <vector>
+#include <atomic>
+
+#include "timestretcher.h"      // WSOLA
+
+class QAudioBuffer;
+class QAudioBufferOutput;
+class QAudioSink;
+class QIODevice;
+
+// Odtwarzanie z prędkością 0.5×–3× bez zmiany wysokości dźwięku.
+// Odtwarzacz gra z zadaną prędkością, ale jego wyjście audio jest wyciszone; zdekodowane bufory
+// (QAudioBufferOutput) trafiają do wątku dźwięku, gdzie TimeStretcher przywraca im czas
+// rzeczywisty, a wynik idzie do własnego QAudioSink na tym samym urządzeniu i z tą samą
+// głośnością co wyjście odtwarzacza. Po pierwszym włączeniu etap zostaje aktywny do zmiany
+// utworu (także przy 1×), więc kolejne zmiany prędkości nie przełączają ścieżki dźwięku.
+// Wymaga Qt 6.8 (QAudioBufferOutput) — w starszych wersjach zmienia się tylko prędkość
+// odtwarzacza (wysokość dźwięku zależy wtedy od backendu).
+class PlaybackSpeedStage : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PlaybackSpeedStage(QObject *parent = nullptr);
+    ~PlaybackSpeedStage() override;
+
+    static bool isSupported();
+
+    // Odtwarzacz, jego wyjście audio i podgląd buforów (odtwarzacz ma tylko jeden
+    // QAudioBufferOutput — współdzielony z wizualizacją); zmiana przy zamianie zestawów
+    void attach(QMediaPlayer *player, QAudioOutput *output, QAudioBufferOutput *bufferOutput);
+
+    void setSpeed(double speed);
+    double speed() const { return currentSpeed; }
+
+private:
+    void activate();
+    void deactivate();
+
+    // Wątek dźwięku
+    void processBuffer(const QAudioBuffer &buffer);
+    void openSink(int sampleRate, int channels);
+    void closeSink();
+    // Zapis całych ramek: najpierw zaległości z pending, to, co się nie zmieści, czeka w pending
+    void writeToSink(const char *data, qint64 bytes);
+    void drainPending();
+
+    QPointer<QMediaPlayer> player;
+    QPointer<QAudioOutput> output;
+    QAudioBufferOutput *bufferOutput = nullptr;
+    QMetaObject::Connection bufferConnection;
+    QAudioDevice outputDevice;          // Urządzenie wyjścia odtwarzacza (odczyt w wątku dźwięku)
+    double currentSpeed = 1.0;
+    std::atomic<bool> active{false};
+
+    QThread audioThread;
+    QObject *audioContext;              // Obiekt w wątku dźwięku (odbiorca buforów)
+    std::atomic<float> volume{1.0f};
+    std::atomic<bool> resetRequested{false};
+
+    // Używane tylko w wątku dźwięku; bufory przydzielane przy otwarciu wyjścia
+    TimeStretcher stretcher;
+    QAudioSink *sink = nullptr;
+    QIODevice *sinkDevice = nullptr;
+    bool sinkFloat = true;              // Format wyjścia: float albo 16 bit
+    std::vector<float> inputSamples;
+    std::vector<float> outputSamples;
+    std::vector<qint16> outputInt16;
+    std::vector<char> pending;          // Bufor cykliczny wyniku, który nie zmieścił się w wyjściu
+    size_t pendingHead = 0;
+    size_t pendingSize = 0;
+    int frameBytes = 0;                 // Bajty ramki wyjścia (kanały × próbka)
+    qint64 expectedStartUs = -1;        // Początek następnego bufora (wykrywanie przewinięć)
+};
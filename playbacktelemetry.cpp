@@ -0,0 +1,318 @@
+#include "playbacktelemetry.h"
+#include "cacheutils.h"          // Czas procesora procesu
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMediaMetaData>
+#include <QMediaFormat>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// Okres pomiaru sekundowego
+constexpr int kSampleIntervalMs = 1000;
+// Skok znacznika czasu większy niż to (albo wstecz) = przewinięcie, nie zgubione klatki
+constexpr qint64 kDiscontinuityUs = 1000000;
+
+double percentile(QVector<float> values, double p)
+{
+    if (values.isEmpty())
+        return 0.0;
+    const int k = qBound(0, int(p * (values.size() - 1) + 0.5), int(values.size()) - 1);
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+}
+
+double TelemetrySession::jitterPercentile(double p) const
+{
+    return percentile(jitterMs, p);
+}
+
+double TelemetrySession::stepLatencyPercentile(double p) const
+{
+    return percentile(stepLatencyMs, p);
+}
+
+PlaybackTelemetry::PlaybackTelemetry(QObject *parent)
+    : QObject(parent)
+{
+    clock.start();
+    sampleTimer = new QTimer(this);
+    sampleTimer->setInterval(kSampleIntervalMs);
+    connect(sampleTimer, &QTimer::timeout, this, &PlaybackTelemetry::takeSample);
+}
+
+void PlaybackTelemetry::attach(QMediaPlayer *newPlayer, QVideoSink *newSink)
+{
+    if (player)
+        disconnect(player, nullptr, this, nullptr);
+    if (sink)
+        disconnect(sink, nullptr, this, nullptr);
+
+    player = newPlayer;
+    sink = newSink;
+    if (sink)
+        connect(sink, &QVideoSink::videoFrameChanged, this, &PlaybackTelemetry::onVideoFrame);
+    if (player) {
+        connect(player, &QMediaPlayer::sourceChanged, this, &PlaybackTelemetry::startSession);
+        connect(player, &QMediaPlayer::playbackStateChanged, this, &PlaybackTelemetry::onPlaybackStateChanged);
+        connect(player, &QMediaPlayer::metaDataChanged, this, [this]() {
+            const QMediaMetaData meta = player->metaData();
+            const QSize resolution = meta.value(QMediaMetaData::Resolution).toSize();
+            const QVariant codec = meta.value(QMediaMetaData::VideoCodec);
+            session.videoFormat = QString("%1x%2").arg(resolution.width()).arg(resolution.height());
+            if (codec.isValid())
+                session.videoFormat += " " + QMediaFormat::videoCodecName(codec.value<QMediaFormat::VideoCodec>());
+        });
+    }
+
+    // Przy zamianie zestawów nowy odtwarzacz gra już inny plik — nowa sesja
+    if (player && player->source().toLocalFile() != session.fileName)
+        startSession();
+    onPlaybackStateChanged(player ? player->playbackState() : QMediaPlayer::StoppedState);
+}
+
+void PlaybackTelemetry::startSession()
+{
+    finishSession();
+
+    session = TelemetrySession();
+    session.fileName = player ? player->source().toLocalFile() : QString();
+    session.started = QDateTime::currentDateTime();
+    resetTiming();
+}
+
+void PlaybackTelemetry::finishSession()
+{
+    if (session.fileName.isEmpty()
+        || (session.frames == 0 && session.mediaMs == 0 && session.stepLatencyMs.isEmpty()))
+        return;
+
+    qDebug().noquote() << QString("[telemetry] file=%1 frames=%2 dropped=%3 late=%4 jitter_p95_ms=%5 drift_max_ms=%6 cpu_ms_per_s=%7")
+                              .arg(QFileInfo(session.fileName).fileName()).arg(session.frames)
+                              .arg(session.dropped).arg(session.late)
+                              .arg(session.jitterPercentile(0.95), 0, 'f', 2)
+                              .arg(session.driftMaxMs, 0, 'f', 1)
+                              .arg(session.cpuMsPerMediaSecond(), 0, 'f', 0);
+    if (!session.stepLatencyMs.isEmpty()) {
+        qDebug().noquote() << QString("[telemetry] file=%1 steps=%2 cache_hits=%3 step_p50_ms=%4 step_p95_ms=%5 target_ms=%6")
+                                  .arg(QFileInfo(session.fileName).fileName()).arg(session.stepLatencyMs.size())
+                                  .arg(session.stepCacheHits)
+                                  .arg(session.stepLatencyPercentile(0.5), 0, 'f', 2)
+                                  .arg(session.stepLatencyPercentile(0.95), 0, 'f', 2)
+                                  .arg(session.stepTargetMs, 0, 'f', 2);
+    }
+    finishedSessions.append(session);
+}
+
+void PlaybackTelemetry::resetTiming()
+{
+    lastPtsUs = -1;
+    lastArrivalNs = -1;
+    anchorNs = -1;
+    anchorPtsUs = -1;
+
+    sampleFrames = 0;
+    sampleDropped = 0;
+    sampleLate = 0;
+    sampleJitter.clear();
+    sampleDriftSum = 0;
+    sampleDriftCount = 0;
+    sampleStartNs = clock.nsecsElapsed();
+    sampleStartCpuMs = CacheUtils::processCpuTimeMs();
+    sampleStartPositionMs = player ? player->position() : 0;
+}
+
+void PlaybackTelemetry::onPlaybackStateChanged(QMediaPlayer::PlaybackState state)
+{
+    // Pauza przerywa rytm klatek — pomiar od nowa po wznowieniu
+    resetTiming();
+    if (state == QMediaPlayer::PlayingState)
+        sampleTimer->start();
+    else
+        sampleTimer->stop();
+}
+
+void PlaybackTelemetry::onVideoFrame(const QVideoFrame &frame)
+{
+    if (!player || !frame.isValid() || frame.startTime() < 0
+        || player->playbackState() != QMediaPlayer::PlayingState)
+        return;
+
+    const qint64 nowNs = clock.nsecsElapsed();
+    const qint64 ptsUs = frame.startTime();
+    const double rate = qMax(0.01, player->playbackRate());
+
+    if (frame.endTime() > ptsUs)
+        frameIntervalUs = frame.endTime() - ptsUs;
+
+    if (lastPtsUs >= 0) {
+        const qint64 ptsDelta = ptsUs - lastPtsUs;
+        if (ptsDelta <= 0 || ptsDelta > kDiscontinuityUs) {
+            // Przewinięcie — nowy punkt odniesienia
+            anchorNs = -1;
+        } else {
+            if (frameIntervalUs <= 0)
+                frameIntervalUs = ptsDelta;
+
+            // Luka w znacznikach czasu = klatki zdekodowane za późno i pominięte
+            const int missing = qRound(double(ptsDelta) / frameIntervalUs) - 1;
+            if (missing > 0) {
+                session.dropped += missing;
+                sampleDropped += missing;
+            }
+
+            // Jitter: odstęp między pojawieniem się klatek a odstęp ich znaczników czasu
+            const double jitter = qAbs((nowNs - lastArrivalNs) / 1e6 - ptsDelta / 1e3 / rate);
+            session.jitterMs.append(float(jitter));
+            sampleJitter.append(float(jitter));
+        }
+    }
+    lastPtsUs = ptsUs;
+    lastArrivalNs = nowNs;
+
+    // Spóźnienie względem punktu odniesienia; klatka wcześniejsza niż oczekiwano przesuwa punkt
+    if (anchorNs < 0) {
+        anchorNs = nowNs;
+        anchorPtsUs = ptsUs;
+    }
+    double latenessMs = ((nowNs - anchorNs) - (ptsUs - anchorPtsUs) * 1000 / rate) / 1e6;
+    if (latenessMs < 0) {
+        anchorNs = nowNs - qint64((ptsUs - anchorPtsUs) * 1000 / rate);
+        latenessMs = 0;
+    }
+    if (frameIntervalUs > 0 && latenessMs > frameIntervalUs / 1e3) {
+        ++session.late;
+        ++sampleLate;
+    }
+
+    // Przesunięcie obrazu względem zegara odtwarzacza (sterowanego dźwiękiem)
+    const double driftMs = ptsUs / 1e3 - player->position();
+    session.driftSumMs += driftMs;
+    session.driftMaxMs = qMax(session.driftMaxMs, qAbs(driftMs));
+    ++session.driftCount;
+    sampleDriftSum += driftMs;
+    ++sampleDriftCount;
+
+    ++session.frames;
+    ++sampleFrames;
+}
+
+void PlaybackTelemetry::takeSample()
+{
+    if (!player)
+        return;
+
+    const qint64 nowNs = clock.nsecsElapsed();
+    const qint64 cpuMs = CacheUtils::processCpuTimeMs();
+    const qint64 positionMs = player->position();
+    const double wallSeconds = (nowNs - sampleStartNs) / 1e9;
+    // Przewinięcie w trakcie sekundy nie jest odtworzonymi mediami
+    const qint64 mediaMs = qBound<qint64>(0, positionMs - sampleStartPositionMs,
+                                          qint64(wallSeconds * 1500 * player->playbackRate()));
+
+    TelemetrySample sample;
+    sample.positionMs = positionMs;
+    sample.fps = wallSeconds > 0 ? sampleFrames / wallSeconds : 0;
+    sample.dropped = sampleDropped;
+    sample.late = sampleLate;
+    sample.jitterP95Ms = percentile(sampleJitter, 0.95);
+    sample.driftMs = sampleDriftCount > 0 ? sampleDriftSum / sampleDriftCount : 0;
+    sample.cpuMsPerMediaSecond = mediaMs > 0 ? (cpuMs - sampleStartCpuMs) * 1000.0 / mediaMs : 0;
+    session.samples.append(sample);
+    session.cpuMs += cpuMs - sampleStartCpuMs;
+    session.mediaMs += mediaMs;
+
+    sampleFrames = 0;
+    sampleDropped = 0;
+    sampleLate = 0;
+    sampleJitter.clear();
+    sampleDriftSum = 0;
+    sampleDriftCount = 0;
+    sampleStartNs = nowNs;
+    sampleStartCpuMs = cpuMs;
+    sampleStartPositionMs = positionMs;
+    emit sampled();
+}
+
+void PlaybackTelemetry::recordStep(double latencyMs, bool fromCache, double targetMs)
+{
+    session.stepLatencyMs.append(float(latencyMs));
+    if (fromCache)
+        ++session.stepCacheHits;
+    session.stepTargetMs = targetMs;
+    emit sampled();     // W pauzie nie ma pomiarów sekundowych — nakładka odświeża się po kroku
+}
+
+QString PlaybackTelemetry::summaryText() const
+{
+    const TelemetrySample last = session.samples.isEmpty() ? TelemetrySample() : session.samples.last();
+    return QString("%1  %2\n"
+                   "fps %3   frames %4   dropped %5   late %6\n"
+                   "jitter p95 %7 ms (session %8 ms)\n"
+                   "A/V drift %9 ms (max %10 ms)\n"
+                   "CPU %11 ms / media s (session %12)")
+        .arg(QFileInfo(session.fileName).fileName(), session.videoFormat.isEmpty() ? "audio" : session.videoFormat)
+        .arg(last.fps, 0, 'f', 1).arg(session.frames).arg(session.dropped).arg(session.late)
+        .arg(last.jitterP95Ms, 0, 'f', 2).arg(session.jitterPercentile(0.95), 0, 'f', 2)
+        .arg(last.driftMs, 0, 'f', 1).arg(session.driftMaxMs, 0, 'f', 1)
+        .arg(last.cpuMsPerMediaSecond, 0, 'f', 0).arg(session.cpuMsPerMediaSecond(), 0, 'f', 0)
+        + (session.stepLatencyMs.isEmpty() ? QString() :
+           QString("\nframe step %1 ms (p95 %2 ms, target %3 ms)   cached %4/%5")
+               .arg(session.stepLatencyMs.last(), 0, 'f', 1).arg(session.stepLatencyPercentile(0.95), 0, 'f', 1)
+               .arg(session.stepTargetMs, 0, 'f', 1).arg(session.stepCacheHits).arg(session.stepLatencyMs.size()));
+}
+
+bool PlaybackTelemetry::exportSessions(const QString &fileName) const
+{
+    QVector<TelemetrySession> sessions = finishedSessions;
+    if (!session.fileName.isEmpty())
+        sessions.append(session);
+
+    QJsonArray sessionArray;
+    for (const TelemetrySession &s : sessions) {
+        QJsonArray sampleArray;
+        for (const TelemetrySample &sample : s.samples) {
+            sampleArray.append(QJsonObject{
+                { "position_ms", sample.positionMs },
+                { "fps", sample.fps },
+                { "dropped", sample.dropped },
+                { "late", sample.late },
+                { "jitter_p95_ms", sample.jitterP95Ms },
+                { "drift_ms", sample.driftMs },
+                { "cpu_ms_per_media_s", sample.cpuMsPerMediaSecond }
+            });
+        }
+        sessionArray.append(QJsonObject{
+            { "file", s.fileName },
+            { "started", s.started.toString(Qt::ISODate) },
+            { "video_format", s.videoFormat },
+            { "frames", s.frames },
+            { "dropped", s.dropped },
+            { "late", s.late },
+            { "jitter_p50_ms", s.jitterPercentile(0.5) },
+            { "jitter_p95_ms", s.jitterPercentile(0.95) },
+            { "jitter_max_ms", s.jitterPercentile(1.0) },
+            { "drift_mean_ms", s.driftCount > 0 ? s.driftSumMs / s.driftCount : 0.0 },
+            { "drift_max_ms", s.driftMaxMs },
+            { "cpu_ms_per_media_s", s.cpuMsPerMediaSecond() },
+            { "step_count", int(s.stepLatencyMs.size()) },
+            { "step_cache_hits", s.stepCacheHits },
+            { "step_p50_ms", s.stepLatencyPercentile(0.5) },
+            { "step_p95_ms", s.stepLatencyPercentile(0.95) },
+            { "step_target_ms", s.stepTargetMs },
+            { "samples", sampleArray }
+        });
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "PlaybackTelemetry: cannot write" << fileName;
+        return false;
+    }
+    file.write(QJsonDocument(QJsonObject{ { "sessions", sessionArray } }).toJson());
+    return true;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+#include <QMediaPlayer>
+#include <QVideoSink>            // Podgląd klatek trafiających do widoku wideo
+#include <QVideoFrame>
+
+// Pomiar jednej sekundy odtwarzania
+struct TelemetrySample {
+    qint64 positionMs = 0;      // Pozycja w utworze na końcu sekundy
+    double fps = 0;             // Klatki pokazane w tej sekundzie
+    int dropped = 0;            // Klatki pominięte (luka w znacznikach czasu)
+    int late = 0;               // Klatki spóźnione o więcej niż jedną klatkę
+    double jitterP95Ms = 0;     // Odchylenie odstępów między klatkami (95. percentyl)
+    double driftMs = 0;         // Średnie przesunięcie obrazu względem zegara dźwięku (+ = obraz za wcześnie)
+    double cpuMsPerMediaSecond = 0; // Czas procesora aplikacji na sekundę odtworzonych mediów
+};
+
+// Statystyki odtwarzania jednego pliku
+struct TelemetrySession {
+    QString fileName;
+    QDateTime started;
+    QString videoFormat;        // Np. "1920x1080 H.264"
+    qint64 frames = 0;
+    qint64 dropped = 0;
+    qint64 late = 0;
+    QVector<float> jitterMs;    // Odchylenie każdego odstępu między klatkami
+    double driftSumMs = 0;
+    double driftMaxMs = 0;      // Największe |przesunięcie|
+    qint64 driftCount = 0;
+    qint64 cpuMs = 0;
+    qint64 mediaMs = 0;
+    QVector<TelemetrySample> samples;
+
+    // Krokowanie klatka po klatce: czas od polecenia do wyświetlenia klatki
+    QVector<float> stepLatencyMs;
+    int stepCacheHits = 0;      // Kroki obsłużone z pamięci klatek (bez dekodowania)
+    double stepTargetMs = 0;    // Cel: jedna klatka ekranu
+
+    double jitterPercentile(double p) const;
+    double stepLatencyPercentile(double p) const;
+    double cpuMsPerMediaSecond() const { return mediaMs > 0 ? cpuMs * 1000.0 / mediaMs : 0.0; }
+};
+
+// Telemetria odtwarzania: podłączona do QVideoSink widoku wideo (obok QVideoWidget, który dalej
+// rysuje klatki) mierzy rytm klatek, luki, spóźnienia i przesunięcie obrazu względem pozycji
+// odtwarzacza (zegar dźwięku), a co sekundę czas procesora zużyty przez proces.
+// Każdy odtwarzany plik to osobna sesja; sesje można zapisać do pliku JSON.
+class PlaybackTelemetry : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PlaybackTelemetry(QObject *parent = nullptr);
+
+    // Mierzony odtwarzacz i sink jego widoku wideo (zmiana przy zamianie zestawów odtwarzacza)
+    void attach(QMediaPlayer *player, QVideoSink *sink);
+
+    const TelemetrySession &currentSession() const { return session; }
+
+    // Krok o jedną klatkę: opóźnienie, czy klatka pochodziła z pamięci, cel (okres odświeżania ekranu)
+    void recordStep(double latencyMs, bool fromCache, double targetMs);
+
+    // Tekst do nakładki na obraz
+    QString summaryText() const;
+
+    // Zapis wszystkich sesji (zakończonych i bieżącej) do JSON
+    bool exportSessions(const QString &fileName) const;
+
+signals:
+    // Nowy pomiar sekundowy
+    void sampled();
+
+private:
+    void onVideoFrame(const QVideoFrame &frame);
+    void onPlaybackStateChanged(QMediaPlayer::PlaybackState state);
+    void takeSample();
+    void startSession();
+    void finishSession();
+
+    // Zegar odniesienia od nowa (pauza, przewinięcie)
+    void resetTiming();
+
+    QPointer<QMediaPlayer> player;
+    QPointer<QVideoSink> sink;
+
+    TelemetrySession session;
+    QVector<TelemetrySession> finishedSessions;
+
+    QElapsedTimer clock;
+    QTimer *sampleTimer;
+
+    // Poprzednia klatka i punkt odniesienia: czas ściany odpowiadający znacznikowi anchorPtsUs
+    qint64 lastPtsUs = -1;
+    qint64 lastArrivalNs = -1;
+    qint64 anchorNs = -1;
+    qint64 anchorPtsUs = -1;
+    qint64 frameIntervalUs = 0;
+
+    // Stan bieżącej sekundy
+    int sampleFrames = 0;
+    int sampleDropped = 0;
+    int sampleLate = 0;
+    QVector<float> sampleJitter;
+    double sampleDriftSum = 0;
+    int sampleDriftCount = 0;
+    qint64 sampleStartNs = 0;
+    qint64 sampleStartCpuMs = 0;
+    qint64 sampleStartPositionMs = 0;
+};
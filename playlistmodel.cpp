@@ -0,0 +1,489 @@
+#include "playlistmodel.h"
+#include "medialibrary.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QStringDecoder>
+#include <QUrl>
+#include <QColor>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Liczba plików dopisywanych do modelu naraz w trakcie importu;
+// pierwsza partia jest mała, żeby pierwsze wiersze pojawiły się od razu
+constexpr int kImportBatchSize = 1000;
+constexpr int kFirstBatchSize = 64;
+// Bufor nazw jest kompaktowany, gdy luki przekraczają połowę jego rozmiaru
+constexpr double kCompactThreshold = 0.5;
+
+// Format binarny: nagłówek, katalogi (długość + UTF-8), bufor nazw, tablica pozycji
+constexpr quint32 kPlaylistMagic = 0x51504C31;     // "QPL1"
+constexpr quint32 kPlaylistVersion = 1;
+
+struct FileHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 byteOrder;        // QSysInfo::ByteOrder zapisującego — pozycje są zapisane wprost z pamięci
+    quint32 directoryCount;
+    quint64 entryCount;
+    quint64 directoryBytes;
+    quint64 nameBytes;
+};
+
+// Ścieżka z wiersza playlisty: URL pliku, adres sieciowy albo ścieżka (względna wobec playlisty).
+// Bez sprawdzania, czy plik istnieje.
+QString resolveEntry(const QString &entry, const QString &baseDir)
+{
+    if (entry.startsWith("file:", Qt::CaseInsensitive))
+        return QUrl(entry).toLocalFile();
+    if (entry.contains("://"))
+        return entry;
+
+    QString path = entry;
+    path.replace('\\', '/');
+    if (QDir::isRelativePath(path))
+        path = baseDir + '/' + path;
+    return QDir::cleanPath(path);
+}
+}
+
+struct PlaylistModel::ImportBatch {
+    PlaylistModel *model;
+    CancellationToken token;
+    QStringList paths;
+    int added = 0;
+    int limit = kFirstBatchSize;
+    QElapsedTimer timer;
+    qint64 firstRowsMs = -1;
+
+    ImportBatch(PlaylistModel *m, const CancellationToken &t) : model(m), token(t) { timer.start(); }
+
+    bool cancelled() const { return token.isCancelled(); }
+
+    void add(const QString &path)
+    {
+        paths.append(path);
+        if (paths.size() >= limit)
+            flush();
+    }
+
+    // Partia trafia do modelu w wątku GUI (zadanie w tle nie dotyka modelu);
+    // partie przerwanego importu są pomijane (anulowany token)
+    void flush()
+    {
+        if (paths.isEmpty())
+            return;
+        if (firstRowsMs < 0)
+            firstRowsMs = timer.elapsed();
+
+        added += int(paths.size());
+        PlaylistModel *target = model;
+        const int total = added;
+        TaskScheduler::instance().post(model, token, [target, total, batch = std::move(paths)]() {
+            target->append(batch);
+            emit target->importProgress(total);
+        });
+        paths = QStringList();
+        paths.reserve(kImportBatchSize);
+        limit = kImportBatchSize;
+    }
+};
+
+PlaylistModel::PlaylistModel(QObject *parent)
+    : QAbstractListModel(parent)
+{ }
+
+PlaylistModel::~PlaylistModel()
+{
+    cancelImport();
+}
+
+bool PlaylistModel::isMediaFile(const QString &fileName)
+{
+    static const QStringList suffixes = {
+        "mp3", "mp4", "m4a", "wav", "flac", "ogg", "opus", "aac",
+        "avi", "mkv", "mov", "webm"
+    };
+    const int dot = fileName.lastIndexOf('.');
+    return dot >= 0 && suffixes.contains(fileName.mid(dot + 1), Qt::CaseInsensitive);
+}
+
+int PlaylistModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant PlaylistModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= count())
+        return QVariant();
+
+    // Tekst powstaje dopiero przy wyświetlaniu — widok pyta tylko o widoczne wiersze
+    switch (role) {
+    case Qt::DisplayRole:
+        if (library) {
+            const QString title = library->displayTitle(filePath(index.row()));
+            if (!title.isEmpty())
+                return title;
+        }
+        return fileName(index.row());
+    case Qt::ToolTipRole:
+        return fileExists(index.row()) ? filePath(index.row()) : filePath(index.row()) + " (missing)";
+    case Qt::ForegroundRole:
+        // Brakujący plik wyszarzony — sprawdzane tylko dla wyświetlanych wierszy
+        return fileExists(index.row()) ? QVariant() : QVariant(QColor("#6B7090"));
+    case Qt::UserRole:
+        return filePath(index.row());
+    default:
+        return QVariant();
+    }
+}
+
+void PlaylistModel::setLibrary(const MediaLibrary *newLibrary)
+{
+    library = newLibrary;
+    refreshTitles();
+}
+
+void PlaylistModel::refreshTitles()
+{
+    if (!entries.empty())
+        emit dataChanged(index(0), index(count() - 1), { Qt::DisplayRole });
+}
+
+QString PlaylistModel::fileName(int row) const
+{
+    const Entry &entry = entries[row];
+    return QString::fromUtf8(names.constData() + entry.nameOffset, entry.nameLength);
+}
+
+QString PlaylistModel::filePath(int row) const
+{
+    if (row < 0 || row >= count())
+        return QString();
+    return directories[entries[row].directory] + '/' + fileName(row);
+}
+
+quint32 PlaylistModel::internDirectory(const QString &directory)
+{
+    auto it = directoryIds.constFind(directory);
+    if (it != directoryIds.constEnd())
+        return it.value();
+
+    const quint32 id = quint32(directories.size());
+    directories.append(directory);
+    directoryIds.insert(directory, id);
+    return id;
+}
+
+void PlaylistModel::append(const QStringList &paths)
+{
+    if (paths.isEmpty())
+        return;
+
+    const int first = count();
+    beginInsertRows(QModelIndex(), first, first + int(paths.size()) - 1);
+    entries.reserve(entries.size() + paths.size());
+    for (const QString &path : paths) {
+        const int slash = path.lastIndexOf('/');
+        const QByteArray name = path.mid(slash + 1).toUtf8();
+        entries.push_back({ internDirectory(path.left(qMax(0, slash))),
+                            quint32(names.size()), quint32(name.size()) });
+        names.append(name);
+    }
+    existence.resize(entries.size(), 0);
+    endInsertRows();
+}
+
+bool PlaylistModel::removeRows(int row, int rowCount, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || rowCount <= 0 || row + rowCount > count())
+        return false;
+
+    beginRemoveRows(QModelIndex(), row, row + rowCount - 1);
+    for (int i = row; i < row + rowCount; ++i)
+        unusedNameBytes += entries[i].nameLength;
+    entries.erase(entries.begin() + row, entries.begin() + row + rowCount);
+    existence.erase(existence.begin() + row, existence.begin() + row + rowCount);
+    endRemoveRows();
+
+    if (unusedNameBytes > names.size() * kCompactThreshold)
+        compactNames();
+    return true;
+}
+
+void PlaylistModel::compactNames()
+{
+    QByteArray compacted;
+    compacted.reserve(names.size() - unusedNameBytes);
+    for (Entry &entry : entries) {
+        const quint32 offset = quint32(compacted.size());
+        compacted.append(names.constData() + entry.nameOffset, entry.nameLength);
+        entry.nameOffset = offset;
+    }
+    names = compacted;
+    unusedNameBytes = 0;
+}
+
+void PlaylistModel::clear()
+{
+    cancelImport();
+
+    beginResetModel();
+    entries.clear();
+    entries.shrink_to_fit();
+    existence.clear();
+    existence.shrink_to_fit();
+    names.clear();
+    unusedNameBytes = 0;
+    directories.clear();
+    directoryIds.clear();
+    endResetModel();
+}
+
+qint64 PlaylistModel::memoryUsage() const
+{
+    // Pozycje i bufor nazw + katalogi (tekst UTF-16 i wpis w słowniku z kopią klucza)
+    qint64 bytes = qint64(entries.capacity()) * sizeof(Entry) + existence.capacity() + names.capacity();
+    for (const QString &directory : directories)
+        bytes += 2 * (directory.capacity() * 2 + 32);
+    return bytes;
+}
+
+double PlaylistModel::bytesPerEntry() const
+{
+    return entries.empty() ? 0.0 : double(memoryUsage()) / entries.size();
+}
+
+bool PlaylistModel::fileExists(int row) const
+{
+    if (row < 0 || row >= count())
+        return false;
+    if (existence[row] == 0) {
+        const QString path = filePath(row);
+        existence[row] = (path.contains("://") || QFileInfo::exists(path)) ? 1 : 2;
+    }
+    return existence[row] == 1;
+}
+
+void PlaylistModel::cancelImport()
+{
+    importTask.cancel();
+    importTask.waitForFinished();
+    importTask = TaskHandle();
+}
+
+void PlaylistModel::startImport(const QString &source, const std::function<void(ImportBatch &)> &scan)
+{
+    cancelImport();
+
+    importTask = TaskScheduler::instance().submit(TaskPriority::NextLikely, "playlist.import",
+                                                  [this, source, scan](const CancellationToken &token) {
+        ImportBatch batch(this, token);
+        scan(batch);
+        batch.flush();
+
+        const int added = batch.added;
+        const qint64 elapsed = batch.timer.elapsed();
+        const qint64 firstRowsMs = batch.firstRowsMs;
+        // Po ostatniej partii; pomijane, gdy import przerwano albo zastąpił go nowy
+        TaskScheduler::instance().post(this, token, [this, source, added, elapsed, firstRowsMs]() {
+            importTask = TaskHandle();
+            qDebug().noquote() << QString("[playlist-import] source=%1 files=%2 first_rows_ms=%3 ms=%4 entries=%5 bytes_per_entry=%6")
+                                      .arg(QFileInfo(source).fileName()).arg(added).arg(firstRowsMs).arg(elapsed)
+                                      .arg(count()).arg(bytesPerEntry(), 0, 'f', 1);
+            emit importFinished(added, elapsed);
+        });
+    });
+}
+
+void PlaylistModel::importFolder(const QString &directory)
+{
+    startImport(directory, [directory](ImportBatch &batch) {
+        // Przejście w głąb z sortowaniem: pliki katalogu po nazwie, potem jego podkatalogi
+        QStringList pending = { directory };
+        while (!pending.isEmpty() && !batch.cancelled()) {
+            const QDir dir(pending.takeLast());
+
+            const QStringList files = dir.entryList(QDir::Files | QDir::Readable,
+                                                    QDir::Name | QDir::IgnoreCase);
+            for (const QString &file : files) {
+                if (isMediaFile(file))
+                    batch.add(dir.absoluteFilePath(file));
+            }
+
+            QStringList subdirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable,
+                                                QDir::Name | QDir::IgnoreCase);
+            std::reverse(subdirs.begin(), subdirs.end());   // Stos — pierwszy po nazwie na wierzchu
+            for (const QString &subdir : subdirs)
+                pending.append(dir.absoluteFilePath(subdir));
+        }
+    });
+}
+
+void PlaylistModel::importPlaylist(const QString &fileName)
+{
+    startImport(fileName, [fileName](ImportBatch &batch) { parsePlaylist(fileName, batch); });
+}
+
+void PlaylistModel::parsePlaylist(const QString &fileName, ImportBatch &batch)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "PlaylistModel: cannot open" << fileName;
+        return;
+    }
+
+    const QFileInfo info(fileName);
+    const QString baseDir = info.absolutePath();
+    const bool pls = info.suffix().compare("pls", Qt::CaseInsensitive) == 0;
+
+    // M3U8 i PLS to UTF-8; stare M3U bywa w kodowaniu systemowym — przełączamy się po pierwszym
+    // wierszu, który nie jest poprawnym UTF-8
+    bool utf8 = true;
+    bool firstLine = true;
+    while (!file.atEnd() && !batch.cancelled()) {
+        QByteArray line = file.readLine().trimmed();
+        if (firstLine && line.startsWith("\xEF\xBB\xBF"))
+            line.remove(0, 3);
+        firstLine = false;
+        if (line.isEmpty())
+            continue;
+
+        if (pls) {
+            // Tylko wiersze "FileN=ścieżka"; Title/Length i nagłówek są pomijane
+            const int eq = int(line.indexOf('='));
+            if (!line.startsWith("File") || eq < 0)
+                continue;
+            line = line.mid(eq + 1).trimmed();
+        } else if (line.startsWith('#')) {
+            continue;   // #EXTM3U, #EXTINF i komentarze
+        }
+
+        QString entry;
+        if (utf8) {
+            QStringDecoder decoder(QStringDecoder::Utf8);
+            entry = decoder(line);
+            utf8 = !decoder.hasError();
+        }
+        if (!utf8)
+            entry = QString::fromLocal8Bit(line);
+
+        batch.add(resolveEntry(entry, baseDir));
+    }
+}
+
+bool PlaylistModel::save(const QString &fileName) const
+{
+    // Bufor nazw bez luk po usuniętych pozycjach
+    QByteArray nameData;
+    std::vector<Entry> saved = entries;
+    if (unusedNameBytes > 0) {
+        nameData.reserve(names.size() - unusedNameBytes);
+        for (Entry &entry : saved) {
+            const quint32 offset = quint32(nameData.size());
+            nameData.append(names.constData() + entry.nameOffset, entry.nameLength);
+            entry.nameOffset = offset;
+        }
+    } else {
+        nameData = names;
+    }
+
+    QByteArray directoryData;
+    for (const QString &directory : directories) {
+        const QByteArray utf8 = directory.toUtf8();
+        const quint32 length = quint32(utf8.size());
+        directoryData.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        directoryData.append(utf8);
+    }
+
+    const FileHeader header = {
+        kPlaylistMagic, kPlaylistVersion, quint32(QSysInfo::ByteOrder), quint32(directories.size()),
+        quint64(saved.size()), quint64(directoryData.size()), quint64(nameData.size())
+    };
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "PlaylistModel: cannot write" << fileName;
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(directoryData);
+    file.write(nameData);
+    file.write(reinterpret_cast<const char *>(saved.data()), qint64(saved.size() * sizeof(Entry)));
+    return file.commit();
+}
+
+bool PlaylistModel::load(const QString &fileName)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray data = file.readAll();     // Cały plik jednym odczytem
+
+    FileHeader header;
+    if (data.size() < qsizetype(sizeof(header)))
+        return false;
+    std::memcpy(&header, data.constData(), sizeof(header));
+    const quint64 expected = sizeof(header) + header.directoryBytes + header.nameBytes
+                             + header.entryCount * sizeof(Entry);
+    if (header.magic != kPlaylistMagic || header.version != kPlaylistVersion
+        || header.byteOrder != quint32(QSysInfo::ByteOrder) || expected != quint64(data.size())) {
+        qDebug() << "PlaylistModel: invalid playlist file" << fileName;
+        return false;
+    }
+
+    const char *p = data.constData() + sizeof(header);
+    const char *directoriesEnd = p + header.directoryBytes;
+    QStringList loadedDirectories;
+    loadedDirectories.reserve(header.directoryCount);
+    for (quint32 i = 0; i < header.directoryCount; ++i) {
+        quint32 length;
+        if (directoriesEnd - p < qsizetype(sizeof(length)))
+            return false;
+        std::memcpy(&length, p, sizeof(length));
+        p += sizeof(length);
+        if (directoriesEnd - p < qsizetype(length))
+            return false;
+        loadedDirectories.append(QString::fromUtf8(p, length));
+        p += length;
+    }
+    if (p != directoriesEnd)
+        return false;
+
+    QByteArray loadedNames(p, qsizetype(header.nameBytes));
+    p += header.nameBytes;
+
+    std::vector<Entry> loadedEntries(header.entryCount);
+    std::memcpy(loadedEntries.data(), p, header.entryCount * sizeof(Entry));
+    for (const Entry &entry : loadedEntries) {
+        if (entry.directory >= header.directoryCount
+            || quint64(entry.nameOffset) + entry.nameLength > header.nameBytes)
+            return false;
+    }
+
+    cancelImport();
+    beginResetModel();
+    entries = std::move(loadedEntries);
+    existence.assign(entries.size(), 0);
+    names = loadedNames;
+    unusedNameBytes = 0;
+    directories = loadedDirectories;
+    directoryIds.clear();
+    directoryIds.reserve(directories.size());
+    for (int i = 0; i < directories.size(); ++i)
+        directoryIds.insert(directories[i], quint32(i));
+    endResetModel();
+
+    qDebug().noquote() << QString("[playlist-load] entries=%1 bytes=%2 ms=%3")
+                              .arg(count()).arg(data.size()).arg(timer.elapsed());
+    return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QAbstractListModel>   // Model listy dla widoku QListView
+#include <QByteArray>
+#include <QHash>
+#include <QStringList>
+#include "taskscheduler.h"
+#include <functional>
+#include <vector>
+
+class MediaLibrary;
+
+// Playlista przechowywana w zwartej, ciągłej pamięci.
+// Ścieżka pliku jest dzielona na katalog i nazwę: katalogi są zapisywane raz (internowane),
+// a nazwy plików trafiają do jednego wspólnego bufora UTF-8. Pozycja playlisty to tylko
+// 12 bajtów (identyfikator katalogu + położenie nazwy w buforze), więc 100 tys. utworów
+// zajmuje kilka megabajtów, a nie setki tysięcy osobnych obiektów na stercie.
+// Istnienie plików jest sprawdzane dopiero dla wierszy, które widok wyświetla (lub odtwarzanych).
+class PlaylistModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit PlaylistModel(QObject *parent = nullptr);
+    ~PlaylistModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    // Biblioteka, z której pochodzą nazwy utworów (tytuł z metadanych zamiast nazwy pliku)
+    void setLibrary(const MediaLibrary *library);
+    // Nazwy wyświetlane zmieniły się (np. po skanowaniu biblioteki)
+    void refreshTitles();
+
+    int count() const { return int(entries.size()); }
+    QString filePath(int row) const;
+    QString fileName(int row) const;
+
+    // Dodanie plików na koniec playlisty
+    void append(const QStringList &paths);
+    void clear();
+
+    // Czy plik pozycji istnieje (sprawdzane raz, przy pierwszym pytaniu)
+    bool fileExists(int row) const;
+
+    // Rekurencyjny import plików multimedialnych z folderu w tle.
+    // Pliki są dopisywane partiami w trakcie skanowania.
+    void importFolder(const QString &directory);
+
+    // Strumieniowy import playlisty M3U/M3U8/PLS w tle: plik jest czytany linia
+    // po linii, a pierwsze pozycje pojawiają się po kilkudziesięciu wierszach
+    void importPlaylist(const QString &fileName);
+
+    // Zapis i odczyt w zwartym formacie binarnym (obraz pamięci modelu, odczyt jednym read)
+    bool save(const QString &fileName) const;
+    bool load(const QString &fileName);
+
+    void cancelImport();
+    bool isImporting() const { return importTask.isValid(); }
+
+    // Pamięć zajmowana przez playlistę (bajty) i średnio na pozycję
+    qint64 memoryUsage() const;
+    double bytesPerEntry() const;
+
+    // Czy rozszerzenie pliku oznacza obsługiwany plik audio/wideo
+    static bool isMediaFile(const QString &fileName);
+
+signals:
+    // Postęp i koniec importu folderu lub playlisty
+    void importProgress(int addedFiles);
+    void importFinished(int addedFiles, qint64 elapsedMs);
+
+private:
+    struct Entry {
+        quint32 directory;   // Indeks w directories
+        quint32 nameOffset;  // Położenie nazwy w names (UTF-8)
+        quint32 nameLength;
+    };
+
+    // Zbieranie ścieżek w zadaniu importu i przekazywanie ich partiami do modelu
+    struct ImportBatch;
+
+    quint32 internDirectory(const QString &directory);
+
+    void startImport(const QString &source, const std::function<void(ImportBatch &)> &scan);
+    static void parsePlaylist(const QString &fileName, ImportBatch &batch);
+
+    // Usunięcie nieużywanych nazw z bufora, gdy po usuwaniu pozycji zostaje w nim dużo luk
+    void compactNames();
+
+    std::vector<Entry> entries;
+    // Stan pliku pozycji: 0 = nie sprawdzono, 1 = istnieje, 2 = brak
+    mutable std::vector<quint8> existence;
+    QByteArray names;
+    qint64 unusedNameBytes = 0;
+
+    QStringList directories;
+    QHash<QString, quint32> directoryIds;
+
+    const MediaLibrary *library = nullptr;
+
+    TaskHandle importTask;
+};
@@ -0,0 +1,264 @@
+#include "scrubthumbnails.h"
+#include "cacheutils.h"
+#include <QMutexLocker>
+#include <QMediaPlayer>
+#include <QVideoSink>
+#include <QVideoFrame>
+#include <QEventLoop>
+#include <QTimer>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QUrl>
+#include <QDebug>
+
+namespace {
+constexpr quint32 kThumbsMagic = 0x53435242;    // "SCRB"
+constexpr quint32 kThumbsVersion = 1;
+// Najwyżej tyle miniatur na film, nie gęściej niż co 2 s
+constexpr qint64 kMaxThumbnails = 600;
+constexpr qint64 kMinIntervalMs = 2000;
+// Szerokość miniatury w pikselach i jakość JPEG
+constexpr int kThumbnailWidth = 192;
+constexpr int kJpegQuality = 75;
+// Limity czasu na wczytanie filmu i na klatkę po przewinięciu
+constexpr int kLoadTimeoutMs = 10000;
+constexpr int kFrameTimeoutMs = 3000;
+// Co tyle czekanie na film lub klatkę sprawdza anulowanie (stop() czeka na zadanie w wątku GUI)
+constexpr int kCancelPollMs = 50;
+}
+
+ScrubThumbnailIndex::ScrubThumbnailIndex(QObject *parent)
+    : QObject(parent)
+{ }
+
+ScrubThumbnailIndex::~ScrubThumbnailIndex()
+{
+    stop();
+}
+
+void ScrubThumbnailIndex::stop()
+{
+    buildTask.cancel();
+    buildTask.waitForFinished();
+    buildTask = TaskHandle();
+}
+
+void ScrubThumbnailIndex::setSource(const QString &fileName)
+{
+    if (fileName == source)
+        return;
+
+    stop();
+    source = fileName;
+    cachePath.clear();
+
+    QMutexLocker locker(&mutex);
+    intervalMs = 0;
+    thumbnails.clear();
+    complete = false;
+}
+
+void ScrubThumbnailIndex::ensureBuilt()
+{
+    if (source.isEmpty() || buildTask.isValid())
+        return;
+    {
+        QMutexLocker locker(&mutex);
+        if (complete)
+            return;
+    }
+
+    if (cachePath.isEmpty())
+        cachePath = CacheUtils::cacheDir("media/" + CacheUtils::fileIdentityKey(source)) + "/scrub.thumbs";
+
+    // Podgląd przy przewijaniu — potrzebny za chwilę, ale nie przed tym, co już widać
+    const QString fileName = source;
+    buildTask = TaskScheduler::instance().submit(TaskPriority::NextLikely, "media.scrub_thumbnails",
+                                                 [this, fileName](const CancellationToken &token) {
+        run(fileName, token);
+    });
+}
+
+QImage ScrubThumbnailIndex::thumbnailAt(qint64 positionMs) const
+{
+    QByteArray jpeg;
+    {
+        QMutexLocker locker(&mutex);
+        if (intervalMs <= 0 || thumbnails.isEmpty())
+            return QImage();
+
+        // Najbliższa gotowa miniatura (przy kolejności zgrubnej zawsze jakaś jest w pobliżu)
+        const int target = qBound(0, int((positionMs + intervalMs / 2) / intervalMs), int(thumbnails.size()) - 1);
+        for (int distance = 0; distance < thumbnails.size() && jpeg.isEmpty(); ++distance) {
+            if (target - distance >= 0 && !thumbnails[target - distance].isEmpty())
+                jpeg = thumbnails[target - distance];
+            else if (target + distance < thumbnails.size() && !thumbnails[target + distance].isEmpty())
+                jpeg = thumbnails[target + distance];
+        }
+    }
+    return QImage::fromData(jpeg, "JPEG");
+}
+
+void ScrubThumbnailIndex::run(const QString &fileName, const CancellationToken &token)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (loadFromFile(cachePath)) {
+        emit thumbnailReady();
+        QMutexLocker locker(&mutex);
+        if (complete)
+            return;
+    }
+
+    QMediaPlayer player;
+    QVideoSink sink;
+    player.setVideoSink(&sink);
+
+    QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    connect(&player, &QMediaPlayer::mediaStatusChanged, &loop, [&](QMediaPlayer::MediaStatus status) {
+        if (status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::InvalidMedia)
+            loop.quit();
+    });
+    QTimer cancelPoll;
+    connect(&cancelPoll, &QTimer::timeout, &loop, [&]() {
+        if (token.isCancelled())
+            loop.quit();
+    });
+    cancelPoll.start(kCancelPollMs);
+
+    player.setSource(QUrl::fromLocalFile(fileName));
+    if (player.mediaStatus() == QMediaPlayer::LoadingMedia) {
+        timeout.start(kLoadTimeoutMs);
+        loop.exec();
+    }
+    if (token.isCancelled())
+        return;
+    const qint64 duration = player.duration();
+    if (player.mediaStatus() != QMediaPlayer::LoadedMedia || !player.hasVideo() || duration <= 0)
+        return;
+
+    int count;
+    qint64 interval;
+    {
+        QMutexLocker locker(&mutex);
+        if (intervalMs <= 0) {
+            intervalMs = qMax(kMinIntervalMs, duration / kMaxThumbnails);
+            thumbnails.resize(int(duration / intervalMs) + 1);
+        }
+        count = int(thumbnails.size());
+        interval = intervalMs;
+    }
+
+    // Kolejność od zgrubnej do dokładnej: co 16., potem środki przedziałów (co 8.) itd.
+    QVector<int> order;
+    order.reserve(count);
+    const int top = 16;
+    for (int i = 0; i < count; i += top)
+        order.append(i);
+    for (int step = top / 2; step >= 1; step /= 2) {
+        for (int i = step; i < count; i += 2 * step)
+            order.append(i);
+    }
+
+    // Przewinięcie w pauzie dekoduje i wysyła do sinka jedną klatkę z nowej pozycji
+    QVideoFrame captured;
+    qint64 targetMs = 0;
+    connect(&sink, &QVideoSink::videoFrameChanged, &loop, [&](const QVideoFrame &frame) {
+        if (!frame.isValid())
+            return;
+        // Klatka sprzed przewinięcia — czekamy dalej (do limitu czasu)
+        if (qAbs(frame.startTime() / 1000 - targetMs) <= qMax(interval, qint64(5000))) {
+            captured = frame;
+            loop.quit();
+        }
+    });
+    player.pause();
+
+    int generated = 0;
+    for (int index : order) {
+        if (token.isCancelled())
+            break;
+        {
+            QMutexLocker locker(&mutex);
+            if (!thumbnails[index].isEmpty())
+                continue;
+        }
+
+        captured = QVideoFrame();
+        targetMs = index * interval;
+        player.setPosition(targetMs);
+        timeout.start(kFrameTimeoutMs);
+        loop.exec();
+        timeout.stop();
+        if (!captured.isValid())
+            continue;
+
+        QByteArray jpeg;
+        QBuffer buffer(&jpeg);
+        buffer.open(QIODevice::WriteOnly);
+        captured.toImage().scaledToWidth(kThumbnailWidth, Qt::SmoothTransformation).save(&buffer, "JPEG", kJpegQuality);
+        {
+            QMutexLocker locker(&mutex);
+            thumbnails[index] = jpeg;
+        }
+        ++generated;
+        emit thumbnailReady();
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        complete = !token.isCancelled();
+    }
+    qDebug().noquote() << QString("[scrub-thumbs] generated=%1 total=%2 interval_ms=%3 ms=%4")
+                              .arg(generated).arg(count).arg(interval).arg(timer.elapsed());
+    if (generated > 0)
+        saveToFile(cachePath);
+}
+
+bool ScrubThumbnailIndex::loadFromFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic, version;
+    qint64 loadedInterval;
+    bool loadedComplete;
+    QVector<QByteArray> loaded;
+    in >> magic >> version;
+    if (magic != kThumbsMagic || version != kThumbsVersion)
+        return false;
+    in >> loadedInterval >> loadedComplete >> loaded;
+    if (in.status() != QDataStream::Ok || loadedInterval <= 0 || loaded.isEmpty())
+        return false;
+
+    QMutexLocker locker(&mutex);
+    intervalMs = loadedInterval;
+    thumbnails = loaded;
+    complete = loadedComplete;
+    return true;
+}
+
+void ScrubThumbnailIndex::saveToFile(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "ScrubThumbnailIndex: cannot write" << path;
+        return;
+    }
+
+    QDataStream out(&file);
+    QMutexLocker locker(&mutex);
+    out << kThumbsMagic << kThumbsVersion << intervalMs << complete << thumbnails;
+    locker.unlock();
+
+    file.commit();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QObject>
+#include "taskscheduler.h"      // Generowanie miniatur jako zadanie puli
+#include <QMutex>
+#include <QImage>
+#include <QByteArray>
+#include <QVector>
+
+// Miniatury klatek filmu do podglądu przy przewijaniu suwakiem.
+// Generowane leniwie w zadaniu puli (TaskScheduler; własny QMediaPlayer z QVideoSink, bez widoku) co stały
+// odstęp czasu, w kolejności "od zgrubnej do dokładnej": najpierw co 16. miniatura, potem
+// co 8. itd., więc podgląd dowolnego miejsca jest dostępny po kilku pierwszych klatkach.
+// Miniatury są trzymane jako JPEG (kilka KB każda) i dekodowane przy wyświetlaniu.
+// Gotowe (także częściowo) miniatury są zapisywane w katalogu pamięci podręcznej filmu.
+class ScrubThumbnailIndex : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ScrubThumbnailIndex(QObject *parent = nullptr);
+    ~ScrubThumbnailIndex() override;
+
+    // Film, dla którego są miniatury (pusta ścieżka czyści indeks); nic nie wczytuje ani nie generuje
+    void setSource(const QString &fileName);
+
+    // Wczytanie zapisanych i generowanie brakujących miniatur w tle
+    // (przy pierwszym najechaniu na suwak)
+    void ensureBuilt();
+
+    // Najbliższa gotowa miniatura dla pozycji (pusty obraz, gdy jeszcze żadnej nie ma)
+    QImage thumbnailAt(qint64 positionMs) const;
+
+    // Przerwanie generowania (np. po wyjściu z odtwarzacza); gotowe miniatury zostają,
+    // a kolejne ensureBuilt() dokończy resztę
+    void stop();
+
+signals:
+    // Nowa miniatura (emitowane z wątku puli)
+    void thumbnailReady();
+
+private:
+    void run(const QString &fileName, const CancellationToken &token);
+    bool loadFromFile(const QString &path);
+    void saveToFile(const QString &path) const;
+
+    QString source;
+    QString cachePath;
+    TaskHandle buildTask;               // Ważny od ensureBuilt() do zmiany filmu
+
+    mutable QMutex mutex;               // Chroni pola poniżej
+    qint64 intervalMs = 0;              // Odstęp między miniaturami (0 = nieznany)
+    QVector<QByteArray> thumbnails;     // JPEG; puste = jeszcze nie wygenerowane
+    bool complete = false;
+};
@@ -0,0 +1,208 @@
+#include "spectrumanalyzer.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>          // SSE: cztery motylki FFT jedną instrukcją
+#define SPECTRUMANALYZER_SSE
+#endif
+
+namespace {
+// Zakres częstotliwości pasm
+constexpr double kMinFrequency = 30.0;
+constexpr double kMaxFrequency = 16000.0;
+// Zakres dynamiki wyświetlanych poziomów
+constexpr float kFloorDb = -80.0f;
+// Opadanie poziomu pasma na jedno okno analizy (szczyty nie migają)
+constexpr float kBandDecay = 0.04f;
+// Kolumn przebiegu na sekundę dźwięku
+constexpr int kColumnsPerSecond = 200;
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer(int bands, int sampleRate)
+    : bandCount(bands),
+      rate(sampleRate)
+{
+    history.fill(0.0f, kFftSize);
+    fftRe.resize(kFftSize);
+    fftIm.resize(kFftSize);
+    bandLevels.fill(0.0f, bandCount);
+    buildTables();
+}
+
+void SpectrumAnalyzer::setSampleRate(int sampleRate)
+{
+    if (sampleRate <= 0 || sampleRate == rate)
+        return;
+    rate = sampleRate;
+    buildTables();
+}
+
+void SpectrumAnalyzer::reset()
+{
+    history.fill(0.0f);
+    historyPos = 0;
+    sinceLastFft = 0;
+    bandLevels.fill(0.0f);
+    columnFill = 0;
+    columnMin = columnMax = 0;
+    peakMin.clear();
+    peakMax.clear();
+}
+
+void SpectrumAnalyzer::buildTables()
+{
+    const int n = kFftSize;
+
+    window.resize(n);
+    for (int i = 0; i < n; ++i)
+        window[i] = float(0.5 - 0.5 * qCos(2.0 * M_PI * i / (n - 1)));
+
+    int bits = 0;
+    while ((1 << bits) < n)
+        ++bits;
+    bitReverse.resize(n);
+    for (int i = 0; i < n; ++i) {
+        int r = 0;
+        for (int b = 0; b < bits; ++b)
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        bitReverse[i] = r;
+    }
+
+    // Czynniki obrotu etapu o połowie "half" leżą ciągiem od indeksu half - 1
+    // (ciągły odczyt w pętli wektorowej)
+    twiddleRe.resize(n - 1);
+    twiddleIm.resize(n - 1);
+    for (int half = 1; half < n; half *= 2) {
+        for (int k = 0; k < half; ++k) {
+            twiddleRe[half - 1 + k] = float(qCos(-M_PI * k / half));
+            twiddleIm[half - 1 + k] = float(qSin(-M_PI * k / half));
+        }
+    }
+
+    // Pasma logarytmiczne; pasmo węższe niż prążek dostaje najbliższy prążek
+    const double binHz = double(rate) / n;
+    const double maxFrequency = qMin(kMaxFrequency, rate / 2.0);
+    bandFirstBin.resize(bandCount);
+    bandLastBin.resize(bandCount);
+    for (int b = 0; b < bandCount; ++b) {
+        const double low = kMinFrequency * qPow(maxFrequency / kMinFrequency, double(b) / bandCount);
+        const double high = kMinFrequency * qPow(maxFrequency / kMinFrequency, double(b + 1) / bandCount);
+        const int first = qBound(1, int(low / binHz), n / 2);
+        bandFirstBin[b] = first;
+        bandLastBin[b] = qBound(first, int(qCeil(high / binHz)) - 1, n / 2);
+    }
+
+    samplesPerColumn = qMax(1, rate / kColumnsPerSecond);
+}
+
+bool SpectrumAnalyzer::addSamples(const float *samples, int count)
+{
+    bool spectrum = false;
+    for (int i = 0; i < count; ++i) {
+        const float s = samples[i];
+        history[historyPos] = s;
+        historyPos = (historyPos + 1) % kFftSize;
+
+        // Szczyty przebiegu
+        if (columnFill == 0) {
+            columnMin = columnMax = s;
+        } else {
+            columnMin = qMin(columnMin, s);
+            columnMax = qMax(columnMax, s);
+        }
+        if (++columnFill == samplesPerColumn) {
+            peakMin.append(columnMin);
+            peakMax.append(columnMax);
+            columnFill = 0;
+        }
+
+        if (++sinceLastFft == kHopSize) {
+            sinceLastFft = 0;
+            computeSpectrum();
+            spectrum = true;
+        }
+    }
+    return spectrum;
+}
+
+void SpectrumAnalyzer::takePeaks(QVector<float> *minima, QVector<float> *maxima)
+{
+    minima->swap(peakMin);
+    maxima->swap(peakMax);
+    peakMin.clear();
+    peakMax.clear();
+}
+
+void SpectrumAnalyzer::computeSpectrum()
+{
+    const int n = kFftSize;
+    float *re = fftRe.data();
+    float *im = fftIm.data();
+
+    // Okno Hanna i permutacja bitów od razu przy kopiowaniu (najstarsza próbka pierwsza)
+    for (int i = 0; i < n; ++i) {
+        const int j = bitReverse[i];
+        re[j] = history[(historyPos + i) % n] * window[i];
+        im[j] = 0.0f;
+    }
+    fft(re, im);
+
+    // Pełnoskalowa sinusoida w oknie Hanna daje amplitudę prążka n/4
+    const float reference = 1.0f / (float(n) * n / 16.0f);
+    for (int b = 0; b < bandCount; ++b) {
+        float power = 0.0f;
+        for (int k = bandFirstBin[b]; k <= bandLastBin[b]; ++k)
+            power = qMax(power, re[k] * re[k] + im[k] * im[k]);
+
+        const float db = 10.0f * std::log10(power * reference + 1e-12f);
+        const float level = qBound(0.0f, (db - kFloorDb) / -kFloorDb, 1.0f);
+        bandLevels[b] = qMax(level, bandLevels[b] - kBandDecay);
+    }
+}
+
+void SpectrumAnalyzer::fft(float *re, float *im) const
+{
+    const int n = kFftSize;
+    for (int half = 1; half < n; half *= 2) {
+        const float *wr = twiddleRe.constData() + half - 1;
+        const float *wi = twiddleIm.constData() + half - 1;
+
+        for (int start = 0; start < n; start += 2 * half) {
+            float *ar = re + start;
+            float *ai = im + start;
+            float *br = ar + half;
+            float *bi = ai + half;
+            int k = 0;
+
+#ifdef SPECTRUMANALYZER_SSE
+            // Cztery motylki naraz (etapy od half = 4)
+            for (; k + 4 <= half; k += 4) {
+                const __m128 xr = _mm_loadu_ps(br + k);
+                const __m128 xi = _mm_loadu_ps(bi + k);
+                const __m128 cr = _mm_loadu_ps(wr + k);
+                const __m128 ci = _mm_loadu_ps(wi + k);
+                const __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+                const __m128 ti = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+                const __m128 ur = _mm_loadu_ps(ar + k);
+                const __m128 ui = _mm_loadu_ps(ai + k);
+                _mm_storeu_ps(ar + k, _mm_add_ps(ur, tr));
+                _mm_storeu_ps(ai + k, _mm_add_ps(ui, ti));
+                _mm_storeu_ps(br + k, _mm_sub_ps(ur, tr));
+                _mm_storeu_ps(bi + k, _mm_sub_ps(ui, ti));
+            }
+#endif
+
+            // Etapy 1 i 2 (lub całość bez SSE)
+            for (; k < half; ++k) {
+                const float tr = br[k] * wr[k] - bi[k] * wi[k];
+                const float ti = br[k] * wi[k] + bi[k] * wr[k];
+                br[k] = ar[k] - tr;
+                bi[k] = ai[k] - ti;
+                ar[k] += tr;
+                ai[k] += ti;
+            }
+        }
+    }
+}
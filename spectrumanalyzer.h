@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QVector>
+
+// Analiza widma i przebiegu dźwięku dla wizualizacji (bez zależności od Qt Multimedia,
+// żeby dało się ją mierzyć osobno w benchmarku).
+// Próbki mono trafiają do bufora okna; co kHopSize próbek liczone jest FFT z oknem Hanna
+// (motylki radix-2 po cztery naraz w SSE), a moc prążków jest zbierana w pasma rozłożone
+// logarytmicznie od 30 Hz do 16 kHz. Równolegle zbierane są szczyty (min/max) przebiegu
+// dla kolejnych kolumn przewijanego wykresu.
+class SpectrumAnalyzer {
+public:
+    static constexpr int kFftSize = 2048;
+    static constexpr int kHopSize = 1024;    // Nakładanie okien 50%
+
+    explicit SpectrumAnalyzer(int bandCount = 64, int sampleRate = 44100);
+
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return rate; }
+
+    // Dodaje próbki mono (zakres -1..1). Zwraca true, gdy powstało nowe widmo.
+    bool addSamples(const float *samples, int count);
+
+    // Poziom pasm w zakresie 0..1 (skala dB, z łagodnym opadaniem)
+    const QVector<float> &bands() const { return bandLevels; }
+
+    // Szczyty przebiegu dla kolumn wykresu zebrane od ostatniego wywołania
+    void takePeaks(QVector<float> *minima, QVector<float> *maxima);
+
+    void reset();
+
+private:
+    void computeSpectrum();
+    void fft(float *re, float *im) const;
+    void buildTables();
+
+    int bandCount;
+    int rate;
+
+    // Okno analizy (bufor kołowy) i licznik próbek do kolejnego FFT
+    QVector<float> history;
+    int historyPos = 0;
+    int sinceLastFft = 0;
+
+    // Tablice przygotowane raz: okno Hanna, permutacja bitów, czynniki obrotu kolejnych etapów
+    QVector<float> window;
+    QVector<int> bitReverse;
+    QVector<float> twiddleRe;
+    QVector<float> twiddleIm;
+
+    // Zakresy prążków FFT dla pasm
+    QVector<int> bandFirstBin;
+    QVector<int> bandLastBin;
+
+    QVector<float> fftRe;
+    QVector<float> fftIm;
+    QVector<float> bandLevels;
+
+    // Bieżąca kolumna przebiegu i gotowe kolumny
+    int samplesPerColumn = 220;
+    int columnFill = 0;
+    float columnMin = 0;
+    float columnMax = 0;
+    QVector<float> peakMin;
+    QVector<float> peakMax;
+};
@@ -0,0 +1,421 @@
+#include "taskscheduler.h"
+#include "tracing.h"
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QDebug>
+#include <exception>
+
+namespace {
+// Co tyle do logu trafiają statystyki klas
+constexpr int kStatsIntervalMs = 10000;
+
+enum Phase { Queued, Running, Finished };
+
+const char *const kClassNames[] = { "visible", "next", "background" };
+const char *const kQueuedCounters[] = { "tasks.queued.visible", "tasks.queued.next", "tasks.queued.background" };
+
+// Czekanie na koniec zadań (wspólne dla wszystkich uchwytów)
+QMutex finishMutex;
+QWaitCondition finishCondition;
+
+// Indeks wątku puli wykonującego bieżący kod (-1 poza pulą)
+thread_local int currentWorker = -1;
+}
+
+struct TaskHandle::State {
+    CancellationToken token;
+    std::atomic<int> phase{Queued};
+};
+
+bool TaskHandle::isFinished() const
+{
+    return !state || state->phase == Finished;
+}
+
+CancellationToken TaskHandle::token() const
+{
+    return state ? state->token : CancellationToken();
+}
+
+void TaskHandle::cancel() const
+{
+    if (!state)
+        return;
+    state->token.cancel();
+    int expected = Queued;
+    if (state->phase.compare_exchange_strong(expected, Finished)) {
+        QMutexLocker locker(&finishMutex);
+        finishCondition.wakeAll();
+    }
+}
+
+void TaskHandle::waitForFinished() const
+{
+    if (!state)
+        return;
+    QMutexLocker locker(&finishMutex);
+    while (state->phase != Finished)
+        finishCondition.wait(&finishMutex);
+}
+
+TaskScheduler &TaskScheduler::instance()
+{
+    // Rodzicem jest aplikacja, więc wątki kończą się przed nią (pierwsze użycie w wątku GUI)
+    static TaskScheduler *scheduler = [] {
+        auto *created = new TaskScheduler();
+        created->setParent(qApp);
+        return created;
+    }();
+    return *scheduler;
+}
+
+TaskScheduler::TaskScheduler()
+{
+    clock.start();
+
+    // Co najmniej po jednym wątku na klasę: VisibleNow, NextLikely i Background
+    const int count = qMax(3, QThread::idealThreadCount());
+    lowLimit = count - 1;
+    backgroundLimit = qMax(1, count / 2);
+    for (int i = 0; i < count; ++i)
+        workers.push_back(std::make_unique<Worker>());
+    for (int i = 0; i < count; ++i) {
+        Worker &worker = *workers[i];
+        worker.thread = QThread::create([this, i]() { workerLoop(i); });
+        worker.thread->setObjectName(QString("TaskWorker-%1").arg(i));
+        worker.thread->start();
+    }
+
+    statsTimer = new QTimer(this);
+    statsTimer->setTimerType(Qt::VeryCoarseTimer);
+    connect(statsTimer, &QTimer::timeout, this, &TaskScheduler::logStats);
+    updateStatsLogging();
+}
+
+void TaskScheduler::updateStatsLogging()
+{
+    const bool wanted = Tracing::statsLoggingEnabled();
+    if (wanted == statsTimer->isActive())
+        return;
+    if (!wanted) {
+        statsTimer->stop();
+        return;
+    }
+
+    // Pierwszy wpis obejmuje tylko okres od włączenia
+    {
+        QMutexLocker locker(&stateMutex);
+        for (ClassCounters &c : counters) {
+            c.periodCompleted = 0;
+            c.periodCancelled = 0;
+            c.periodWaitNs = 0;
+            c.periodWaitMaxNs = 0;
+            c.periodRunNs = 0;
+        }
+    }
+    statsTimer->start(kStatsIntervalMs);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        QMutexLocker locker(&stateMutex);
+        stopping = true;
+    }
+
+    // Zadania w kolejkach nie zostaną uruchomione; uruchomione dostają sygnał do zakończenia
+    for (const auto &worker : workers) {
+        QMutexLocker locker(&worker->mutex);
+        for (auto &queue : worker->queues) {
+            for (const Task &task : queue) {
+                task.state->token.cancel();
+                task.state->phase = Finished;
+            }
+            queue.clear();
+        }
+        if (worker->current)
+            worker->current->token.cancel();
+    }
+    {
+        QMutexLocker locker(&finishMutex);
+        finishCondition.wakeAll();
+    }
+    workAvailable.wakeAll();
+
+    for (const auto &worker : workers) {
+        worker->thread->wait();
+        delete worker->thread;
+    }
+}
+
+TaskHandle TaskScheduler::submit(TaskPriority priority, const char *name,
+                                 std::function<void(const CancellationToken &)> work,
+                                 const CancellationToken &token)
+{
+    TaskHandle handle;
+    handle.state = std::make_shared<TaskHandle::State>();
+    handle.state->token = token;
+
+    const int p = int(priority);
+    Task task;
+    task.state = handle.state;
+    task.work = std::move(work);
+    task.name = name;
+    task.queuedNs = clock.nsecsElapsed();
+
+    // Zadanie zgłoszone z wątku puli zostaje w jego kolejce; pozostałe — kolejno do wszystkich
+    const int index = currentWorker >= 0 ? currentWorker : int(nextWorker++ % workers.size());
+    {
+        QMutexLocker locker(&workers[index]->mutex);
+        workers[index]->queues[p].push_back(std::move(task));
+    }
+    int queued;
+    {
+        QMutexLocker locker(&stateMutex);
+        queued = ++counters[p].queued;
+    }
+    TRACE_COUNTER(kQueuedCounters[p], queued);
+    workAvailable.wakeOne();
+    return handle;
+}
+
+void TaskScheduler::runParallel(TaskPriority priority, const char *name, int width,
+                                const std::function<void(const CancellationToken &)> &work,
+                                const CancellationToken &token)
+{
+    QVector<TaskHandle> helpers;
+    for (int i = 1; i < width; ++i)
+        helpers.append(submit(priority, name, work, token));
+
+    work(token);
+
+    // Licznik pracy jest już wyczerpany — pomocnicy z kolejki nie mieliby nic do zrobienia
+    for (const TaskHandle &helper : std::as_const(helpers)) {
+        int expected = Queued;
+        helper.state->phase.compare_exchange_strong(expected, Finished);
+    }
+    for (const TaskHandle &helper : std::as_const(helpers))
+        helper.waitForFinished();
+}
+
+void TaskScheduler::post(QObject *context, const CancellationToken &token, std::function<void()> fn)
+{
+    postCompletion(QPointer<QObject>(context), context != nullptr, token, std::move(fn));
+}
+
+void TaskScheduler::postCompletion(const QPointer<QObject> &context, bool hasContext, const CancellationToken &token,
+                                   std::function<void()> fn)
+{
+    bool schedule = false;
+    {
+        QMutexLocker locker(&completionMutex);
+        completions.append(Completion{ context, hasContext, token, std::move(fn) });
+        if (!flushQueued)
+            flushQueued = schedule = true;
+    }
+    // Jedno zdarzenie na paczkę — kolejne wyniki dołączają do już zaplanowanej
+    if (schedule)
+        QMetaObject::invokeMethod(this, [this]() { flushCompletions(); }, Qt::QueuedConnection);
+}
+
+void TaskScheduler::flushCompletions()
+{
+    QVector<Completion> batch;
+    {
+        QMutexLocker locker(&completionMutex);
+        batch.swap(completions);
+        flushQueued = false;
+    }
+    TRACE_SCOPE("tasks.deliver");
+    TRACE_COUNTER("tasks.batch_size", batch.size());
+    for (const Completion &completion : std::as_const(batch)) {
+        if (completion.token.isCancelled() || (completion.hasContext && !completion.context))
+            continue;
+        completion.fn();
+    }
+}
+
+void TaskScheduler::workerLoop(int index)
+{
+    currentWorker = index;
+    forever {
+        // Czekanie na zadanie, które ten wątek może wziąć; miejsca dla niższych klas są rezerwowane
+        bool allowNext;
+        bool allowBackground;
+        {
+            QMutexLocker locker(&stateMutex);
+            forever {
+                if (stopping)
+                    return;
+                const bool visible = counters[int(TaskPriority::VisibleNow)].queued > 0;
+                const bool lowFree = lowRunning < lowLimit;
+                allowNext = lowFree && counters[int(TaskPriority::NextLikely)].queued > 0;
+                allowBackground = lowFree && backgroundRunning < backgroundLimit
+                                  && counters[int(TaskPriority::Background)].queued > 0;
+                if (visible || allowNext || allowBackground)
+                    break;
+                workAvailable.wait(&stateMutex);
+            }
+            if (allowNext || allowBackground)
+                ++lowRunning;
+            if (allowBackground)
+                ++backgroundRunning;
+        }
+
+        Task task;
+        const int p = takeTask(index, allowNext, allowBackground, &task);
+        const bool lowReserved = allowNext || allowBackground;
+        const bool lowUnused = lowReserved && p <= int(TaskPriority::VisibleNow);
+        const bool backgroundUnused = allowBackground && p != int(TaskPriority::Background);
+        if (lowUnused || backgroundUnused) {
+            // Rezerwacja niewykorzystana (wzięte zadanie innej klasy albo żadne)
+            QMutexLocker locker(&stateMutex);
+            if (lowUnused)
+                --lowRunning;
+            if (backgroundUnused)
+                --backgroundRunning;
+        }
+        if (p >= 0)
+            execute(task, TaskPriority(p));
+    }
+}
+
+// Najważniejsza dostępna klasa: najpierw własna kolejka, potem kolejki pozostałych wątków.
+// Zwraca klasę wziętego zadania albo -1. Zadania anulowane w kolejce są po drodze odrzucane.
+int TaskScheduler::takeTask(int index, bool allowNext, bool allowBackground, Task *task)
+{
+    const int count = int(workers.size());
+    for (int p = 0; p < 3; ++p) {
+        if ((p == int(TaskPriority::NextLikely) && !allowNext)
+            || (p == int(TaskPriority::Background) && !allowBackground))
+            continue;
+        for (int k = 0; k < count; ++k) {
+            Worker &worker = *workers[(index + k) % count];
+            forever {
+                {
+                    QMutexLocker locker(&worker.mutex);
+                    if (worker.queues[p].empty())
+                        break;
+                    *task = std::move(worker.queues[p].front());
+                    worker.queues[p].pop_front();
+                }
+                int expected = Queued;
+                const bool cancelled = !task->state->phase.compare_exchange_strong(expected, Running);
+                int queued;
+                {
+                    QMutexLocker locker(&stateMutex);
+                    queued = --counters[p].queued;
+                    if (cancelled) {
+                        ++counters[p].cancelled;
+                        ++counters[p].periodCancelled;
+                    }
+                }
+                TRACE_COUNTER(kQueuedCounters[p], queued);
+                if (!cancelled)
+                    return p;
+            }
+        }
+    }
+    return -1;
+}
+
+void TaskScheduler::execute(const Task &task, TaskPriority priority)
+{
+    const int p = int(priority);
+    const qint64 startNs = clock.nsecsElapsed();
+    {
+        QMutexLocker locker(&stateMutex);
+        ClassCounters &c = counters[p];
+        const qint64 waitNs = startNs - task.queuedNs;
+        ++c.running;
+        c.waitNs += waitNs;
+        c.periodWaitNs += waitNs;
+        c.waitMaxNs = qMax(c.waitMaxNs, waitNs);
+        c.periodWaitMaxNs = qMax(c.periodWaitMaxNs, waitNs);
+    }
+    Worker &worker = *workers[currentWorker];
+    {
+        QMutexLocker locker(&worker.mutex);
+        worker.current = task.state;
+    }
+
+    try {
+        TRACE_SCOPE(task.name ? task.name : "task");
+        task.work(task.state->token);
+    } catch (const std::exception &e) {
+        qDebug() << "TaskScheduler: task" << (task.name ? task.name : "task") << "failed:" << e.what();
+    }
+
+    {
+        QMutexLocker locker(&worker.mutex);
+        worker.current.reset();
+    }
+    {
+        QMutexLocker locker(&finishMutex);
+        task.state->phase = Finished;
+        finishCondition.wakeAll();
+    }
+
+    const qint64 runNs = clock.nsecsElapsed() - startNs;
+    {
+        QMutexLocker locker(&stateMutex);
+        ClassCounters &c = counters[p];
+        --c.running;
+        ++c.completed;
+        ++c.periodCompleted;
+        c.runNs += runNs;
+        c.periodRunNs += runNs;
+        if (priority != TaskPriority::VisibleNow)
+            --lowRunning;
+        if (priority == TaskPriority::Background)
+            --backgroundRunning;
+    }
+    // Zwolnione miejsce dla niskiej klasy — może czekać na nie zadanie w kolejce
+    if (priority != TaskPriority::VisibleNow)
+        workAvailable.wakeOne();
+}
+
+TaskClassStats TaskScheduler::stats(TaskPriority priority) const
+{
+    QMutexLocker locker(&stateMutex);
+    const ClassCounters &c = counters[int(priority)];
+    TaskClassStats result;
+    result.queued = c.queued;
+    result.running = c.running;
+    result.completed = c.completed;
+    result.cancelled = c.cancelled;
+    if (c.completed > 0) {
+        result.waitMeanMs = c.waitNs / 1e6 / c.completed;
+        result.runMeanMs = c.runNs / 1e6 / c.completed;
+    }
+    result.waitMaxMs = c.waitMaxNs / 1e6;
+    return result;
+}
+
+void TaskScheduler::logStats()
+{
+    QStringList lines;
+    {
+        QMutexLocker locker(&stateMutex);
+        for (int p = 0; p < 3; ++p) {
+            ClassCounters &c = counters[p];
+            if (c.periodCompleted == 0 && c.periodCancelled == 0 && c.queued == 0 && c.running == 0)
+                continue;
+            const double n = qMax<quint64>(1, c.periodCompleted);
+            lines.append(QString("[tasks] class=%1 queued=%2 running=%3 done=%4 cancelled=%5 "
+                                 "wait_mean_ms=%6 wait_max_ms=%7 run_mean_ms=%8 workers=%9")
+                             .arg(kClassNames[p]).arg(c.queued).arg(c.running)
+                             .arg(c.periodCompleted).arg(c.periodCancelled)
+                             .arg(c.periodWaitNs / 1e6 / n, 0, 'f', 2).arg(c.periodWaitMaxNs / 1e6, 0, 'f', 2)
+                             .arg(c.periodRunNs / 1e6 / n, 0, 'f', 2).arg(workers.size()));
+            c.periodCompleted = 0;
+            c.periodCancelled = 0;
+            c.periodWaitNs = 0;
+            c.periodWaitMaxNs = 0;
+            c.periodRunNs = 0;
+        }
+    }
+    for (const QString &line : std::as_const(lines))
+        qDebug().noquote() << line;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Klasy pierwszeństwa zadań (od najważniejszej)
+enum class TaskPriority {
+    VisibleNow,     // To, na co użytkownik właśnie patrzy (otwierany dokument, obraz)
+    NextLikely,     // Prawdopodobnie potrzebne za chwilę (miniatury przewijania, indeks pliku)
+    Background,     // Analiza i indeksowanie w tle (głośność, biblioteka, wyszukiwanie)
+};
+
+// Token anulowania: kopie współdzielą jedną flagę. Zadanie sprawdza isCancelled()
+// w swoich pętlach; wyniki anulowanych zadań nie trafiają do wątku GUI.
+class CancellationToken {
+public:
+    CancellationToken() : flag(std::make_shared<std::atomic<bool>>(false)) { }
+
+    void cancel() const { flag->store(true); }
+    bool isCancelled() const { return flag->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+};
+
+// Uchwyt zgłoszonego zadania (pusty, dopóki nic nie zgłoszono)
+class TaskHandle {
+public:
+    bool isValid() const { return state != nullptr; }
+    bool isFinished() const;
+    CancellationToken token() const;
+
+    // Anulowanie: zadanie czekające w kolejce nie zostanie uruchomione,
+    // uruchomione kończy się przy najbliższym sprawdzeniu tokenu
+    void cancel() const;
+
+    // Czekanie na koniec zadania (po cancel() — tylko na zadanie już uruchomione)
+    void waitForFinished() const;
+
+private:
+    friend class TaskScheduler;
+    struct State;
+    std::shared_ptr<State> state;
+};
+
+// Statystyki jednej klasy zadań
+struct TaskClassStats {
+    int queued = 0;             // W kolejkach
+    int running = 0;
+    quint64 completed = 0;
+    quint64 cancelled = 0;      // Anulowane (lub odrzucone) przed uruchomieniem
+    double waitMeanMs = 0;      // Czas w kolejce (od zgłoszenia do startu)
+    double waitMaxMs = 0;
+    double runMeanMs = 0;
+};
+
+// Wspólna pula wątków dla całej pracy w tle (dekodowanie, indeksowanie, miniatury, analiza).
+// Każdy wątek ma własne kolejki (po jednej na klasę); zadania zgłaszane z wątku puli trafiają
+// do jego kolejki, pozostałe są rozdzielane po kolei. Bezczynny wątek podbiera zadania z kolejek
+// innych wątków, zawsze od najważniejszej klasy. Zadania NextLikely i Background nigdy nie zajmują
+// wszystkich wątków — jeden zostaje wolny dla VisibleNow; Background zajmuje najwyżej połowę wątków,
+// więc długa analiza w tle nie blokuje NextLikely (pula ma co najmniej 3 wątki).
+// Wyniki (run, post) wracają do wątku GUI paczkami: jedno zdarzenie na wszystkie wyniki gotowe
+// do tej pory; wynik jest pomijany, gdy token anulowano albo obiekt odbiorcy już nie istnieje.
+// Przy włączonym Tracing::statsLoggingEnabled() co kStatsIntervalMs do logu trafiają statystyki
+// klas, w których coś się działo.
+class TaskScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    static TaskScheduler &instance();
+    ~TaskScheduler() override;
+
+    // Zadanie bez wyniku; name (stały napis) trafia do śladu (Tracing)
+    TaskHandle submit(TaskPriority priority, const char *name,
+                      std::function<void(const CancellationToken &)> work,
+                      const CancellationToken &token = CancellationToken());
+
+    // Zadanie z wynikiem: work(token) w wątku puli, done(wynik) w wątku GUI
+    template <typename Work, typename Done>
+    TaskHandle run(TaskPriority priority, const char *name, QObject *context, Work work, Done done,
+                   const CancellationToken &token = CancellationToken());
+
+    // Wywołanie fn w wątku GUI w najbliższej paczce (np. postęp z wnętrza zadania)
+    void post(QObject *context, const CancellationToken &token, std::function<void()> fn);
+
+    // Praca równoległa z udziałem wywołującego: work(token) działa w bieżącym wątku i w najwyżej
+    // width - 1 zadaniach pomocniczych, pobierając elementy ze wspólnego licznika. Pomocnicy, którzy
+    // nie wystartowali przed końcem pracy, są odrzucani — zadanie czekające na własne podzadania
+    // nie blokuje więc miejsc niskiej klasy. Wraca po zakończeniu wszystkich uruchomionych.
+    void runParallel(TaskPriority priority, const char *name, int width,
+                     const std::function<void(const CancellationToken &)> &work,
+                     const CancellationToken &token = CancellationToken());
+
+    TaskClassStats stats(TaskPriority priority) const;
+    int workerCount() const { return int(workers.size()); }
+
+    // Włączenie / wyłączenie okresowego wpisu [tasks] według Tracing::statsLoggingEnabled()
+    void updateStatsLogging();
+
+private:
+    TaskScheduler();
+
+    struct Task {
+        std::shared_ptr<TaskHandle::State> state;
+        std::function<void(const CancellationToken &)> work;
+        const char *name = nullptr;
+        qint64 queuedNs = 0;
+    };
+
+    struct Worker {
+        QThread *thread = nullptr;
+        QMutex mutex;                           // Chroni queues
+        std::deque<Task> queues[3];             // Po jednej na klasę
+        std::shared_ptr<TaskHandle::State> current;   // Chronione przez mutex
+    };
+
+    struct Completion {
+        QPointer<QObject> context;
+        bool hasContext = false;
+        CancellationToken token;
+        std::function<void()> fn;
+    };
+
+    struct ClassCounters {
+        int queued = 0;
+        int running = 0;
+        quint64 completed = 0;
+        quint64 cancelled = 0;
+        qint64 waitNs = 0;
+        qint64 waitMaxNs = 0;
+        qint64 runNs = 0;
+        // Od ostatniego wpisu w logu
+        quint64 periodCompleted = 0;
+        quint64 periodCancelled = 0;
+        qint64 periodWaitNs = 0;
+        qint64 periodWaitMaxNs = 0;
+        qint64 periodRunNs = 0;
+    };
+
+    void postCompletion(const QPointer<QObject> &context, bool hasContext, const CancellationToken &token,
+                        std::function<void()> fn);
+    void workerLoop(int index);
+    int takeTask(int index, bool allowNext, bool allowBackground, Task *task);
+    void execute(const Task &task, TaskPriority priority);
+    void flushCompletions();
+    void logStats();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<unsigned> nextWorker{0};
+    QElapsedTimer clock;
+
+    // Kolejki jako całość: liczniki, ograniczenie zadań niskiej klasy, usypianie wątków
+    mutable QMutex stateMutex;
+    QWaitCondition workAvailable;
+    ClassCounters counters[3];
+    int lowRunning = 0;                         // NextLikely + Background w trakcie (i zarezerwowane)
+    int lowLimit = 1;
+    int backgroundRunning = 0;                  // Background w trakcie (i zarezerwowane)
+    int backgroundLimit = 1;
+    bool stopping = false;
+
+    QMutex completionMutex;                     // Chroni completions i flushQueued
+    QVector<Completion> completions;
+    bool flushQueued = false;
+
+    QTimer *statsTimer;
+};
+
+template <typename Work, typename Done>
+TaskHandle TaskScheduler::run(TaskPriority priority, const char *name, QObject *context, Work work, Done done,
+                              const CancellationToken &token)
+{
+    using Result = std::invoke_result_t<Work, const CancellationToken &>;
+    const QPointer<QObject> receiver(context);
+    const bool hasContext = context != nullptr;
+    return submit(priority, name, [this, receiver, hasContext, work, done](const CancellationToken &taskToken) mutable {
+        auto result = std::make_shared<Result>(work(taskToken));
+        if (taskToken.isCancelled())
+            return;
+        postCompletion(receiver, hasContext, taskToken, [done, result]() mutable { done(std::move(*result)); });
+    }, token);
+}
@@ -0,0 +1,307 @@
+#include "textfileindex.h"
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>          // SSE2: porównanie 16 bajtów jedną instrukcją
+#define TEXTFILEINDEX_SSE2
+#endif
+
+namespace {
+// Zapamiętywany jest początek co kLineStride-tej linii
+constexpr qint64 kLineStride = 64;
+// Blok pliku: jednostka wykrywania kodowania i publikowania postępu indeksowania
+constexpr qint64 kChunkSize = 64 * 1024;
+// Minimalny odstęp między sygnałami postępu
+constexpr qint64 kProgressIntervalMs = 100;
+}
+
+TextFileIndex::TextFileIndex(QObject *parent)
+    : QObject(parent)
+{ }
+
+TextFileIndex::~TextFileIndex()
+{
+    close();
+}
+
+bool TextFileIndex::open(const QString &fileName)
+{
+    close();
+
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "TextFileIndex: cannot open" << fileName;
+        return false;
+    }
+
+    size = file.size();
+    if (size > 0) {
+        data = file.map(0, size);
+        if (!data) {
+            qDebug() << "TextFileIndex: cannot map" << fileName;
+            file.close();
+            size = 0;
+            return false;
+        }
+    }
+
+    {
+        QWriteLocker locker(&lock);
+        strideOffsets = { 0 };
+        chunkEncodings.reserve(int((size + kChunkSize - 1) / kChunkSize));
+    }
+
+    // Linie otwieranego pliku są potrzebne od razu do pierwszego ekranu
+    indexTask = TaskScheduler::instance().submit(TaskPriority::VisibleNow, "text.line_index",
+                                                 [this](const CancellationToken &token) { run(token); });
+    return true;
+}
+
+void TextFileIndex::close()
+{
+    stop();
+
+    if (data)
+        file.unmap(const_cast<uchar *>(data));
+    data = nullptr;
+    size = 0;
+    file.close();
+
+    QWriteLocker locker(&lock);
+    strideOffsets.clear();
+    chunkEncodings.clear();
+    newlineCount = 0;
+    indexedBytes = 0;
+    complete = false;
+}
+
+void TextFileIndex::stop()
+{
+    indexTask.cancel();
+    indexTask.waitForFinished();
+    indexTask = TaskHandle();
+}
+
+qint64 TextFileIndex::lineCount() const
+{
+    QReadLocker locker(&lock);
+    return lineCountLocked();
+}
+
+qint64 TextFileIndex::lineCountLocked() const
+{
+    // Ostatnia linia bez "\n" na końcu pliku jest liczona dopiero po zakończeniu indeksowania
+    if (complete && size > 0 && data[size - 1] != '\n')
+        return newlineCount + 1;
+    return newlineCount;
+}
+
+bool TextFileIndex::isComplete() const
+{
+    QReadLocker locker(&lock);
+    return complete;
+}
+
+qint64 TextFileIndex::indexedSize() const
+{
+    QReadLocker locker(&lock);
+    return indexedBytes;
+}
+
+void TextFileIndex::run(const CancellationToken &token)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QElapsedTimer sinceProgress;
+    sinceProgress.start();
+
+    qint64 newlines = 0;
+    for (qint64 begin = 0; begin < size; begin += kChunkSize) {
+        if (token.isCancelled())
+            return;
+
+        // Skanowanie i wykrywanie kodowania bez blokady — indeks dostaje gotowy blok
+        const qint64 end = qMin(size, begin + kChunkSize);
+        QVector<qint64> starts;
+        const bool ascii = scanChunk(begin, end, &newlines, &starts);
+        const Encoding encoding = (ascii || isValidUtf8(begin, end)) ? Encoding::Utf8 : Encoding::Latin1;
+        {
+            QWriteLocker locker(&lock);
+            strideOffsets += starts;
+            chunkEncodings.append(encoding);
+            newlineCount = newlines;
+            indexedBytes = end;
+        }
+
+        // Pierwszy blok od razu (pierwszy ekran tekstu), kolejne nie częściej niż co 100 ms
+        if (begin == 0 || sinceProgress.elapsed() >= kProgressIntervalMs) {
+            sinceProgress.restart();
+            emit progress(end, size);
+        }
+    }
+
+    {
+        QWriteLocker locker(&lock);
+        complete = true;
+    }
+
+    qDebug() << "TextFileIndex: indexed" << lineCount() << "lines," << size << "bytes in"
+             << timer.elapsed() << "ms";
+    emit progress(size, size);
+    emit finished();
+}
+
+bool TextFileIndex::scanChunk(qint64 begin, qint64 end, qint64 *newlines, QVector<qint64> *strideStarts) const
+{
+    const uchar *p = data + begin;
+    const qint64 n = end - begin;
+    qint64 i = 0;
+    uchar high = 0;
+
+    auto newlineAt = [&](qint64 offset) {
+        if (++*newlines % kLineStride == 0)
+            strideStarts->append(begin + offset + 1);
+    };
+
+#ifdef TEXTFILEINDEX_SSE2
+    // 16 bajtów naraz: maska pozycji "\n" i suma bitowa bajtów (najwyższy bit = nie-ASCII)
+    const __m128i newline = _mm_set1_epi8('\n');
+    __m128i bits = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        bits = _mm_or_si128(bits, v);
+        uint mask = uint(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)));
+        while (mask) {
+            newlineAt(i + qCountTrailingZeroBits(mask));
+            mask &= mask - 1;
+        }
+    }
+    if (_mm_movemask_epi8(bits))
+        high = 0x80;
+#endif
+
+    // Końcówka bloku (lub cały blok bez SSE2)
+    for (; i < n; ++i) {
+        high |= p[i];
+        if (p[i] == '\n')
+            newlineAt(i);
+    }
+    return !(high & 0x80);
+}
+
+bool TextFileIndex::isValidUtf8(qint64 begin, qint64 end) const
+{
+    qint64 i = begin;
+
+    // Blok może zaczynać się w środku sekwencji — pomijamy jej bajty kontynuacji
+    for (int k = 0; k < 3 && i < end && (data[i] & 0xC0) == 0x80; ++k)
+        ++i;
+
+    while (i < end) {
+        const uchar c = data[i];
+        int length;
+        if (c < 0x80) {
+            ++i;
+            continue;
+        } else if ((c & 0xE0) == 0xC0 && c >= 0xC2) {
+            length = 2;
+        } else if ((c & 0xF0) == 0xE0) {
+            length = 3;
+        } else if ((c & 0xF8) == 0xF0 && c <= 0xF4) {
+            length = 4;
+        } else {
+            return false;
+        }
+
+        if (i + length > size)
+            return false;
+        for (int k = 1; k < length; ++k) {
+            if ((data[i + k] & 0xC0) != 0x80)
+                return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+bool TextFileIndex::lineRange(qint64 line, qint64 maxBytes, qint64 *start, qint64 *end) const
+{
+    qint64 pos;
+    {
+        QReadLocker locker(&lock);
+        if (line < 0 || line >= lineCountLocked())
+            return false;
+        pos = strideOffsets[line / kLineStride];
+    }
+
+    // Od zapamiętanego początku najwyżej kLineStride - 1 linii dalej
+    // (te linie są już zaindeksowane, więc każda kończy się znakiem "\n")
+    for (qint64 skip = line % kLineStride; skip > 0; --skip) {
+        const void *newline = std::memchr(data + pos, '\n', size_t(size - pos));
+        pos = static_cast<const uchar *>(newline) - data + 1;
+    }
+
+    // Koniec linii szukamy tylko w granicy maxBytes — linia może mieć gigabajty
+    const qint64 limit = qMin(size, pos + maxBytes);
+    const void *newline = std::memchr(data + pos, '\n', size_t(limit - pos));
+    qint64 lineEnd = newline ? static_cast<const uchar *>(newline) - data : limit;
+    if (lineEnd > pos && data[lineEnd - 1] == '\r')
+        --lineEnd;
+
+    *start = pos;
+    *end = lineEnd;
+    return true;
+}
+
+QString TextFileIndex::lineText(qint64 line, int maxBytes) const
+{
+    qint64 start, end;
+    if (!lineRange(line, maxBytes, &start, &end))
+        return QString();
+
+    // UTF-8 tylko wtedy, gdy wszystkie bloki, przez które przechodzi linia, są poprawnym UTF-8
+    bool utf8 = true;
+    {
+        QReadLocker locker(&lock);
+        const qint64 lastChunk = qMin<qint64>(qMax(start, end - 1) / kChunkSize, chunkEncodings.size() - 1);
+        for (qint64 chunk = start / kChunkSize; chunk <= lastChunk && utf8; ++chunk)
+            utf8 = chunkEncodings[chunk] == Encoding::Utf8;
+    }
+
+    const char *bytes = reinterpret_cast<const char *>(data + start);
+    return utf8 ? QString::fromUtf8(bytes, end - start) : QString::fromLatin1(bytes, end - start);
+}
+
+qint64 TextFileIndex::lineAtOffset(qint64 offset) const
+{
+    qint64 line, pos, count;
+    {
+        QReadLocker locker(&lock);
+        count = lineCountLocked();
+        if (count == 0)
+            return 0;
+
+        // Ostatni zapamiętany początek linii nie większy niż offset
+        auto it = std::upper_bound(strideOffsets.cbegin(), strideOffsets.cend(), offset);
+        const qint64 stride = qMax<qint64>(0, (it - strideOffsets.cbegin()) - 1);
+        line = stride * kLineStride;
+        pos = strideOffsets[stride];
+    }
+
+    while (line + 1 < count) {
+        const void *newline = std::memchr(data + pos, '\n', size_t(size - pos));
+        if (!newline)
+            break;
+        const qint64 next = static_cast<const uchar *>(newline) - data + 1;
+        if (next > offset)
+            break;
+        pos = next;
+        ++line;
+    }
+    return qMin(line, count - 1);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QObject>
+#include <QFile>                // Odwzorowanie pliku w pamięci (QFile::map)
+#include "taskscheduler.h"      // Indeksowanie jako zadanie puli
+#include <QReadWriteLock>       // Odczyt linii równolegle z indeksowaniem
+#include <QVector>
+#include <QString>
+
+// Indeks linii dużego pliku tekstowego (np. logu o rozmiarze kilku GB).
+// Plik jest odwzorowany w pamięci (mmap), więc nic nie jest wczytywane z góry —
+// system wczytuje tylko strony pliku, po które faktycznie sięgamy.
+// Zadanie puli (TaskScheduler) wyszukuje znaki nowej linii (SSE2, 16 bajtów naraz) i zapisuje początek
+// co 64. linii; dostęp do dowolnej linii to odczyt tej tablicy i przejście najwyżej
+// 63 linii dalej. Linie są dostępne już w trakcie indeksowania.
+// Kodowanie jest wykrywane osobno dla każdego bloku pliku (UTF-8 albo Latin-1),
+// bo logi często mieszają poprawny UTF-8 z pojedynczymi bajtami w innym kodowaniu.
+class TextFileIndex : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TextFileIndex(QObject *parent = nullptr);
+    ~TextFileIndex() override;
+
+    // Odwzorowuje plik w pamięci i rozpoczyna indeksowanie; false, jeśli się nie udało
+    bool open(const QString &fileName);
+    void close();
+
+    QString fileName() const { return file.fileName(); }
+    qint64 fileSize() const { return size; }
+
+    // Liczba linii zaindeksowanych do tej pory (po zakończeniu — wszystkich)
+    qint64 lineCount() const;
+    bool isComplete() const;
+
+    // Liczba bajtów od początku pliku, w których znaki nowej linii są już znane
+    qint64 indexedSize() const;
+
+    // Tekst linii bez znaku końca linii; dłuższe linie są obcinane do maxBytes bajtów
+    QString lineText(qint64 line, int maxBytes) const;
+
+    // Numer linii zawierającej dany bajt pliku (w granicach zaindeksowanej części)
+    qint64 lineAtOffset(qint64 offset) const;
+
+signals:
+    // Postęp indeksowania (emitowany z wątku puli)
+    void progress(qint64 indexedBytes, qint64 totalBytes);
+    void finished();
+
+private:
+    enum class Encoding : quint8 { Utf8, Latin1 };
+
+    void stop();
+    void run(const CancellationToken &token);
+
+    // Wywoływane z zablokowanym lock
+    qint64 lineCountLocked() const;
+
+    // Zakres bajtów linii [start, end) bez "\n" i "\r", najwyżej maxBytes bajtów
+    bool lineRange(qint64 line, qint64 maxBytes, qint64 *start, qint64 *end) const;
+
+    // Wyszukanie nowych linii w bloku; zwraca false, jeśli blok nie jest czystym ASCII
+    bool scanChunk(qint64 begin, qint64 end, qint64 *newlines, QVector<qint64> *strideStarts) const;
+
+    // Czy blok jest poprawnym UTF-8 (sekwencja może wychodzić poza koniec bloku)
+    bool isValidUtf8(qint64 begin, qint64 end) const;
+
+    QFile file;
+    const uchar *data = nullptr;
+    qint64 size = 0;
+
+    TaskHandle indexTask;
+
+    mutable QReadWriteLock lock;        // Chroni pola poniżej
+    QVector<qint64> strideOffsets;      // Początek linii nr i * kLineStride
+    QVector<Encoding> chunkEncodings;   // Kodowanie kolejnych bloków pliku
+    qint64 newlineCount = 0;
+    qint64 indexedBytes = 0;
+    bool complete = false;
+};
@@ -0,0 +1,227 @@
+#include "textfileview.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <limits>
+
+namespace {
+// Odstęp tekstu od krawędzi i numerów linii
+constexpr int kTextMargin = 6;
+// Dłuższe linie są obcinane (np. zrzuty binarne bez znaków nowej linii)
+constexpr int kMaxLineBytes = 16 * 1024;
+// Szerokość tabulacji w znakach
+constexpr int kTabWidth = 8;
+// Granice rozmiaru czcionki w punktach
+constexpr int kMinFontSize = 6;
+constexpr int kMaxFontSize = 48;
+// Pasek przewijania liczy linie w int
+constexpr qint64 kMaxScrollLines = std::numeric_limits<int>::max();
+
+// Rozwinięcie tabulacji do spacji (czcionka jest stałej szerokości)
+QString expandTabs(const QString &text)
+{
+    if (!text.contains('\t'))
+        return text;
+
+    QString result;
+    result.reserve(text.size() + kTabWidth);
+    for (QChar c : text) {
+        if (c == '\t')
+            result.append(QString(kTabWidth - result.size() % kTabWidth, ' '));
+        else
+            result.append(c);
+    }
+    return result;
+}
+}
+
+TextFileView::TextFileView(QWidget *parent)
+    : QAbstractScrollArea(parent),
+      textFont(QFontDatabase::systemFont(QFontDatabase::FixedFont))
+{
+    setFocusPolicy(Qt::StrongFocus);
+    updateMetrics();
+}
+
+void TextFileView::setIndex(TextFileIndex *newIndex)
+{
+    if (index)
+        disconnect(index, nullptr, this, nullptr);
+
+    index = newIndex;
+    maxColumns = 0;
+    pendingLine = -1;
+    pendingOffset = -1;
+
+    if (index)
+        connect(index, &TextFileIndex::progress, this, &TextFileView::onIndexProgress);
+
+    updateScrollRange();
+    horizontalScrollBar()->setValue(0);
+    verticalScrollBar()->setValue(0);
+    viewport()->update();
+}
+
+qint64 TextFileView::topLine() const
+{
+    return verticalScrollBar()->value();
+}
+
+int TextFileView::linesPerPage() const
+{
+    return qMax(1, viewport()->height() / lineHeight);
+}
+
+void TextFileView::pageDown()
+{
+    verticalScrollBar()->triggerAction(QAbstractSlider::SliderPageStepAdd);
+}
+
+void TextFileView::pageUp()
+{
+    verticalScrollBar()->triggerAction(QAbstractSlider::SliderPageStepSub);
+}
+
+void TextFileView::goToLine(qint64 line)
+{
+    if (!index || line < 0)
+        return;
+
+    // Linia jeszcze poza zaindeksowaną częścią — przejdziemy do niej później
+    if (line >= index->lineCount() && !index->isComplete()) {
+        pendingLine = line;
+        pendingOffset = -1;
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+        return;
+    }
+
+    pendingLine = -1;
+    pendingOffset = -1;
+    verticalScrollBar()->setValue(int(qMin(line, kMaxScrollLines)));
+}
+
+void TextFileView::goToPercent(double percent)
+{
+    if (!index)
+        return;
+
+    // Procent odnosi się do rozmiaru pliku; numer linii dla tej pozycji jest znany,
+    // gdy indeksowanie ją minęło
+    const qint64 offset = qint64(qBound(0.0, percent, 100.0) / 100.0 * index->fileSize());
+    if (offset < index->indexedSize() || index->isComplete()) {
+        goToLine(index->lineAtOffset(offset));
+    } else {
+        pendingLine = -1;
+        pendingOffset = offset;
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    }
+}
+
+void TextFileView::zoomIn()
+{
+    textFont.setPointSize(qMin(kMaxFontSize, textFont.pointSize() + 1));
+    updateMetrics();
+}
+
+void TextFileView::zoomOut()
+{
+    textFont.setPointSize(qMax(kMinFontSize, textFont.pointSize() - 1));
+    updateMetrics();
+}
+
+void TextFileView::updateMetrics()
+{
+    const QFontMetrics metrics(textFont);
+    lineHeight = qMax(1, metrics.lineSpacing());
+    charWidth = qMax(1, metrics.horizontalAdvance(QLatin1Char('M')));
+    updateScrollRange();
+    viewport()->update();
+}
+
+void TextFileView::updateScrollRange()
+{
+    const qint64 lines = index ? index->lineCount() : 0;
+    const int page = linesPerPage();
+
+    QScrollBar *vBar = verticalScrollBar();
+    vBar->setRange(0, int(qMin(kMaxScrollLines, qMax<qint64>(0, lines - page))));
+    vBar->setPageStep(page);
+    vBar->setSingleStep(1);
+
+    QScrollBar *hBar = horizontalScrollBar();
+    hBar->setRange(0, qMax(0, maxColumns * charWidth + 2 * kTextMargin - viewport()->width()));
+    hBar->setPageStep(viewport()->width());
+    hBar->setSingleStep(charWidth);
+}
+
+void TextFileView::onIndexProgress()
+{
+    updateScrollRange();
+
+    if (pendingLine >= 0 && (pendingLine < index->lineCount() || index->isComplete()))
+        goToLine(qMin(pendingLine, qMax<qint64>(0, index->lineCount() - 1)));
+    else if (pendingOffset >= 0 && (pendingOffset < index->indexedSize() || index->isComplete()))
+        goToLine(index->lineAtOffset(pendingOffset));
+
+    // Pierwszy ekran pojawia się, gdy tylko pierwszy blok pliku jest zaindeksowany
+    emit positionChanged(topLine(), index->lineCount());
+    viewport()->update();
+}
+
+void TextFileView::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), palette().base());
+    if (!index)
+        return;
+
+    painter.setFont(textFont);
+    const QFontMetrics metrics(textFont);
+    const qint64 lines = index->lineCount();
+    const qint64 first = topLine();
+    const qint64 last = qMin(lines - 1, first + linesPerPage());
+
+    // Kolumna numerów linii o szerokości największego widocznego numeru
+    const int gutterWidth = kTextMargin * 2 + metrics.horizontalAdvance(QString::number(last + 1));
+    painter.fillRect(QRect(0, 0, gutterWidth, viewport()->height()), palette().alternateBase());
+
+    const int textX = gutterWidth + kTextMargin - horizontalScrollBar()->value();
+    int widest = maxColumns;
+    for (qint64 line = first; line <= last; ++line) {
+        const int y = int(line - first) * lineHeight;
+        const int baseline = y + metrics.ascent();
+
+        const QString text = expandTabs(index->lineText(line, kMaxLineBytes));
+        widest = qMax(widest, int(text.size()));
+
+        painter.setClipRect(QRect(gutterWidth, y, viewport()->width() - gutterWidth, lineHeight));
+        painter.setPen(palette().text().color());
+        painter.drawText(textX, baseline, text);
+
+        painter.setClipping(false);
+        painter.setPen(palette().placeholderText().color());
+        painter.drawText(QRect(0, y, gutterWidth - kTextMargin, lineHeight),
+                         Qt::AlignRight | Qt::AlignVCenter, QString::number(line + 1));
+    }
+
+    // Poziomy pasek obejmuje najdłuższą linię widzianą do tej pory
+    if (widest != maxColumns) {
+        maxColumns = widest;
+        updateScrollRange();
+    }
+}
+
+void TextFileView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollRange();
+}
+
+void TextFileView::scrollContentsBy(int, int)
+{
+    if (index)
+        emit positionChanged(topLine(), index->lineCount());
+    viewport()->update();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QAbstractScrollArea>         // Bazowa klasa widoku z paskami przewijania
+#include <QFont>
+
+#include "textfileindex.h"             // Linie pliku odwzorowanego w pamięci
+
+// Widok dużego pliku tekstowego. Rysuje tylko linie mieszczące się w widoku
+// (pobierane z indeksu w chwili rysowania), więc koszt nie zależy od rozmiaru pliku.
+// Pionowy pasek przewijania liczy linie i rośnie razem z postępem indeksowania.
+class TextFileView : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    explicit TextFileView(QWidget *parent = nullptr);
+
+    // Ustawia indeks pliku (bez przejmowania własności); nullptr czyści widok
+    void setIndex(TextFileIndex *index);
+
+    // Przewinięcie o jeden ekran
+    void pageDown();
+    void pageUp();
+
+    // Skok do linii (indeksowanej od 0). Jeśli linia nie jest jeszcze zaindeksowana,
+    // widok przejdzie do niej, gdy indeksowanie do niej dotrze.
+    void goToLine(qint64 line);
+
+    // Skok do miejsca w pliku wyrażonego w procentach jego rozmiaru
+    void goToPercent(double percent);
+
+    // Zmiana rozmiaru czcionki
+    void zoomIn();
+    void zoomOut();
+
+    qint64 topLine() const;
+
+signals:
+    // Zmiana pozycji lub postęp indeksowania (do wyświetlenia stanu)
+    void positionChanged(qint64 topLine, qint64 lineCount);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    // Nowe linie w indeksie: zakres paska i ewentualny oczekujący skok
+    void onIndexProgress();
+
+    // Przeliczenie metryk czcionki i zakresów pasków przewijania
+    void updateMetrics();
+    void updateScrollRange();
+
+    // Liczba pełnych linii mieszczących się w widoku
+    int linesPerPage() const;
+
+    TextFileIndex *index = nullptr;
+    QFont textFont;
+    int lineHeight = 1;
+    int charWidth = 1;
+
+    // Najdłuższa narysowana dotąd linia w znakach (zakres poziomego paska)
+    int maxColumns = 0;
+
+    // Linia lub pozycja w pliku, do której ma przejść widok,
+    // gdy indeksowanie do niej dotrze (-1 = brak)
+    qint64 pendingLine = -1;
+    qint64 pendingOffset = -1;
+};
@@ -1,26 +1,89 @@
 #include "textviewer.h"         
+#include "tracing.h"
 #include <QFileDialog>          // Okno dialogowe do wyboru pliku
 #include <QMessageBox>          // Komunikaty błędów
-#include <QPixmap>              // Do konwersji obrazu PDF do wyświetlenia
 #include <QDir>                 // Ścieżki katalogów
+#include <QPdfSelection>        // Obszar trafienia wyszukiwania na stronie
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+#include <memory>
+#include <utility>
+
+#include "cacheutils.h"         // Tożsamość pliku (klucz renderów w PdfRenderCache)
+
+namespace {
+// Dokument karty nieużywanej dłużej niż ten czas jest zwalniany
+constexpr int kIdleReleaseMs = 2 * 60 * 1000;
+// Co ile sprawdzamy nieaktywne karty
+constexpr int kReleaseCheckMs = 30 * 1000;
+}
 
 // Inicjalizacja interfejsu użytkownika i łączenie przycisków z odpowiednimi funkcjami
 TextViewer::TextViewer(QWidget *parent)
     : QWidget(parent), currentPage(0)  // Ustawiamy aktualną stronę na 0
 {
-    // Tworzenie obiektu reprezentującego dokument PDF
-    pdfDoc = new QPdfDocument(this);
+    // Pusty dokument wyświetlany, dopóki nie zostanie otwarta żadna karta
+    blankDoc = new QPdfDocument(this);
+    pdfDoc = blankDoc;
+
+    // Karty otwartych dokumentów (każda pamięta swoją stronę i zoom)
+    tabBar = new QTabBar(this);
+    tabBar->setTabsClosable(true);
+    tabBar->setDocumentMode(true);
+    tabBar->setExpanding(false);
+    releaseTimer = new QTimer(this);
+    releaseTimer->setInterval(kReleaseCheckMs);
 
-    // Etykieta do wyświetlania strony jako obrazu
-    pageLabel = new QLabel(this);
-    pageLabel->setAlignment(Qt::AlignTop | Qt::AlignHCenter); // Wyśrodkowanie poziome, wyrównanie do góry
-    pageLabel->setMinimumSize(400, 600);                      // Minimalny rozmiar widoku strony
-    pageLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding); // Automatyczne skalowanie
+    // Widok do wyświetlania strony (render dopasowany do rozmiaru widoku i DPI ekranu)
+    pageView = new PdfView(this);
+    pageView->setMinimumSize(400, 600);                       // Minimalny rozmiar widoku strony
+    pageView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding); // Automatyczne skalowanie
+    pageView->setDocument(pdfDoc, QString());
+
+    // Widok plików tekstowych (np. logów) — tylko widoczne linie pliku odwzorowanego w pamięci
+    textIndex = new TextFileIndex(this);
+    textView = new TextFileView(this);
+    textView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    viewStack = new QStackedWidget(this);
+    viewStack->addWidget(pageView);
+    viewStack->addWidget(textView);
 
     // Tworzenie przycisków interfejsu
     openButton = new QPushButton("📁 File", this);      // Otwórz plik PDF
     prevButton = new QPushButton("←", this);           // Poprzednia strona
     nextButton = new QPushButton("→", this);           // Następna strona
+    zoomOutButton = new QPushButton("−", this);        // Pomniejszenie strony
+    zoomInButton = new QPushButton("+", this);         // Powiększenie strony
+    scrollModeButton = new QPushButton("📜 Scroll", this); // Przewijanie ciągłe / pojedyncza strona
+    scrollModeButton->setCheckable(true);
+    // Wyszukiwanie pełnotekstowe (indeks budowany w tle po otwarciu pliku)
+    searchIndex = new PdfSearchIndex(this);
+    searchEdit = new QLineEdit(this);
+    searchEdit->setPlaceholderText("🔍 Search");
+    searchEdit->setClearButtonEnabled(true);
+    prevHitButton = new QPushButton("▲", this);        // Poprzednie trafienie
+    nextHitButton = new QPushButton("▼", this);        // Następne trafienie
+    searchStatusLabel = new QLabel(this);              // Liczba trafień / postęp indeksowania
+    // Skok do linii lub procentu pliku tekstowego
+    gotoEdit = new QLineEdit(this);
+    gotoEdit->setPlaceholderText("Line or %");
+    gotoEdit->setClearButtonEnabled(true);
+    textStatusLabel = new QLabel(this);                // Bieżąca linia / postęp indeksowania
+    textStatusLabel->setWordWrap(true);
+    // Miniatury stron renderowane w tle; ustępują pierwszeństwa renderowaniu głównej strony
+    thumbnailBar = new PdfThumbnailBar(this);
+    thumbnailBar->yieldTo(pageView->pageRenderer());
+
+    // Stan wczytywania dokumentu (ukryty, dopóki nic się nie wczytuje)
+    loadStatusLabel = new QLabel(this);
+    loadStatusLabel->setWordWrap(true);
+    loadProgress = new QProgressBar(this);
+    loadProgress->setRange(0, 0);                      // Tryb "zajęty" — PDFium nie raportuje postępu
+    loadProgress->setTextVisible(false);
+    cancelLoadButton = new QPushButton("Cancel", this);
+    setLoadingState(false, QString());
+
     QPushButton *backButton = new QPushButton("Back to Menu", this); // Powrót do menu
     backButton->setFixedSize(120, 30);                 
 
@@ -28,6 +91,18 @@ TextViewer::TextViewer(QWidget *parent)
     int halfWidth = 60;
     prevButton->setFixedWidth(halfWidth);
     nextButton->setFixedWidth(halfWidth);
+    zoomOutButton->setFixedWidth(halfWidth);
+    zoomInButton->setFixedWidth(halfWidth);
+    scrollModeButton->setFixedWidth(2 * halfWidth + 5);  // Szerokość rzędu dwóch przycisków
+    searchEdit->setFixedWidth(2 * halfWidth + 5);
+    prevHitButton->setFixedWidth(halfWidth);
+    nextHitButton->setFixedWidth(halfWidth);
+    thumbnailBar->setFixedWidth(2 * halfWidth + 5);
+    gotoEdit->setFixedWidth(2 * halfWidth + 5);
+    textStatusLabel->setFixedWidth(2 * halfWidth + 5);
+    loadStatusLabel->setFixedWidth(2 * halfWidth + 5);
+    loadProgress->setFixedWidth(2 * halfWidth + 5);
+    cancelLoadButton->setFixedWidth(2 * halfWidth + 5);
 
     // === Rząd (poziomy układ) dla przycisków nawigacyjnych stron PDF ===
     QHBoxLayout *pageNavRow = new QHBoxLayout();      // Tworzymy układ poziomy
@@ -38,20 +113,46 @@ TextViewer::TextViewer(QWidget *parent)
     // Wyrównanie przyciskó do lewej strony
     pageNavRow->setAlignment(Qt::AlignLeft);
 
+    // === Rząd przycisków zoomu ===
+    QHBoxLayout *zoomRow = new QHBoxLayout();
+    zoomRow->setSpacing(5);
+    zoomRow->addWidget(zoomOutButton);
+    zoomRow->addWidget(zoomInButton);
+    zoomRow->setAlignment(Qt::AlignLeft);
+
+    // === Rząd przycisków poprzednie/następne trafienie ===
+    QHBoxLayout *hitNavRow = new QHBoxLayout();
+    hitNavRow->setSpacing(5);
+    hitNavRow->addWidget(prevHitButton);
+    hitNavRow->addWidget(nextHitButton);
+    hitNavRow->setAlignment(Qt::AlignLeft);
+
     // Lewy panel boczny z przyciskami (wertykalnie ułożony)
     QVBoxLayout *leftBar = new QVBoxLayout();
     leftBar->setContentsMargins(10, 10, 10, 10);        // Marginesy wokół przycisków
     leftBar->setSpacing(10);                           // Odstępy między przyciskami
     leftBar->addWidget(backButton);                    
     leftBar->addWidget(openButton);                    
+    leftBar->addWidget(loadStatusLabel);
+    leftBar->addWidget(loadProgress);
+    leftBar->addWidget(cancelLoadButton);
     leftBar->addLayout(pageNavRow);                                       
-    leftBar->addStretch();                             // Wypełnienie pustej przestrzeni poniżej
+    leftBar->addLayout(zoomRow);
+    leftBar->addWidget(scrollModeButton);
+    leftBar->addWidget(searchEdit);
+    leftBar->addLayout(hitNavRow);
+    leftBar->addWidget(searchStatusLabel);
+    leftBar->addWidget(gotoEdit);
+    leftBar->addWidget(textStatusLabel);
+    leftBar->addWidget(thumbnailBar, 1);               // Miniatury wypełniają przestrzeń poniżej
+    leftBar->addStretch();                             // W trybie tekstowym (bez miniatur) dociąga przyciski do góry
 
     // Główna sekcja wyświetlania PDF
-    QVBoxLayout *pdfLayout = new QVBoxLayout();        // Układ pionowy (tylko strona PDF)
+    QVBoxLayout *pdfLayout = new QVBoxLayout();        // Układ pionowy (strona PDF lub tekst)
     pdfLayout->setContentsMargins(0, 10, 10, 10);
     pdfLayout->setSpacing(0);
-    pdfLayout->addWidget(pageLabel);                   
+    pdfLayout->addWidget(tabBar);
+    pdfLayout->addWidget(viewStack);                    
 
     // Główny układ aplikacji: poziomy podział — lewa kolumna + prawa sekcja
     QHBoxLayout *mainLayout = new QHBoxLayout(this);
@@ -68,55 +169,416 @@ TextViewer::TextViewer(QWidget *parent)
     });
 
     connect(openButton, &QPushButton::clicked, this, &TextViewer::openPdf);   // Podłączenie sygnału kliknięcia przycisku openButton do funkcji openPdf() w klasie TextViewer
+    connect(cancelLoadButton, &QPushButton::clicked, this, &TextViewer::cancelLoad);
     connect(prevButton, &QPushButton::clicked, this, &TextViewer::prevPage);  
     connect(nextButton, &QPushButton::clicked, this, &TextViewer::nextPage);  
+    connect(zoomOutButton, &QPushButton::clicked, this, &TextViewer::zoomOut);
+    connect(zoomInButton, &QPushButton::clicked, this, &TextViewer::zoomIn);
+
+    // Tryb ciągły: wszystkie strony w jednym przewijanym widoku (renderowane tylko widoczne)
+    connect(scrollModeButton, &QPushButton::toggled, pageView, &PdfView::setContinuous);
+
+    // Wyszukiwanie: Enter = nowe zapytanie lub następne trafienie tej samej frazy
+    connect(searchEdit, &QLineEdit::returnPressed, this, [this]() {
+        if (searchEdit->text() == lastQuery && !searchHits.isEmpty())
+            nextHit();
+        else
+            runSearch();
+    });
+    connect(prevHitButton, &QPushButton::clicked, this, &TextViewer::prevHit);
+    connect(nextHitButton, &QPushButton::clicked, this, &TextViewer::nextHit);
+
+    // Kolejne zaindeksowane strony mogą dodać trafienia do bieżącego zapytania
+    connect(searchIndex, &PdfSearchIndex::progress, this, &TextViewer::refreshSearch);
+
+    // W trybie ciągłym bieżąca strona zmienia się razem z przewijaniem
+    connect(pageView, &PdfView::currentPageChanged, this, [this](int page) {
+        currentPage = page;
+        thumbnailBar->setCurrentPage(page);
+    });
+
+    // Kliknięcie miniatury — skok od razu do wybranej strony
+    connect(thumbnailBar, &PdfThumbnailBar::pageActivated, this, [this](int page) {
+        currentPage = page;
+        showPage();
+    });
+
+    // Tryb tekstowy: skok do linii / procentu i stan indeksowania
+    connect(gotoEdit, &QLineEdit::returnPressed, this, &TextViewer::goToTextPosition);
+    connect(textView, &TextFileView::positionChanged, this, &TextViewer::updateTextStatus);
+
+    // Karty: przełączenie, powrót z trybu tekstowego (kliknięcie bieżącej karty), zamknięcie
+    connect(tabBar, &QTabBar::currentChanged, this, &TextViewer::activateTab);
+    connect(tabBar, &QTabBar::tabBarClicked, this, [this](int index) {
+        if (textMode)
+            activateTab(index);
+    });
+    connect(tabBar, &QTabBar::tabCloseRequested, this, &TextViewer::closeTab);
+    connect(releaseTimer, &QTimer::timeout, this, &TextViewer::releaseIdleDocuments);
+    releaseTimer->start();
+
+    setTextMode(false);
+}
+
+// Zadanie wczytujące nie korzysta z widoku, więc wystarczy odrzucić jego wynik
+TextViewer::~TextViewer() {
+    loadTask.cancel();
 }
 
-// Funkcja otwierająca i wczytująca plik PDF
+// Funkcja otwierająca plik PDF lub tekstowy wybrany w oknie dialogowym
 void TextViewer::openPdf() {
-    // Okno dialogowe do wyboru pliku PDF
+    // Okno dialogowe do wyboru pliku PDF lub tekstowego
     QString fileName = QFileDialog::getOpenFileName(
-        this, "Open PDF", QDir::homePath(), "PDF files (*.pdf)"
+        this, "Open document", QDir::homePath(),
+        "Documents (*.pdf *.txt *.log *.csv *.json *.xml *.md);;"
+        "PDF files (*.pdf);;Text files (*.txt *.log *.csv *.json *.xml *.md);;All files (*)"
     );
 
     if (fileName.isEmpty()) return;  // Jeśli anulowano wybór, wtedy nic nie będzie zrobione
 
-    // Próba załadowania pliku PDF
-    QPdfDocument::Error err = pdfDoc->load(fileName);
-    if (err != QPdfDocument::Error::None) {
-        // Jeśli wystąpił błąd - wyświetli się komunikat
-        QMessageBox::critical(this, "Error", "Failed to load PDF file.");
+    // Wszystko poza PDF otwieramy jako tekst
+    if (QFileInfo(fileName).suffix().compare("pdf", Qt::CaseInsensitive) == 0)
+        loadPdf(fileName);
+    else
+        loadTextFile(fileName);
+}
+
+// Wczytanie pliku PDF poza wątkiem GUI (nowa karta albo ponowne wczytanie zwolnionej).
+// Zadanie wczytujące (VisibleNow) od razu renderuje też pierwszą stronę, więc pojawia się ona na ekranie
+// zanim wątki renderujące, miniatury i indeks wyszukiwania wczytają własne kopie dokumentu.
+void TextViewer::loadPdf(const QString &fileName) {
+    // Plik otwarty już w karcie — wystarczy ją pokazać
+    const int existing = findTab(fileName);
+    if (existing >= 0 && tabs[existing].document) {
+        tabBar->setCurrentIndex(existing);
+        activateTab(existing);
         return;
     }
 
-    currentPage = 0;  // Resetujemy do pierwszej strony
-    showPage();       // Wyświetlenie strony
+    // Dane wyniku wypełniane w zadaniu wczytującym i odczytywane w wątku GUI. Dokument, którego
+    // widok nie przejął (wynik odrzucony, błąd, anulowanie), jest usuwany w wątku GUI.
+    struct LoadResult {
+        ~LoadResult() {
+            if (document)
+                document->deleteLater();
+        }
+
+        QPdfDocument *document = nullptr;
+        QPdfDocument::Error error = QPdfDocument::Error::Unknown;
+        PdfRenderKey firstPageKey;
+        QImage firstPage;
+        qint64 loadMs = 0;
+        qint64 renderMs = 0;
+    };
+
+    loadTask.cancel();
+    loadingFile = fileName;
+    openTimer.start();
+    setLoadingState(true, QString("Loading %1…").arg(QFileInfo(fileName).fileName()));
+
+    // Parametry podglądu pierwszej strony (odczytane w wątku GUI)
+    auto result = std::make_shared<LoadResult>();
+    QThread *guiThread = thread();
+    const QSize viewportSize = pageView->viewport()->size();
+    const qreal dpr = pageView->devicePixelRatioF();
+    const bool continuous = pageView->isContinuous();
+    const int previewPage = existing >= 0 ? tabs[existing].page : 0;  // Strona, na której karta została
+
+    auto load = [result, fileName, guiThread, viewportSize, dpr, continuous, previewPage](const CancellationToken &token) {
+        QElapsedTimer timer;
+        timer.start();
+
+        // Dokument tworzony bez rodzica, a po wczytaniu przenoszony do wątku GUI
+        QPdfDocument *document = new QPdfDocument;
+        {
+            TRACE_SCOPE_INFO("pdf.load", fileName);
+            result->error = document->load(fileName);
+        }
+        result->loadMs = timer.elapsed();
+
+        if (result->error == QPdfDocument::Error::None && previewPage < document->pageCount()
+            && !token.isCancelled()) {
+            timer.restart();
+            const QSize pixelSize = PdfView::previewPixelSize(document->pagePointSize(previewPage),
+                                                              viewportSize, dpr, continuous);
+            if (!pixelSize.isEmpty()) {
+                TRACE_SCOPE("pdf.first_page_render");
+                result->firstPageKey = PdfRenderKey{previewPage, pixelSize, QRect()};
+                result->firstPage = document->render(previewPage, pixelSize);
+            }
+            result->renderMs = timer.elapsed();
+        }
+
+        document->moveToThread(guiThread);
+        result->document = document;
+        return result;
+    };
+
+    // Wynik wczytywania anulowanego lub zastąpionego nowszym nie wraca (anulowany token)
+    loadTask = TaskScheduler::instance().run(TaskPriority::VisibleNow, "pdf.open", this, load,
+                                             [this, fileName](std::shared_ptr<LoadResult> result) {
+        TRACE_SCOPE_INFO("pdf.show", fileName);
+        setLoadingState(false, QString());
+        loadingFile.clear();
+
+        int index = findTab(fileName);
+        if (result->error != QPdfDocument::Error::None) {
+            // Jeśli wystąpił błąd - wyświetli się komunikat (pozostałe karty zostają,
+            // a karta, której dokumentu nie da się już wczytać, jest zamykana)
+            if (index >= 0)
+                closeTab(index);
+            QMessageBox::critical(this, "Error", "Failed to load PDF file.");
+            return;
+        }
+
+        // Nowa karta albo ponownie wczytany dokument karty zwolnionej po bezczynności
+        // (karta z już wczytanym dokumentem, np. otwartym dwukrotnie, zostaje bez zmian)
+        if (index < 0) {
+            DocumentTab tab;
+            tab.fileName = fileName;
+            tab.document = std::exchange(result->document, nullptr);
+            tab.document->setParent(this);
+            tabs.append(tab);
+            index = int(tabs.size()) - 1;
+            tabBar->addTab(QFileInfo(fileName).fileName());
+            tabBar->setTabToolTip(index, fileName);
+        } else if (!tabs[index].document) {
+            tabs[index].document = std::exchange(result->document, nullptr);
+            tabs[index].document->setParent(this);
+        }
+
+        tabBar->setCurrentIndex(index);
+        activateTab(index);            // Dokument w widoku, strona i zoom karty
+        if (!result->firstPage.isNull())
+            pageView->seedRender(result->firstPageKey, result->firstPage);
+
+        const qint64 shownMs = openTimer.elapsed();
+        qDebug().noquote() << QString("[pdf-open] file=\"%1\" pages=%2 load_ms=%3 first_render_ms=%4 shown_ms=%5")
+                                  .arg(fileName).arg(pdfDoc->pageCount())
+                                  .arg(result->loadMs).arg(result->renderMs).arg(shownMs);
+
+        // Czasy można też dopisywać do pliku CSV (np. przy przebiegu po korpusie dokumentów)
+        const QString timingsPath = qEnvironmentVariable("PDF_OPEN_TIMINGS");
+        if (!timingsPath.isEmpty()) {
+            QFile timings(timingsPath);
+            if (timings.open(QIODevice::Append | QIODevice::Text)) {
+                timings.write(QString("%1,%2,%3,%4,%5\n")
+                                  .arg(fileName).arg(pdfDoc->pageCount())
+                                  .arg(result->loadMs).arg(result->renderMs).arg(shownMs)
+                                  .toUtf8());
+            }
+        }
+
+        emit pdfLoaded(fileName, result->loadMs, result->renderMs);
+    });
 }
 
+int TextViewer::findTab(const QString &fileName) const {
+    for (int i = 0; i < tabs.size(); ++i) {
+        if (tabs[i].fileName == fileName)
+            return i;
+    }
+    return -1;
+}
 
-// Funkcja renderująca aktualną stronę PDF i wyświetlająca ją jako obraz
-void TextViewer::showPage() {
-    if (!pdfDoc || pdfDoc->pageCount() <= 0) return;  // Koniec metody przy braku dokumentu
+void TextViewer::activateTab(int index) {
+    if (index < 0 || index >= tabs.size() || (index == activeTab && !textMode))
+        return;
 
-    QSize imageSize(1600, 1000);                      // Rozdzielczość renderowania strony
-    QPdfDocumentRenderOptions options;                // Opcje renderowania (domyślne)
+    // Dokument zwolniony po bezczynności — wczytanie w tle, potem karta zostanie pokazana
+    DocumentTab &tab = tabs[index];
+    if (!tab.document) {
+        loadPdf(tab.fileName);
+        return;
+    }
+
+    saveActiveTabState();
+
+    // Powrót z trybu tekstowego — plik tekstowy nie jest już potrzebny
+    if (textMode) {
+        setTextMode(false);
+        textView->setIndex(nullptr);
+        textIndex->close();
+    }
+
+    activeTab = index;
+    pdfDoc = tab.document;
+    tab.lastActive.start();
 
-    // Renderowanie aktualnej strony jako obrazu
-    QImage image = pdfDoc->render(currentPage, imageSize, options);
+    // Rendery dokumentu są we wspólnej pamięci, więc strony oglądane niedawno są od razu gotowe
+    pageView->setDocument(pdfDoc, tab.fileName);
+    pageView->setZoomFactor(tab.zoom);
+    currentPage = qMax(0, qMin(tab.page, pdfDoc->pageCount() - 1));
+    showPage();
 
-    if (image.isNull()) {
-        // Jeśli nie udało się wyrenderować, to pakazuje się błąd
-        QMessageBox::warning(this, "Error", "Unable to render PDF page.");
+    // Prace w tle startują dopiero, gdy strona jest już na ekranie
+    thumbnailBar->setDocument(pdfDoc, tab.fileName);
+    thumbnailBar->setCurrentPage(currentPage);
+
+    // Indeksowanie tekstu w tle (lub wczytanie indeksu zapisanego przy poprzednim otwarciu)
+    lastQuery.clear();
+    searchHits.clear();
+    currentHit = -1;
+    searchIndex->setDocument(tab.fileName);
+    updateSearchStatus();
+}
+
+void TextViewer::saveActiveTabState() {
+    if (activeTab < 0 || activeTab >= tabs.size())
         return;
+
+    DocumentTab &tab = tabs[activeTab];
+    tab.page = currentPage;
+    tab.zoom = pageView->zoomFactor();
+    tab.lastActive.start();            // Od tej chwili liczy się czas bezczynności
+}
+
+void TextViewer::closeTab(int index) {
+    if (index < 0 || index >= tabs.size())
+        return;
+
+    const DocumentTab tab = tabs.takeAt(index);
+    if (tab.fileName == loadingFile)
+        cancelLoad();
+
+    if (index == activeTab) {
+        // Widok nie może wskazywać na usuwany dokument
+        activeTab = -1;
+        pdfDoc = blankDoc;
+        pageView->setDocument(blankDoc, QString());
+        thumbnailBar->setDocument(nullptr, QString());
+        lastQuery.clear();
+        searchHits.clear();
+        currentHit = -1;
+        searchIndex->setDocument(QString());
+        updateSearchStatus();
+    } else if (index < activeTab) {
+        --activeTab;
     }
 
-    // Przekształcenie QImage na QPixmap i wyświetlenie w etykiecie
-    pageLabel->setPixmap(QPixmap::fromImage(image));
+    // Usunięcie karty może wybrać sąsiednią (currentChanged -> activateTab)
+    tabBar->removeTab(index);
+    delete tab.document;
+    PdfRenderCache::instance().removeDocument(CacheUtils::fileIdentityKey(tab.fileName));
+}
+
+void TextViewer::releaseIdleDocuments() {
+    for (int i = 0; i < tabs.size(); ++i) {
+        DocumentTab &tab = tabs[i];
+        if (i == activeTab || !tab.document || tab.lastActive.elapsed() < kIdleReleaseMs)
+            continue;
+
+        // Strona i zoom zostają w karcie; dokument zostanie wczytany ponownie przy powrocie
+        qDebug() << "TextViewer: releasing idle document" << tab.fileName;
+        delete tab.document;
+        tab.document = nullptr;
+    }
+}
+
+// Otwarcie pliku tekstowego. Plik jest odwzorowany w pamięci, a indeks linii powstaje
+// w tle — pierwszy ekran pojawia się po zaindeksowaniu pierwszego bloku pliku,
+// niezależnie od jego rozmiaru.
+void TextViewer::loadTextFile(const QString &fileName) {
+    cancelLoad();                      // Ewentualne wczytywanie PDF nie podmieni już widoku
+    openTimer.start();
+
+    textView->setIndex(nullptr);
+    if (!textIndex->open(fileName)) {
+        QMessageBox::critical(this, "Error", "Failed to open text file.");
+        setTextMode(false);
+        return;
+    }
+
+    // Czas do pierwszego ekranu (pierwszy sygnał postępu = pierwsze linie gotowe)
+    textOpenLog = connect(textIndex, &TextFileIndex::progress, this, [this, fileName]() {
+        qDebug().noquote() << QString("[text-open] file=\"%1\" size=%2 first_screen_ms=%3")
+                                  .arg(fileName).arg(textIndex->fileSize()).arg(openTimer.elapsed());
+    }, Qt::SingleShotConnection);
+
+    textView->setIndex(textIndex);
+    gotoEdit->clear();
+    setTextMode(true);
+    updateTextStatus();
+}
+
+void TextViewer::setTextMode(bool enabled) {
+    textMode = enabled;
+    viewStack->setCurrentWidget(enabled ? static_cast<QWidget *>(textView) : pageView);
+
+    // Elementy dotyczące tylko PDF lub tylko tekstu
+    scrollModeButton->setVisible(!enabled);
+    searchEdit->setVisible(!enabled);
+    prevHitButton->setVisible(!enabled);
+    nextHitButton->setVisible(!enabled);
+    searchStatusLabel->setVisible(!enabled);
+    thumbnailBar->setVisible(!enabled);
+    gotoEdit->setVisible(enabled);
+    textStatusLabel->setVisible(enabled);
+}
+
+// "120" = linia 120, "50%" = połowa pliku
+void TextViewer::goToTextPosition() {
+    QString input = gotoEdit->text().trimmed();
+    bool ok = false;
+    if (input.endsWith('%')) {
+        input.chop(1);
+        const double percent = input.toDouble(&ok);
+        if (ok)
+            textView->goToPercent(percent);
+    } else {
+        const qint64 line = input.toLongLong(&ok);
+        if (ok)
+            textView->goToLine(line - 1);
+    }
+    textView->setFocus();
+}
+
+// Tekst stanu: "Line 1200 / 45000" oraz postęp indeksowania, jeśli jeszcze trwa
+void TextViewer::updateTextStatus() {
+    const qint64 lines = textIndex->lineCount();
+    QString status = QString("Line %1 / %2").arg(lines > 0 ? textView->topLine() + 1 : 0).arg(lines);
+
+    const qint64 size = textIndex->fileSize();
+    if (size > 0 && !textIndex->isComplete())
+        status += QString("\nIndexing %1%").arg(textIndex->indexedSize() * 100 / size);
+
+    textStatusLabel->setText(status);
+}
+
+// Anulowanie wczytywania. PDFium nie pozwala przerwać parsowania, więc zadanie kończy pracę
+// w tle (bez renderu pierwszej strony), a jego wynik zostaje odrzucony.
+void TextViewer::cancelLoad() {
+    loadTask.cancel();
+    disconnect(textOpenLog);
+    loadingFile.clear();
+    setLoadingState(false, QString());
+}
+
+void TextViewer::setLoadingState(bool loading, const QString &message) {
+    loadStatusLabel->setText(message);
+    loadStatusLabel->setVisible(loading);
+    loadProgress->setVisible(loading);
+    cancelLoadButton->setVisible(loading);
+}
+
+
+// Funkcja wyświetlająca aktualną stronę PDF.
+// Samo renderowanie odbywa się w PdfView, w rozdzielczości wynikającej z rozmiaru strony
+// w punktach, rozmiaru widoku, zoomu i devicePixelRatio (dla dużych powiększeń — kafelkami).
+void TextViewer::showPage() {
+    if (!pdfDoc || pdfDoc->pageCount() <= 0) return;  // Koniec metody przy braku dokumentu
+
+    pageView->setPage(currentPage);
+    thumbnailBar->setCurrentPage(currentPage);
 }
 
 
 // Przejście do następnej strony (jeśli nie jest koniec pliku)
 void TextViewer::nextPage() {
+    if (textMode) {
+        textView->pageDown();
+        return;
+    }
     if (currentPage + 1 < pdfDoc->pageCount()) {
         ++currentPage;
         showPage();
@@ -125,8 +587,99 @@ void TextViewer::nextPage() {
 
 // Przejście do poprzedniej strony (jeśli nie jest to początek pliku) 
 void TextViewer::prevPage() {
+    if (textMode) {
+        textView->pageUp();
+        return;
+    }
     if (currentPage > 0) {
         --currentPage;
         showPage();
     }
 }
+
+// Powiększenie strony — PdfView renderuje ją ponownie w wyższej rozdzielczości
+void TextViewer::zoomIn() {
+    if (textMode)
+        textView->zoomIn();
+    else
+        pageView->zoomIn();
+}
+
+// Pomniejszenie strony
+void TextViewer::zoomOut() {
+    if (textMode)
+        textView->zoomOut();
+    else
+        pageView->zoomOut();
+}
+
+// Nowe zapytanie — wyniki pochodzą z indeksu (także częściowego, w trakcie indeksowania)
+void TextViewer::runSearch() {
+    lastQuery = searchEdit->text();
+    searchHits = searchIndex->search(lastQuery, 0, &searchedPages);
+    currentHit = -1;
+
+    if (!searchHits.isEmpty()) {
+        showHit(0);
+    } else {
+        pageView->clearHighlight();
+        updateSearchStatus();
+    }
+}
+
+// Dołożenie trafień z nowo zaindeksowanych stron. Strony są indeksowane po kolei, więc
+// przeszukiwane są tylko strony dodane od poprzedniego wyszukiwania, a ich trafienia trafiają
+// na koniec listy (numer bieżącego trafienia pozostaje ważny).
+void TextViewer::refreshSearch() {
+    if (!lastQuery.isEmpty()) {
+        searchHits += searchIndex->search(lastQuery, searchedPages, &searchedPages);
+        if (currentHit < 0 && !searchHits.isEmpty()) {
+            showHit(0);
+            return;
+        }
+    }
+    updateSearchStatus();
+}
+
+// Przejście do trafienia: pozycja znakowa z indeksu -> obszar na stronie -> podświetlenie
+void TextViewer::showHit(int index) {
+    if (index < 0 || index >= searchHits.size()) return;
+
+    currentHit = index;
+    const PdfSearchHit &hit = searchHits[index];
+    currentPage = hit.page;
+    thumbnailBar->setCurrentPage(currentPage);
+
+    QPdfSelection selection = pdfDoc->getSelectionAtIndex(hit.page, hit.charIndex, hit.length);
+    pageView->showHighlight(hit.page, selection.bounds());
+    updateSearchStatus();
+}
+
+void TextViewer::nextHit() {
+    if (searchHits.isEmpty()) return;
+    showHit((currentHit + 1) % searchHits.size());
+}
+
+void TextViewer::prevHit() {
+    if (searchHits.isEmpty()) return;
+    showHit((currentHit - 1 + searchHits.size()) % searchHits.size());
+}
+
+// Tekst statusu: "3 / 27" oraz postęp indeksowania, jeśli jeszcze trwa
+void TextViewer::updateSearchStatus() {
+    QString status;
+    if (!lastQuery.isEmpty()) {
+        status = searchHits.isEmpty()
+                     ? QString("No results")
+                     : QString("%1 / %2").arg(currentHit + 1).arg(searchHits.size());
+    }
+
+    const int total = searchIndex->pageCount();
+    const int indexed = searchIndex->indexedPageCount();
+    if (total > 0 && indexed < total) {
+        if (!status.isEmpty()) status += "\n";
+        status += QString("Indexing %1%").arg(indexed * 100 / total);
+    }
+
+    searchStatusLabel->setText(status);
+}
@@ -3,36 +3,127 @@
 #include <QWidget>                     // Klasa bazowa dla wszystkich komponentów GUI
 #include <QPdfDocument>                // Klasa umożliwiająca wczytywanie dokumentów PDF
 #include <QPdfDocumentRenderOptions>   // Dodatkowe opcje renderowania PDF
-#include <QLabel>                      // Do wyświetlania obrazu strony PDF
+#include <QLabel>                      // Etykiety interfejsu
 #include <QPushButton>                 // Przycisk GUI
 #include <QVBoxLayout>                 // Układ pionowy (layout)
 #include <QHBoxLayout>                 // Układ poziomy (layout)
+#include <QLineEdit>                   // Pole wyszukiwania
+#include <QProgressBar>                // Stan wczytywania dokumentu
+#include <QElapsedTimer>               // Pomiar czasów otwierania
+#include <QStackedWidget>              // Przełączanie widoku PDF / tekstu
+#include <QTabBar>                     // Karty otwartych dokumentów
+#include <QTimer>                      // Zwalnianie nieużywanych dokumentów
 
+#include "pdfview.h"                   // Widok strony renderowanej w rozdzielczości ekranu
+#include "pdfsearchindex.h"            // Pełnotekstowy indeks dokumentu budowany w tle
+#include "pdfthumbnailbar.h"           // Pasek miniatur stron
+#include "textfileindex.h"             // Indeks linii dużych plików tekstowych
+#include "textfileview.h"              // Widok widocznych linii pliku tekstowego
+#include "taskscheduler.h"             // Wczytywanie dokumentu w puli zadań
 
-// Służy do przeglądania dokumentów PDF strona po stronie.
-// Umożliwia otwieranie pliku, nawigację (następna/poprzednia strona) oraz powrót do menu.
+
+// Służy do przeglądania dokumentów PDF strona po stronie oraz dużych plików tekstowych
+// (np. logów). Umożliwia otwieranie pliku, nawigację (następna/poprzednia strona
+// lub ekran tekstu) oraz powrót do menu.
 class TextViewer : public QWidget {
     Q_OBJECT  // Umożliwia używanie sygnałów i slotów Qt
 
 public:
     // Konstruktor — tworzy widżet PDF (opcjonalnie z rodzicem)
     explicit TextViewer(QWidget *parent = nullptr);
+    ~TextViewer() override;
     
-    // Slot otwierający plik PDF z systemowego okna dialogowego
+    // Slot otwierający plik PDF lub tekstowy z systemowego okna dialogowego
     void openPdf();
 
-    // Slot przechodzący do następnej strony PDF
+    // Wczytanie pliku PDF w tle; interfejs (i obsługa gestów) działa w trakcie wczytywania
+    void loadPdf(const QString &fileName);
+
+    // Otwarcie pliku tekstowego (odwzorowanie w pamięci, indeks linii budowany w tle)
+    void loadTextFile(const QString &fileName);
+
+    // Slot przechodzący do następnej strony PDF (w trybie tekstowym — następny ekran)
     void nextPage();
 
-    // Slot przechodzący do poprzedniej strony PDF
+    // Slot przechodzący do poprzedniej strony PDF (w trybie tekstowym — poprzedni ekran)
     void prevPage();
 
+    // Powiększenie / pomniejszenie strony (ponowne renderowanie w nowej rozdzielczości)
+    // albo czcionki w trybie tekstowym
+    void zoomIn();
+    void zoomOut();
+
+    // Anulowanie wczytywania dokumentu (przycisk Cancel, wyjście z przeglądarki)
+    void cancelLoad();
+
 private:
-    // Wskaźnik do dokumentu PDF, który został wczytany
+    // Wskaźnik do dokumentu PDF aktywnej karty (albo pustego dokumentu, gdy kart nie ma)
     QPdfDocument *pdfDoc;
 
-    // Etykieta" (pageLabel) czyli miejsce w interfejsie, w którym użytkownik widzi aktualną stronę PDF jako obraz.
-    QLabel *pageLabel;
+    // Pusty dokument wyświetlany, gdy żadna karta nie jest otwarta
+    QPdfDocument *blankDoc;
+
+    // Otwarty dokument (karta): plik, pozycja czytania i — dopóki karta była niedawno
+    // używana — wczytany dokument. Po czasie bezczynności dokument jest zwalniany
+    // i wczytywany ponownie przy powrocie do karty (rendery stron zostają w PdfRenderCache).
+    struct DocumentTab {
+        QString fileName;
+        QPdfDocument *document = nullptr;
+        int page = 0;
+        double zoom = 1.0;
+        QElapsedTimer lastActive;
+    };
+
+    QTabBar *tabBar;
+    QList<DocumentTab> tabs;
+    int activeTab = -1;
+
+    // Okresowe sprawdzanie nieaktywnych kart
+    QTimer *releaseTimer;
+
+    // Plik wczytywany w tle (pusty, gdy nic się nie wczytuje)
+    QString loadingFile;
+
+    int findTab(const QString &fileName) const;
+
+    // Pokazanie karty: dokument w widoku, przywrócenie strony i zoomu,
+    // miniatury i indeks wyszukiwania dla tego dokumentu
+    void activateTab(int index);
+
+    // Zapamiętanie pozycji czytania aktywnej karty
+    void saveActiveTabState();
+
+    void closeTab(int index);
+
+    // Zwolnienie dokumentów kart nieużywanych dłużej niż limit czasu
+    void releaseIdleDocuments();
+
+    // Widok strony (pageView), czyli miejsce w interfejsie, w którym użytkownik widzi aktualną stronę PDF.
+    // Renderuje stronę w rozdzielczości zależnej od rozmiaru widoku, zoomu i DPI ekranu.
+    PdfView *pageView;
+
+    // Widok pliku tekstowego i jego indeks linii
+    TextFileView *textView;
+    TextFileIndex *textIndex;
+
+    // Przełącznik widoków: pageView albo textView
+    QStackedWidget *viewStack;
+
+    // Czy wyświetlany jest plik tekstowy (a nie PDF)
+    bool textMode = false;
+
+    // Skok do linii ("120") lub procentu pliku ("50%") w trybie tekstowym
+    QLineEdit *gotoEdit;
+    QLabel *textStatusLabel;
+
+    // Przełączenie panelu bocznego i widoku między trybem PDF a tekstowym
+    void setTextMode(bool enabled);
+
+    // Obsługa pola gotoEdit
+    void goToTextPosition();
+
+    // Aktualizacja tekstu stanu: bieżąca linia i postęp indeksowania
+    void updateTextStatus();
 
     // Przycisk otwierający plik PDF
     QPushButton *openButton;
@@ -43,13 +134,68 @@ private:
     // Przycisk do przejścia na poprzednią stronę
     QPushButton *prevButton;
 
+    // Przyciski zoomu
+    QPushButton *zoomInButton;
+    QPushButton *zoomOutButton;
+
+    // Przełącznik trybu przewijania ciągłego (wszystkie strony jedna pod drugą)
+    QPushButton *scrollModeButton;
+
     // Numer aktualnie wyświetlanej strony (indeksowana od 0)
     int currentPage;
 
-    // Funkcja renderująca i wyświetlająca bieżącą stronę PDF
+    // Stan wczytywania: komunikat, wskaźnik postępu i przycisk anulowania
+    QLabel *loadStatusLabel;
+    QProgressBar *loadProgress;
+    QPushButton *cancelLoadButton;
+
+    // Bieżące wczytywanie; anulowanie (lub nowe wczytywanie) anuluje jego token,
+    // więc wynik nieaktualnego wczytywania nie wraca do widoku
+    TaskHandle loadTask;
+
+    // Czas od wyboru pliku (do logowania czasów otwierania)
+    QElapsedTimer openTimer;
+    // Jednorazowy wpis czasu pierwszego ekranu pliku tekstowego (rozłączany przy anulowaniu)
+    QMetaObject::Connection textOpenLog;
+
+    // Pokazanie / ukrycie stanu wczytywania
+    void setLoadingState(bool loading, const QString &message);
+
+    // Miniatury stron w lewym panelu (kliknięcie = skok do strony)
+    PdfThumbnailBar *thumbnailBar;
+
+    // Wyszukiwanie: indeks budowany w tle po otwarciu dokumentu
+    PdfSearchIndex *searchIndex;
+    QLineEdit *searchEdit;
+    QPushButton *prevHitButton;
+    QPushButton *nextHitButton;
+    QLabel *searchStatusLabel;
+
+    // Wyniki bieżącego zapytania (uzupełniane w trakcie indeksowania)
+    QString lastQuery;
+    QList<PdfSearchHit> searchHits;
+    int currentHit = -1;
+    int searchedPages = 0;   // Strony już przeszukane dla lastQuery (kolejne dokłada refreshSearch)
+
+    // Wyszukiwanie frazy z pola searchEdit i przejście do pierwszego trafienia
+    void runSearch();
+
+    // Odświeżenie wyników po zaindeksowaniu kolejnych stron (bez zmiany bieżącego trafienia)
+    void refreshSearch();
+
+    // Przejście do trafienia o danym numerze i jego podświetlenie
+    void showHit(int index);
+    void nextHit();
+    void prevHit();
+    void updateSearchStatus();
+
+    // Funkcja wyświetlająca bieżącą stronę PDF
     void showPage();
 
 signals:
     // Sygnał wysyłany, gdy użytkownik chce wrócić do menu głównego
     void backToMenuRequested();    
+
+    // Dokument wczytany i pierwsza strona wyświetlona (czasy w milisekundach)
+    void pdfLoaded(const QString &fileName, qint64 loadMs, qint64 firstRenderMs);
 };
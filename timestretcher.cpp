@@ -0,0 +1,189 @@
+#include "timestretcher.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>          // SSE: korelacja po cztery próbki naraz
+#define TIMESTRETCHER_SSE
+#endif
+
+namespace {
+// Długość okna i zakres szukania dopasowania
+constexpr double kWindowSeconds = 0.040;
+constexpr double kToleranceSeconds = 0.008;
+// Szukanie zgrubne co tyle ramek, potem dokładne wokół najlepszego
+constexpr int kCoarseStep = 4;
+
+// Iloczyn skalarny kandydata i wzorca oraz energia kandydata
+void dotAndEnergy(const float *a, const float *b, int n, float *dot, float *energy)
+{
+    int i = 0;
+    float d = 0.0f, e = 0.0f;
+#ifdef TIMESTRETCHER_SSE
+    __m128 vd = _mm_setzero_ps();
+    __m128 ve = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        const __m128 va = _mm_loadu_ps(a + i);
+        vd = _mm_add_ps(vd, _mm_mul_ps(va, _mm_loadu_ps(b + i)));
+        ve = _mm_add_ps(ve, _mm_mul_ps(va, va));
+    }
+    float sd[4], se[4];
+    _mm_storeu_ps(sd, vd);
+    _mm_storeu_ps(se, ve);
+    d = sd[0] + sd[1] + sd[2] + sd[3];
+    e = se[0] + se[1] + se[2] + se[3];
+#endif
+    for (; i < n; ++i) {
+        d += a[i] * b[i];
+        e += a[i] * a[i];
+    }
+    *dot = d;
+    *energy = e;
+}
+}
+
+TimeStretcher::TimeStretcher(int sampleRate, int channels)
+{
+    configure(sampleRate, channels);
+}
+
+void TimeStretcher::configure(int sampleRate, int channels)
+{
+    rate = std::max(8000, sampleRate);
+    channelCount = std::max(1, channels);
+    hop = int(rate * kWindowSeconds / 2);
+    tolerance = int(rate * kToleranceSeconds);
+
+    // Okno Hanna okresowe: nakładane co pół okna sumuje się do 1
+    window.resize(2 * hop);
+    for (int i = 0; i < 2 * hop; ++i)
+        window[i] = float(0.5 - 0.5 * std::cos(M_PI * i / hop));
+
+    // Zapas: blok wejścia + okno + szukanie + najdłuższy krok analizy
+    capacity = kMaxBlockFrames + 2 * hop + 2 * tolerance + int(std::ceil(hop * kMaxSpeed)) + hop;
+    input.assign(size_t(capacity) * channelCount, 0.0f);
+    mono.assign(capacity, 0.0f);
+    overlap.assign(size_t(hop) * channelCount, 0.0f);
+    reset();
+}
+
+void TimeStretcher::setSpeed(double speed)
+{
+    targetSpeed = std::clamp(speed, kMinSpeed, kMaxSpeed);
+}
+
+int TimeStretcher::maxOutputFrames(int inputFrames) const
+{
+    return int((inputFrames + capacity) / kMinSpeed) + hop;
+}
+
+void TimeStretcher::reset()
+{
+    filled = 0;
+    analysisPos = tolerance;        // Miejsce na szukanie wstecz od pierwszego okna
+    templateStart = -1;
+    std::fill(overlap.begin(), overlap.end(), 0.0f);
+}
+
+int TimeStretcher::process(const float *samples, int frames, float *output)
+{
+    int written = 0;
+    while (frames > 0) {
+        const int block = std::min(frames, kMaxBlockFrames);
+        written += processBlock(samples, block, output + size_t(written) * channelCount);
+        samples += size_t(block) * channelCount;
+        frames -= block;
+    }
+    return written;
+}
+
+int TimeStretcher::processBlock(const float *samples, int frames, float *output)
+{
+    // Dopisanie wejścia (przeplecione i mono)
+    std::memcpy(input.data() + size_t(filled) * channelCount, samples, sizeof(float) * size_t(frames) * channelCount);
+    const float scale = 1.0f / channelCount;
+    for (int f = 0; f < frames; ++f) {
+        float sum = 0.0f;
+        for (int c = 0; c < channelCount; ++c)
+            sum += samples[f * channelCount + c];
+        mono[filled + f] = sum * scale;
+    }
+    filled += frames;
+
+    int written = 0;
+    for (;;) {
+        const int center = int(analysisPos);
+        const int from = std::max(0, center - tolerance);
+        const int to = center + tolerance;
+        if (to + 2 * hop > filled || (templateStart >= 0 && templateStart + hop > filled))
+            break;
+
+        const int chosen = templateStart < 0 ? center : bestOffset(from, to, templateStart);
+
+        // Pierwsza połowa okna nakłada się na zapamiętaną drugą połowę poprzedniego
+        const float *segment = input.data() + size_t(chosen) * channelCount;
+        float *out = output + size_t(written) * channelCount;
+        for (int i = 0; i < hop; ++i) {
+            const float wIn = window[i];
+            const float wOut = window[hop + i];
+            for (int c = 0; c < channelCount; ++c) {
+                const int k = i * channelCount + c;
+                out[k] = overlap[k] + wIn * segment[k];
+                overlap[k] = wOut * segment[hop * channelCount + k];
+            }
+        }
+        written += hop;
+
+        templateStart = chosen + hop;
+        analysisPos += hop * targetSpeed.load(std::memory_order_relaxed);
+    }
+
+    // Usunięcie wejścia, którego żadne następne okno ani wzorzec już nie użyje
+    const int discard = std::min(int(analysisPos) - tolerance, templateStart < 0 ? filled : templateStart);
+    if (discard > 0) {
+        const int keep = filled - discard;
+        std::memmove(input.data(), input.data() + size_t(discard) * channelCount, sizeof(float) * size_t(keep) * channelCount);
+        std::memmove(mono.data(), mono.data() + discard, sizeof(float) * size_t(keep));
+        filled = keep;
+        analysisPos -= discard;
+        if (templateStart >= 0)
+            templateStart -= discard;
+    }
+    return written;
+}
+
+int TimeStretcher::bestOffset(int from, int to, int templateStart) const
+{
+    const float *pattern = mono.data() + templateStart;
+    const int length = hop;
+
+    auto score = [&](int start) {
+        float dot, energy;
+        dotAndEnergy(mono.data() + start, pattern, length, &dot, &energy);
+        return dot / std::sqrt(energy + 1e-9f);
+    };
+
+    // Zgrubnie co kCoarseStep, potem dokładnie wokół najlepszego
+    int best = from;
+    float bestScore = score(from);
+    for (int start = from + kCoarseStep; start <= to; start += kCoarseStep) {
+        const float s = score(start);
+        if (s > bestScore) {
+            bestScore = s;
+            best = start;
+        }
+    }
+    const int refineFrom = std::max(from, best - kCoarseStep + 1);
+    const int refineTo = std::min(to, best + kCoarseStep - 1);
+    for (int start = refineFrom; start <= refineTo; ++start) {
+        if (start == best)
+            continue;
+        const float s = score(start);
+        if (s > bestScore) {
+            bestScore = s;
+            best = start;
+        }
+    }
+    return best;
+}
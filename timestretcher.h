@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+// Zmiana tempa dźwięku bez zmiany wysokości (WSOLA), bez zależności od Qt Multimedia,
+// żeby dało się ją mierzyć osobno w benchmarku.
+// Wyjście składa się z okien Hanna 40 ms nakładanych co 20 ms; kolejne okno jest pobierane
+// z wejścia co 20 ms × prędkość, przesunięte w granicach ±8 ms tak, żeby najlepiej pasowało
+// (korelacja znormalizowana, liczona w SSE) do naturalnej kontynuacji poprzedniego okna.
+// Dzięki temu zmiana prędkości w trakcie odtwarzania działa od następnego okna bez trzasków.
+// Pamięć jest przydzielana tylko w configure(); process() nie alokuje.
+class TimeStretcher {
+public:
+    static constexpr double kMinSpeed = 0.5;
+    static constexpr double kMaxSpeed = 3.0;
+    // Największy fragment wejścia przetwarzany naraz (dłuższe są dzielone)
+    static constexpr int kMaxBlockFrames = 4096;
+
+    explicit TimeStretcher(int sampleRate = 44100, int channels = 2);
+
+    // Nowy format (przydział buforów — poza wątkiem dźwięku albo przy zmianie formatu)
+    void configure(int sampleRate, int channels);
+    int sampleRate() const { return rate; }
+    int channels() const { return channelCount; }
+
+    // Prędkość 0.5–3.0; bezpieczne z dowolnego wątku, działa od następnego okna
+    void setSpeed(double speed);
+    double speed() const { return targetSpeed.load(); }
+
+    // Najwięcej ramek, które process() może zapisać dla podanej liczby ramek wejścia
+    int maxOutputFrames(int inputFrames) const;
+
+    // Próbki przeplecione; zwraca liczbę ramek zapisanych do output
+    int process(const float *input, int frames, float *output);
+
+    // Wyczyszczenie stanu (przewinięcie, nowy utwór) — bez przydziału pamięci
+    void reset();
+
+private:
+    int processBlock(const float *input, int frames, float *output);
+    int bestOffset(int from, int to, int templateStart) const;
+
+    int rate = 0;
+    int channelCount = 0;
+    int hop = 0;                        // Przesunięcie okien na wyjściu (połowa okna)
+    int tolerance = 0;                  // Zakres szukania dopasowania (± ramki)
+    int capacity = 0;                   // Pojemność bufora wejścia w ramkach
+
+    std::vector<float> window;          // Okno Hanna (2 × hop)
+    std::vector<float> input;           // Wejście przeplecione
+    std::vector<float> mono;            // Wejście zmiksowane do mono (do korelacji)
+    std::vector<float> overlap;         // Druga połowa poprzedniego okna (już z oknem)
+    int filled = 0;                     // Ramki w buforze wejścia
+
+    std::atomic<double> targetSpeed{1.0};
+    double analysisPos = 0.0;           // Idealny początek następnego okna w wejściu
+    int templateStart = -1;             // Naturalna kontynuacja poprzedniego okna (-1 = brak)
+};
@@ -0,0 +1,256 @@
+#include "tracing.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QDebug>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Pojemność bufora jednego wątku (przy przepełnieniu nadpisywane są najstarsze zdarzenia)
+constexpr int kEventsPerThread = 1 << 15;
+// Bufory zakończonych wątków (np. jednorazowych wątków wczytywania) zachowywane do zapisu
+constexpr int kMaxFinishedThreads = 32;
+
+struct Event {
+    const char *name = nullptr;
+    char phase = 0;             // 'X' odcinek, 'C' licznik, 'i' chwila
+    qint64 startNs = 0;
+    qint64 durationNs = 0;
+    double value = 0;
+    QString info;
+};
+
+struct ThreadBuffer {
+    QMutex mutex;               // Wątek zapisujący vs eksport; poza eksportem bez rywalizacji
+    std::vector<Event> events;
+    size_t next = 0;
+    bool wrapped = false;
+    int tid = 0;
+    QString name;
+    std::atomic<bool> finished{false};
+};
+
+QMutex registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> registry;
+std::atomic<int> nextTid{1};
+
+// Bufor zostaje w rejestrze po zakończeniu wątku, żeby jego zdarzenia trafiły do zapisu
+struct ThreadHolder {
+    std::shared_ptr<ThreadBuffer> buffer;
+    ~ThreadHolder() {
+        if (buffer)
+            buffer->finished = true;
+    }
+};
+
+ThreadBuffer *currentBuffer()
+{
+    thread_local ThreadHolder holder;
+    if (!holder.buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.resize(kEventsPerThread);
+        buffer->tid = nextTid++;
+        QThread *thread = QThread::currentThread();
+        buffer->name = thread->objectName();
+        if (buffer->name.isEmpty()) {
+            buffer->name = QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()
+                               ? QStringLiteral("GUI") : QString("thread-%1").arg(buffer->tid);
+        }
+
+        QMutexLocker locker(&registryMutex);
+        int finishedCount = 0;
+        for (const auto &b : registry)
+            finishedCount += b->finished ? 1 : 0;
+        for (auto it = registry.begin(); it != registry.end() && finishedCount >= kMaxFinishedThreads;) {
+            if ((*it)->finished) {
+                it = registry.erase(it);
+                --finishedCount;
+            } else {
+                ++it;
+            }
+        }
+        registry.push_back(buffer);
+        holder.buffer = std::move(buffer);
+    }
+    return holder.buffer.get();
+}
+
+void record(Event &&event)
+{
+    ThreadBuffer *buffer = currentBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    buffer->events[buffer->next] = std::move(event);
+    if (++buffer->next == buffer->events.size()) {
+        buffer->next = 0;
+        buffer->wrapped = true;
+    }
+}
+
+}
+
+namespace Tracing {
+
+namespace detail {
+
+std::atomic<bool> enabled{false};
+
+qint64 nowNs()
+{
+    static const QElapsedTimer clock = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+void recordComplete(const char *name, qint64 startNs, qint64 durationNs, const QString &info)
+{
+    Event event;
+    event.name = name;
+    event.phase = 'X';
+    event.startNs = startNs;
+    event.durationNs = durationNs;
+    event.info = info;
+    record(std::move(event));
+}
+
+void recordCounter(const char *name, double value)
+{
+    Event event;
+    event.name = name;
+    event.phase = 'C';
+    event.startNs = nowNs();
+    event.value = value;
+    record(std::move(event));
+}
+
+void recordInstant(const char *name, const QString &info)
+{
+    Event event;
+    event.name = name;
+    event.phase = 'i';
+    event.startNs = nowNs();
+    event.info = info;
+    record(std::move(event));
+}
+
+}
+
+void setEnabled(bool enable)
+{
+    if (enable == isEnabled())
+        return;
+    if (enable) {
+        QMutexLocker locker(&registryMutex);
+        for (auto it = registry.begin(); it != registry.end();) {
+            if ((*it)->finished) {
+                it = registry.erase(it);
+                continue;
+            }
+            QMutexLocker bufferLocker(&(*it)->mutex);
+            (*it)->next = 0;
+            (*it)->wrapped = false;
+            ++it;
+        }
+    }
+    detail::nowNs();            // Początek osi czasu przed pierwszym zdarzeniem
+    detail::enabled = enable;
+    qDebug().noquote() << QString("[trace] enabled=%1").arg(enable ? 1 : 0);
+}
+
+bool statsLoggingEnabled()
+{
+    static const bool requested = qEnvironmentVariableIsSet("LIBRARY_STATS");
+    return requested || isEnabled();
+}
+
+void setThreadName(const QString &name)
+{
+    ThreadBuffer *buffer = currentBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    buffer->name = name;
+}
+
+bool exportChromeTrace(const QString &fileName)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        QMutexLocker locker(&registryMutex);
+        buffers = registry;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+    traceEvents.append(QJsonObject{
+        { "ph", "M" }, { "name", "process_name" }, { "pid", pid },
+        { "args", QJsonObject{ { "name", QCoreApplication::applicationName() } } }
+    });
+
+    int eventCount = 0;
+    for (const auto &buffer : buffers) {
+        // Kopia pod blokadą, żeby wątek mógł dalej zapisywać podczas budowy JSON
+        std::vector<Event> events;
+        QString threadName;
+        {
+            QMutexLocker locker(&buffer->mutex);
+            threadName = buffer->name;
+            if (buffer->wrapped)
+                events.insert(events.end(), buffer->events.begin() + buffer->next, buffer->events.end());
+            events.insert(events.end(), buffer->events.begin(), buffer->events.begin() + buffer->next);
+        }
+        if (events.empty())
+            continue;
+
+        traceEvents.append(QJsonObject{
+            { "ph", "M" }, { "name", "thread_name" }, { "pid", pid }, { "tid", buffer->tid },
+            { "args", QJsonObject{ { "name", threadName } } }
+        });
+        for (const Event &event : events) {
+            QJsonObject object{
+                { "name", QString::fromLatin1(event.name) },
+                { "ph", QString(QChar(event.phase)) },
+                { "ts", event.startNs / 1000.0 },
+                { "pid", pid },
+                { "tid", buffer->tid }
+            };
+            if (event.phase == 'X')
+                object.insert("dur", event.durationNs / 1000.0);
+            else if (event.phase == 'i')
+                object.insert("s", "t");
+            if (event.phase == 'C')
+                object.insert("args", QJsonObject{ { "value", event.value } });
+            else if (!event.info.isEmpty())
+                object.insert("args", QJsonObject{ { "info", event.info } });
+            traceEvents.append(object);
+            ++eventCount;
+        }
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Tracing: cannot write" << fileName;
+        return false;
+    }
+    file.write(QJsonDocument(QJsonObject{
+        { "traceEvents", traceEvents },
+        { "displayTimeUnit", "ms" }
+    }).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qDebug() << "Tracing: cannot write" << fileName;
+        return false;
+    }
+    qDebug().noquote() << QString("[trace] file=\"%1\" events=%2 threads=%3")
+                              .arg(fileName).arg(eventCount).arg(buffers.size());
+    return true;
+}
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QString>
+#include <atomic>
+
+// Śledzenie działania aplikacji (tracing) do diagnozy przycięć.
+// Zdarzenia — odcinki czasu (TRACE_SCOPE), liczniki (TRACE_COUNTER) i chwile (TRACE_INSTANT) —
+// trafiają do bufora pierścieniowego wątku, który je zgłosił (najstarsze są nadpisywane),
+// bez wspólnej blokady między wątkami. Gdy śledzenie jest wyłączone, każde makro to jeden
+// odczyt flagi atomowej. Nazwy zdarzeń muszą być stałymi napisami (przechowywany jest wskaźnik).
+// Zapis w formacie Chrome trace-event (JSON) do obejrzenia w Perfetto (ui.perfetto.dev)
+// albo chrome://tracing.
+namespace Tracing {
+
+namespace detail {
+extern std::atomic<bool> enabled;
+qint64 nowNs();
+void recordComplete(const char *name, qint64 startNs, qint64 durationNs, const QString &info);
+void recordCounter(const char *name, double value);
+void recordInstant(const char *name, const QString &info);
+}
+
+inline bool isEnabled() { return detail::enabled.load(std::memory_order_relaxed); }
+
+// Włączenie czyści bufory, wyłączenie zostawia zebrane zdarzenia do zapisu
+void setEnabled(bool enable);
+
+// Zapis zebranych zdarzeń wszystkich wątków; false, gdy pliku nie da się zapisać
+bool exportChromeTrace(const QString &fileName);
+
+// Czy harmonogramy (UI, zadania) mają co jakiś czas logować statystyki: w trakcie śledzenia
+// albo przy ustawionej zmiennej środowiska LIBRARY_STATS. Bez tego ich zegary statystyk
+// nie działają, żeby nie budzić bezczynnej aplikacji.
+bool statsLoggingEnabled();
+
+// Nazwa wątku w śladzie (domyślnie objectName bieżącego QThread albo „thread-N”)
+void setThreadName(const QString &name);
+
+// Odcinek od utworzenia do końca zakresu; info to dodatkowy opis (np. nazwa pliku)
+class Span {
+public:
+    explicit Span(const char *name, const QString &info = QString())
+        : name(isEnabled() ? name : nullptr) {
+        if (this->name) {
+            this->info = info;
+            startNs = detail::nowNs();
+        }
+    }
+    ~Span() {
+        if (name)
+            detail::recordComplete(name, startNs, detail::nowNs() - startNs, info);
+    }
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+private:
+    const char *name;
+    qint64 startNs = 0;
+    QString info;
+};
+
+inline void counter(const char *name, double value) {
+    if (isEnabled())
+        detail::recordCounter(name, value);
+}
+
+inline void instant(const char *name, const QString &info = QString()) {
+    if (isEnabled())
+        detail::recordInstant(name, info);
+}
+
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+// Argument info jest obliczany tylko przy włączonym śledzeniu
+#define TRACE_SCOPE(name) Tracing::Span TRACE_CONCAT(traceSpan_, __LINE__)(name)
+#define TRACE_SCOPE_INFO(name, info) \
+    Tracing::Span TRACE_CONCAT(traceSpan_, __LINE__)(name, Tracing::isEnabled() ? QString(info) : QString())
+#define TRACE_COUNTER(name, value) Tracing::counter(name, value)
+#define TRACE_INSTANT(name, info) \
+    do { if (Tracing::isEnabled()) Tracing::detail::recordInstant(name, info); } while (0)
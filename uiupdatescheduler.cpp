@@ -0,0 +1,206 @@
+#include "uiupdatescheduler.h"
+#include "cacheutils.h"             // Czas procesora procesu
+#include "tracing.h"
+#include <QGuiApplication>
+#include <QApplication>
+#include <QScreen>
+#include <QThread>
+#include <QEvent>
+#include <QMutexLocker>
+#include <QDebug>
+
+namespace {
+// Co tyle do logu trafia podsumowanie (liczba aktualizacji i czas procesora)
+constexpr int kStatsIntervalMs = 10000;
+}
+
+UiUpdateScheduler &UiUpdateScheduler::instance()
+{
+    // Rodzicem jest aplikacja, więc zegary znikają przed nią (pierwsze użycie w wątku GUI)
+    static UiUpdateScheduler *scheduler = [] {
+        auto *created = new UiUpdateScheduler();
+        created->setParent(qApp);
+        return created;
+    }();
+    return *scheduler;
+}
+
+UiUpdateScheduler::UiUpdateScheduler()
+{
+    clock.start();
+
+    frameTimer = new QTimer(this);
+    frameTimer->setSingleShot(true);
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(frameTimer, &QTimer::timeout, this, &UiUpdateScheduler::runFrame);
+
+    statsTimer = new QTimer(this);
+    statsTimer->setTimerType(Qt::VeryCoarseTimer);
+    connect(statsTimer, &QTimer::timeout, this, &UiUpdateScheduler::logStats);
+    updateStatsLogging();
+}
+
+void UiUpdateScheduler::updateStatsLogging()
+{
+    const bool wanted = Tracing::statsLoggingEnabled();
+    if (wanted == statsTimer->isActive())
+        return;
+    if (!wanted) {
+        statsTimer->stop();
+        return;
+    }
+
+    // Pomiar od zera — liczniki sprzed włączenia nie mają odniesienia w czasie
+    {
+        QMutexLocker locker(&mutex);
+        marks = 0;
+    }
+    updates = hiddenSkips = frames = 0;
+    statsStartCpuMs = CacheUtils::processCpuTimeMs();
+    statsStartMs = clock.elapsed();
+    statsTimer->start(kStatsIntervalMs);
+}
+
+int UiUpdateScheduler::add(QWidget *widget, std::function<void()> update, int minIntervalMs)
+{
+    const int id = int(clients.size());
+    Client client;
+    client.widget = widget;
+    client.update = std::move(update);
+    client.minIntervalMs = minIntervalMs;
+    clients.push_back(std::move(client));
+
+    if (!clientsByWidget.contains(widget)) {
+        widget->installEventFilter(this);
+        connect(widget, &QObject::destroyed, this, [this](QObject *object) {
+            for (int clientId : clientsByWidget.values(object))
+                clients[clientId].update = nullptr;
+            clientsByWidget.remove(object);
+        });
+    }
+    clientsByWidget.insert(widget, id);
+    return id;
+}
+
+void UiUpdateScheduler::markDirty(int id)
+{
+    {
+        QMutexLocker locker(&mutex);
+        ++marks;
+        pending.insert(id);
+        if (armed)
+            return;
+        armed = true;
+    }
+    if (QThread::currentThread() == thread())
+        arm();
+    else
+        QMetaObject::invokeMethod(this, [this]() { arm(); }, Qt::QueuedConnection);
+}
+
+void UiUpdateScheduler::setIdleRate(int fps)
+{
+    idleFps = qMax(1, fps);
+}
+
+int UiUpdateScheduler::frameIntervalMs() const
+{
+    // Aplikacja w tle albo okno zminimalizowane — niższe tempo
+    const QWidget *window = QApplication::activeWindow();
+    if (QGuiApplication::applicationState() != Qt::ApplicationActive || (window && window->isMinimized()))
+        return 1000 / idleFps;
+
+    const QScreen *screen = QGuiApplication::primaryScreen();
+    const qreal refreshRate = screen ? screen->refreshRate() : 60.0;
+    return qMax(1, qRound(1000.0 / qMax<qreal>(1.0, refreshRate)));
+}
+
+void UiUpdateScheduler::arm()
+{
+    if (frameTimer->isActive())
+        return;
+    // Rytm klatek: najbliższa klatka liczona od poprzedniej, a po przerwie — od razu
+    const qint64 now = clock.elapsed();
+    const qint64 next = lastFrameMs < 0 ? now : lastFrameMs + frameIntervalMs();
+    frameTimer->start(int(qMax<qint64>(0, next - now)));
+}
+
+void UiUpdateScheduler::runFrame()
+{
+    TRACE_SCOPE("ui.frame");
+    QSet<int> dirty;
+    {
+        QMutexLocker locker(&mutex);
+        dirty.swap(pending);
+        armed = false;
+    }
+    lastFrameMs = clock.elapsed();
+    ++frames;
+    TRACE_COUNTER("ui.dirty_clients", dirty.size());
+
+    QList<int> notYet;
+    qint64 waitMs = 0;
+    for (int id : std::as_const(dirty)) {
+        Client &client = clients[id];
+        if (!client.update || !client.widget)
+            continue;
+        // Niewidoczny: bez aktualizacji, zaległość wykona pokazanie widżetu
+        if (!client.widget->isVisible()) {
+            client.deferred = true;
+            ++hiddenSkips;
+            continue;
+        }
+        if (client.minIntervalMs > 0 && client.lastUpdate.isValid()
+            && client.lastUpdate.elapsed() < client.minIntervalMs) {
+            const qint64 remaining = client.minIntervalMs - client.lastUpdate.elapsed();
+            waitMs = notYet.isEmpty() ? remaining : qMin(waitMs, remaining);
+            notYet.append(id);
+            continue;
+        }
+        client.deferred = false;
+        client.lastUpdate.start();
+        client.update();
+        ++updates;
+    }
+
+    // Odbiorcy z ograniczonym tempem czekają, aż minie ich odstęp
+    if (notYet.isEmpty())
+        return;
+    QMutexLocker locker(&mutex);
+    for (int id : std::as_const(notYet))
+        pending.insert(id);
+    if (!armed) {
+        armed = true;
+        frameTimer->start(int(qMax<qint64>(waitMs, frameIntervalMs())));
+    }
+}
+
+bool UiUpdateScheduler::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Show) {
+        for (int id : clientsByWidget.values(watched)) {
+            if (clients[id].deferred)
+                markDirty(id);
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void UiUpdateScheduler::logStats()
+{
+    const qint64 cpuMs = CacheUtils::processCpuTimeMs();
+    const qint64 nowMs = clock.elapsed();
+    const double seconds = qMax<qint64>(1, nowMs - statsStartMs) / 1000.0;
+    quint64 marked;
+    {
+        QMutexLocker locker(&mutex);
+        marked = marks;
+        marks = 0;
+    }
+    qDebug().noquote() << QString("[ui-scheduler] marks=%1 updates=%2 hidden_skips=%3 frames=%4 cpu_ms_per_s=%5")
+                              .arg(marked).arg(updates).arg(hiddenSkips).arg(frames)
+                              .arg((cpuMs - statsStartCpuMs) / seconds, 0, 'f', 1);
+    updates = hiddenSkips = frames = 0;
+    statsStartCpuMs = cpuMs;
+    statsStartMs = nowMs;
+}
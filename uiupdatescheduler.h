@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSet>
+#include <QMultiHash>
+#include <functional>
+#include <vector>
+
+// Wspólny harmonogram odświeżania interfejsu.
+// Komponenty nie aktualizują widżetów przy każdym zdarzeniu (pozycja odtwarzacza, krok
+// przesuwania obrazu, bufor dźwięku), tylko oznaczają stan jako zmieniony — markDirty().
+// Raz na klatkę ekranu (albo rzadziej, gdy aplikacja jest nieaktywna lub okno zminimalizowane)
+// każdy oznaczony odbiorca dostaje jedno wywołanie aktualizacji, niezależnie od liczby oznaczeń.
+// Odbiorcy niewidoczni (np. strony MainWindow::stack inne niż bieżąca) nie dostają żadnych
+// aktualizacji; zaległa jest wykonywana przy pokazaniu widżetu. Bez oznaczeń zegar nie działa.
+// Rejestracja i wywołania w wątku GUI; markDirty() bezpieczne z dowolnego wątku.
+class UiUpdateScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    static UiUpdateScheduler &instance();
+
+    // Odbiorca związany z widżetem (o jego widoczności decyduje isVisible()).
+    // minIntervalMs > 0 ogranicza tempo poniżej odświeżania ekranu. Zwraca identyfikator
+    // do markDirty(); odbiorca znika razem z widżetem.
+    int add(QWidget *widget, std::function<void()> update, int minIntervalMs = 0);
+
+    // Zmiana stanu — kolejne oznaczenia przed najbliższą klatką łączą się w jedną aktualizację
+    void markDirty(int id);
+
+    // Tempo odświeżania, gdy aplikacja jest nieaktywna albo okno zminimalizowane
+    void setIdleRate(int fps);
+
+    // Włączenie / wyłączenie okresowego wpisu [ui-scheduler] według Tracing::statsLoggingEnabled()
+    // (wywoływane po przełączeniu śledzenia)
+    void updateStatsLogging();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    UiUpdateScheduler();
+
+    void arm();                 // Zaplanowanie najbliższej klatki (wątek GUI)
+    void runFrame();
+    int frameIntervalMs() const;
+    void logStats();
+
+    struct Client {
+        QPointer<QWidget> widget;
+        std::function<void()> update;
+        int minIntervalMs = 0;
+        QElapsedTimer lastUpdate;
+        bool deferred = false;          // Oznaczony, gdy był niewidoczny
+    };
+    std::vector<Client> clients;
+    QMultiHash<QObject *, int> clientsByWidget;
+
+    QMutex mutex;                       // Chroni pending i armed (markDirty z innych wątków)
+    QSet<int> pending;
+    bool armed = false;
+
+    QTimer *frameTimer;
+    QElapsedTimer clock;
+    qint64 lastFrameMs = -1;
+    int idleFps = 10;
+
+    // Statystyki (co kStatsIntervalMs do logu, razem z czasem procesora procesu;
+    // tylko w trakcie śledzenia albo z LIBRARY_STATS)
+    QTimer *statsTimer;
+    quint64 marks = 0;
+    quint64 updates = 0;
+    quint64 hiddenSkips = 0;
+    quint64 frames = 0;
+    qint64 statsStartCpuMs = 0;
+    qint64 statsStartMs = 0;
+};
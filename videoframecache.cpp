@@ -0,0 +1,80 @@
+#include "videoframecache.h"
+#include <QVideoFrameFormat>
+#include <algorithm>
+
+namespace {
+bool startsBefore(const QVideoFrame &frame, qint64 startUs)
+{
+    return frame.startTime() < startUs;
+}
+}
+
+VideoFrameCache::VideoFrameCache(int frameLimit, qint64 byteLimit)
+    : maxFrames(qMax(2, frameLimit)),
+      maxBytes(byteLimit)
+{ }
+
+qint64 VideoFrameCache::estimateBytes(const QVideoFrame &frame)
+{
+    // Bez mapowania bufora: rozmiar z wymiarów i rodzaju formatu pikseli
+    const qint64 pixels = qint64(frame.width()) * frame.height();
+    switch (frame.pixelFormat()) {
+    case QVideoFrameFormat::Format_YUV420P:
+    case QVideoFrameFormat::Format_YV12:
+    case QVideoFrameFormat::Format_NV12:
+    case QVideoFrameFormat::Format_NV21:
+        return pixels * 3 / 2;
+    case QVideoFrameFormat::Format_YUV420P10:
+    case QVideoFrameFormat::Format_P010:
+    case QVideoFrameFormat::Format_P016:
+        return pixels * 3;
+    default:
+        return pixels * 4;
+    }
+}
+
+void VideoFrameCache::insert(const QVideoFrame &frame)
+{
+    const qint64 startUs = frame.startTime();
+    if (!frame.isValid() || startUs < 0)
+        return;
+
+    auto it = std::lower_bound(frames.begin(), frames.end(), startUs, startsBefore);
+    if (it != frames.end() && it->startTime() == startUs)
+        return;
+    frames.insert(it, frame);
+    bytes += estimateBytes(frame);
+
+    // Usuwanie z tej strony, która jest dalej od nowej klatki
+    while (frames.size() > 2 && (frames.size() > maxFrames || bytes > maxBytes)) {
+        const bool dropFirst = startUs - frames.first().startTime() > frames.last().startTime() - startUs;
+        bytes -= estimateBytes(dropFirst ? frames.first() : frames.last());
+        if (dropFirst)
+            frames.removeFirst();
+        else
+            frames.removeLast();
+    }
+}
+
+QVideoFrame VideoFrameCache::frameBefore(qint64 startUs, qint64 maxGapUs) const
+{
+    auto it = std::lower_bound(frames.begin(), frames.end(), startUs, startsBefore);
+    if (it == frames.begin())
+        return QVideoFrame();
+    --it;
+    return startUs - it->startTime() <= maxGapUs ? *it : QVideoFrame();
+}
+
+QVideoFrame VideoFrameCache::frameAfter(qint64 startUs, qint64 maxGapUs) const
+{
+    auto it = std::lower_bound(frames.begin(), frames.end(), startUs + 1, startsBefore);
+    if (it == frames.end())
+        return QVideoFrame();
+    return it->startTime() - startUs <= maxGapUs ? *it : QVideoFrame();
+}
+
+void VideoFrameCache::clear()
+{
+    frames.clear();
+    bytes = 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QVideoFrame>
+#include <QVector>
+
+// Pamięć ostatnio zdekodowanych klatek wokół bieżącej pozycji (do krokowania klatka po klatce).
+// Klatki są trzymane jako QVideoFrame (bez kopiowania — tylko referencja do bufora dekodera),
+// posortowane po znaczniku czasu. Po przekroczeniu limitu liczby klatek lub pamięci usuwana jest
+// klatka najdalsza od ostatnio dodanej, więc zostaje ciągły fragment wokół miejsca odtwarzania.
+class VideoFrameCache {
+public:
+    explicit VideoFrameCache(int maxFrames = 48, qint64 maxBytes = 192 * 1024 * 1024);
+
+    // Klatka z poprawnym znacznikiem czasu (ta sama klatka dodana ponownie jest pomijana)
+    void insert(const QVideoFrame &frame);
+
+    // Klatka bezpośrednio przed / po klatce o podanym starcie (µs); pusta, gdy jej nie ma
+    // albo gdy najbliższa zapamiętana jest dalej niż o maxGapUs (fragment nie jest ciągły)
+    QVideoFrame frameBefore(qint64 startUs, qint64 maxGapUs) const;
+    QVideoFrame frameAfter(qint64 startUs, qint64 maxGapUs) const;
+
+    void clear();
+    int size() const { return int(frames.size()); }
+    qint64 memoryUsage() const { return bytes; }
+
+private:
+    static qint64 estimateBytes(const QVideoFrame &frame);
+
+    int maxFrames;
+    qint64 maxBytes;
+    QVector<QVideoFrame> frames;    // Rosnąco po startTime()
+    qint64 bytes = 0;
+};